@@ -0,0 +1,642 @@
+﻿#pragma once
+
+#include "stdafx.h"
+#ifndef BCEXPR_H
+#define BCEXPR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "BCsimd.h"
+
+template <typename T>
+class BCarray;
+class BCmatrix;
+
+/**
+ * BCarray / BCmatrix 的表达式模板。
+ *
+ * 四则运算不再立即生成结果，而是构造一棵轻量的表达式树，直到赋值给 BCarray / BCmatrix
+ * 时才在一次遍历中逐元素求值，因此 (m - mean) / sd * 2 只分配一次结果、只扫描一遍数据。
+ * 当某个操作数本身是临时对象（右值）时，直接在它的存储上原地求值并返回它，不再额外分配。
+ *
+ * 注意：表达式只引用操作数而不拷贝，请不要用 auto 保存表达式，应直接赋给 BCarray / BCmatrix。
+ */
+namespace BCexpr
+{
+	// 逐元素运算
+	struct Add
+	{
+		template <typename A, typename B>
+		static auto apply(const A& a, const B& b) -> decltype(a + b) { return a + b; }
+	};
+
+	struct Sub
+	{
+		template <typename A, typename B>
+		static auto apply(const A& a, const B& b) -> decltype(a - b) { return a - b; }
+	};
+
+	struct Mul
+	{
+		template <typename A, typename B>
+		static auto apply(const A& a, const B& b) -> decltype(a * b) { return a * b; }
+	};
+
+	struct Div
+	{
+		template <typename A, typename B>
+		static auto apply(const A& a, const B& b) -> decltype(a / b) { return a / b; }
+	};
+
+	struct Neg
+	{
+		template <typename A>
+		static auto apply(const A& a) -> decltype(-a) { return -a; }
+	};
+
+	// CRTP 基类
+	template <typename E>
+	struct ArrayExpr
+	{
+		const E& self() const { return static_cast<const E&>(*this); }
+	};
+
+	template <typename E>
+	struct MatrixExpr
+	{
+		const E& self() const { return static_cast<const E&>(*this); }
+	};
+
+	/* 类型判断 */
+
+	template <typename T>
+	struct isBCarray : std::false_type {};
+	template <typename T>
+	struct isBCarray<BCarray<T>> : std::true_type {};
+
+	template <typename T>
+	using Decay = typename std::decay<T>::type;
+
+	template <typename T>
+	struct isArrayExpr : std::is_base_of<ArrayExpr<Decay<T>>, Decay<T>> {};
+
+	template <typename T>
+	struct isMatrixExpr : std::is_base_of<MatrixExpr<Decay<T>>, Decay<T>> {};
+
+	template <typename T>
+	struct isArrayLike : std::integral_constant<bool, isBCarray<Decay<T>>::value || isArrayExpr<T>::value> {};
+
+	template <typename T>
+	struct isMatrixLike : std::integral_constant<bool, std::is_same<Decay<T>, BCmatrix>::value || isMatrixExpr<T>::value> {};
+
+	template <typename T>
+	struct isScalar : std::is_arithmetic<Decay<T>> {};
+
+	template <typename T>
+	struct isOperand : std::integral_constant<bool, isArrayLike<T>::value || isMatrixLike<T>::value || isScalar<T>::value> {};
+
+	// 至少有一个操作数是向量或矩阵，另一个是向量、矩阵或标量
+	template <typename L, typename R>
+	struct isOperation : std::integral_constant<bool,
+		isOperand<L>::value && isOperand<R>::value &&
+		(isArrayLike<L>::value || isArrayLike<R>::value || isMatrixLike<L>::value || isMatrixLike<R>::value)> {};
+
+	// 临时 BCarray / BCmatrix，可以直接复用它的存储
+	template <typename T>
+	struct isTemporaryArray : std::integral_constant<bool, isBCarray<Decay<T>>::value && !std::is_lvalue_reference<T>::value> {};
+
+	template <typename T>
+	struct isTemporaryMatrix : std::integral_constant<bool, std::is_same<Decay<T>, BCmatrix>::value && !std::is_lvalue_reference<T>::value> {};
+
+	/* ---------- 向量表达式 ---------- */
+
+	// 叶子：引用一个已有的 BCarray
+	template <typename T>
+	struct ArrayLeaf : ArrayExpr<ArrayLeaf<T>>
+	{
+		const T* ptr;
+		size_t n;
+		bool rowVector;
+
+		explicit ArrayLeaf(const BCarray<T>& a) : ptr(a.data()), n(a.size()), rowVector(a.isRowVector()) {}
+
+		size_t size() const { return n; }
+		bool isRowVector() const { return rowVector; }
+		const T& operator[](size_t i) const { return ptr[i]; }
+	};
+
+	// 叶子：标量
+	template <typename T>
+	struct ScalarLeaf : ArrayExpr<ScalarLeaf<T>>
+	{
+		T v;
+
+		explicit ScalarLeaf(const T& v) : v(v) {}
+
+		const T& operator[](size_t) const { return v; }
+	};
+
+	template <typename T>
+	struct isScalarLeaf : std::false_type {};
+	template <typename T>
+	struct isScalarLeaf<ScalarLeaf<T>> : std::true_type {};
+
+	template <typename Op, typename L, typename R>
+	struct BinaryArray : ArrayExpr<BinaryArray<Op, L, R>>
+	{
+		L l;
+		R r;
+
+		BinaryArray(const L& l, const R& r) : l(l), r(r)
+		{
+			if (!isScalarLeaf<L>::value && !isScalarLeaf<R>::value && size() != sizeOf(r))
+			{
+				throw std::invalid_argument("Vector sizes do not match.");
+			}
+		}
+
+		size_t size() const
+		{
+			return isScalarLeaf<L>::value ? sizeOf(r) : sizeOf(l);
+		}
+
+		bool isRowVector() const
+		{
+			return isScalarLeaf<L>::value ? rowVectorOf(r) : rowVectorOf(l);
+		}
+
+		auto operator[](size_t i) const -> decltype(Op::apply(l[i], r[i]))
+		{
+			return Op::apply(l[i], r[i]);
+		}
+
+	private:
+		template <typename E>
+		static size_t sizeOf(const E& e) { return e.size(); }
+		template <typename T>
+		static size_t sizeOf(const ScalarLeaf<T>&) { return 0; }
+		template <typename E>
+		static bool rowVectorOf(const E& e) { return e.isRowVector(); }
+		template <typename T>
+		static bool rowVectorOf(const ScalarLeaf<T>&) { return true; }
+	};
+
+	template <typename Op, typename E>
+	struct UnaryArray : ArrayExpr<UnaryArray<Op, E>>
+	{
+		E e;
+
+		explicit UnaryArray(const E& e) : e(e) {}
+
+		size_t size() const { return e.size(); }
+		bool isRowVector() const { return e.isRowVector(); }
+		auto operator[](size_t i) const -> decltype(Op::apply(e[i])) { return Op::apply(e[i]); }
+	};
+
+	// 把操作数统一成向量表达式节点
+	template <typename T>
+	ArrayLeaf<T> toArrayExpr(const BCarray<T>& a) { return ArrayLeaf<T>(a); }
+
+	template <typename E>
+	const E& toArrayExpr(const ArrayExpr<E>& e) { return e.self(); }
+
+	template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	ScalarLeaf<T> toArrayExpr(const T& v) { return ScalarLeaf<T>(v); }
+
+	template <typename T>
+	using ArrayNode = Decay<decltype(toArrayExpr(std::declval<const Decay<T>&>()))>;
+
+	template <typename Op, typename L, typename R>
+	using ArrayResult = Decay<decltype(std::declval<BinaryArray<Op, ArrayNode<L>, ArrayNode<R>>>()[0])>;
+
+	template <typename T>
+	struct ValueType { using type = T; };
+	template <typename T>
+	struct ValueType<BCarray<T>> { using type = T; };
+
+	// 单个运算对应的 SIMD 内核（见 BCsimd.h）
+	template <typename Op>
+	struct SimdKernel;
+
+	template <>
+	struct SimdKernel<Add>
+	{
+		static void arrays(const double* a, const double* b, double* out, size_t n) { BCsimd::add(a, b, out, n); }
+		static void arrayScalar(const double* a, double s, double* out, size_t n) { BCsimd::addScalar(a, s, out, n); }
+		static void scalarArray(double s, const double* a, double* out, size_t n) { BCsimd::addScalar(a, s, out, n); }
+	};
+
+	template <>
+	struct SimdKernel<Sub>
+	{
+		static void arrays(const double* a, const double* b, double* out, size_t n) { BCsimd::sub(a, b, out, n); }
+		static void arrayScalar(const double* a, double s, double* out, size_t n) { BCsimd::subScalar(a, s, out, n); }
+		static void scalarArray(double s, const double* a, double* out, size_t n) { BCsimd::scalarSub(s, a, out, n); }
+	};
+
+	template <>
+	struct SimdKernel<Mul>
+	{
+		static void arrays(const double* a, const double* b, double* out, size_t n) { BCsimd::mul(a, b, out, n); }
+		static void arrayScalar(const double* a, double s, double* out, size_t n) { BCsimd::mulScalar(a, s, out, n); }
+		static void scalarArray(double s, const double* a, double* out, size_t n) { BCsimd::mulScalar(a, s, out, n); }
+	};
+
+	template <>
+	struct SimdKernel<Div>
+	{
+		static void arrays(const double* a, const double* b, double* out, size_t n) { BCsimd::div(a, b, out, n); }
+		static void arrayScalar(const double* a, double s, double* out, size_t n) { BCsimd::divScalar(a, s, out, n); }
+		static void scalarArray(double s, const double* a, double* out, size_t n) { BCsimd::scalarDiv(s, a, out, n); }
+	};
+
+	// 标量与 double 运算的结果仍是 double 时（整数、float、double 标量）才能交给内核
+	template <typename Op, typename S>
+	struct isSimdScalar : std::integral_constant<bool,
+		std::is_same<decltype(Op::apply(std::declval<double>(), std::declval<S>())), double>::value> {};
+
+	// 只有一个运算、操作数都是连续 double 时走 SIMD 内核，返回 true；
+	// 更深的表达式树由 evaluateInto 的融合循环求值（同样只扫描一遍，由编译器自动向量化）
+	template <typename E>
+	bool simdEvaluate(double*, const E&, size_t) { return false; }
+
+	template <typename Op>
+	bool simdEvaluate(double* out, const BinaryArray<Op, ArrayLeaf<double>, ArrayLeaf<double>>& e, size_t n)
+	{
+		SimdKernel<Op>::arrays(e.l.ptr, e.r.ptr, out, n);
+		return true;
+	}
+
+	template <typename Op, typename S>
+	bool simdEvaluate(double* out, const BinaryArray<Op, ArrayLeaf<double>, ScalarLeaf<S>>& e, size_t n)
+	{
+		if constexpr (isSimdScalar<Op, S>::value)
+		{
+			SimdKernel<Op>::arrayScalar(e.l.ptr, static_cast<double>(e.r.v), out, n);
+			return true;
+		}
+		return false;
+	}
+
+	template <typename Op, typename S>
+	bool simdEvaluate(double* out, const BinaryArray<Op, ScalarLeaf<S>, ArrayLeaf<double>>& e, size_t n)
+	{
+		if constexpr (isSimdScalar<Op, S>::value)
+		{
+			SimdKernel<Op>::scalarArray(static_cast<double>(e.l.v), e.r.ptr, out, n);
+			return true;
+		}
+		return false;
+	}
+
+	inline bool simdEvaluate(double* out, const UnaryArray<Neg, ArrayLeaf<double>>& e, size_t n)
+	{
+		BCsimd::neg(e.e.ptr, out, n);
+		return true;
+	}
+
+	// 把表达式逐元素写回 out，要求长度一致；只读写同一下标，所以 out 出现在表达式里也安全
+	template <typename T, typename E>
+	void evaluateInto(BCarray<T>& out, const E& e)
+	{
+		T* dst = out.data();
+		const size_t n = out.size();
+		if constexpr (std::is_same<T, double>::value)
+		{
+			if (simdEvaluate(dst, e, n))
+			{
+				return;
+			}
+		}
+		for (size_t i = 0; i < n; ++i)
+		{
+			dst[i] = static_cast<T>(e[i]);
+		}
+	}
+
+	template <typename Op, typename L, typename R>
+	auto arrayBinary(L&& l, R&& r)
+	{
+		using DL = Decay<L>;
+		using DR = Decay<R>;
+		if constexpr (isTemporaryArray<L&&>::value
+			&& std::is_same<ArrayResult<Op, DL, DR>, typename ValueType<DL>::type>::value)
+		{
+			// 左操作数是临时对象：原地求值
+			DL out(std::move(l));
+			evaluateInto(out, BinaryArray<Op, ArrayNode<DL>, ArrayNode<DR>>(toArrayExpr(out), toArrayExpr(r)));
+			return out;
+		}
+		else if constexpr (isTemporaryArray<R&&>::value
+			&& std::is_same<ArrayResult<Op, DL, DR>, typename ValueType<DR>::type>::value)
+		{
+			// 右操作数是临时对象：原地求值，结果保持左操作数的行/列方向
+			DR out(std::move(r));
+			BinaryArray<Op, ArrayNode<DL>, ArrayNode<DR>> e(toArrayExpr(l), toArrayExpr(out));
+			bool rowVector = e.isRowVector();
+			evaluateInto(out, e);
+			out.setRowVector(rowVector);
+			return out;
+		}
+		else
+		{
+			return BinaryArray<Op, ArrayNode<DL>, ArrayNode<DR>>(toArrayExpr(l), toArrayExpr(r));
+		}
+	}
+
+	/* ---------- 矩阵表达式 ---------- */
+	// 矩阵表达式按行求值：row(i) 返回一个只读的行访问器，内层循环是连续的下标访问，便于编译器向量化
+
+	template <typename M>
+	struct MatrixLeaf : MatrixExpr<MatrixLeaf<M>>
+	{
+		const M* src;
+
+		explicit MatrixLeaf(const M& m) : src(&m) {}
+
+		struct Row
+		{
+			const double* p;
+			double operator[](size_t j) const { return p[j]; }
+		};
+
+		size_t rows() const { return src->getRowCount(); }
+		size_t columns() const { return src->getColumnCount(); }
+		const M* source() const { return src; }
+		Row row(size_t i) const { return Row{ src->getValue()[i].data() }; }
+	};
+
+	// 标量在矩阵表达式中的叶子
+	struct MatrixScalar
+	{
+		double v;
+
+		struct Row
+		{
+			double v;
+			double operator[](size_t) const { return v; }
+		};
+
+		Row row(size_t) const { return Row{ v }; }
+	};
+
+	// 向量在矩阵表达式中的叶子：行向量按列广播，列向量按行广播（与原先的规则一致）
+	template <typename V>
+	struct MatrixVector
+	{
+		const V* ref; // 引用外部向量；为空时使用 own
+		V own;
+		bool perColumn = true;
+
+		struct Row
+		{
+			const double* p;
+			size_t step; // 按列广播时为 1，按行广播时为 0
+			double operator[](size_t j) const { return p[j * step]; }
+		};
+
+		explicit MatrixVector(const V& v) : ref(&v) {}
+		explicit MatrixVector(V&& v) : ref(nullptr), own(std::move(v)) {}
+		MatrixVector(const MatrixVector& other) : ref(other.ref), own(other.own), perColumn(other.perColumn) {}
+
+		const V& vec() const { return ref != nullptr ? *ref : own; }
+
+		void bind(size_t rows, size_t columns)
+		{
+			const V& v = vec();
+			if (v.isRowVector() && v.size() == columns)
+			{
+				perColumn = true;
+			}
+			else if (!v.isRowVector() && v.size() == rows)
+			{
+				perColumn = false;
+			}
+			else
+			{
+				throw std::invalid_argument("Vector size does not match matrix dimensions.");
+			}
+		}
+
+		Row row(size_t i) const
+		{
+			return perColumn ? Row{ vec().data(), 1 } : Row{ vec().data() + i, 0 };
+		}
+	};
+
+	template <typename T>
+	struct isMatrixVector : std::false_type {};
+	template <typename V>
+	struct isMatrixVector<MatrixVector<V>> : std::true_type {};
+
+	template <typename Op, typename L, typename R>
+	struct BinaryMatrix : MatrixExpr<BinaryMatrix<Op, L, R>>
+	{
+		L l;
+		R r;
+
+		BinaryMatrix(const L& l, const R& r) : l(l), r(r)
+		{
+			if constexpr (isMatrixExpr<L>::value && isMatrixExpr<R>::value)
+			{
+				if (l.rows() != r.rows() || l.columns() != r.columns())
+				{
+					throw std::invalid_argument("Matrix dimensions do not match.");
+				}
+			}
+			else if constexpr (isMatrixVector<R>::value)
+			{
+				this->r.bind(l.rows(), l.columns());
+			}
+			else if constexpr (isMatrixVector<L>::value)
+			{
+				this->l.bind(r.rows(), r.columns());
+			}
+		}
+
+		struct Row
+		{
+			typename L::Row l;
+			typename R::Row r;
+			double operator[](size_t j) const { return Op::apply(l[j], r[j]); }
+		};
+
+		size_t rows() const { return matrixSide().rows(); }
+		size_t columns() const { return matrixSide().columns(); }
+		auto source() const { return matrixSide().source(); }
+		Row row(size_t i) const { return Row{ l.row(i), r.row(i) }; }
+
+	private:
+		// 决定形状和行列名的一侧：优先取左操作数
+		const auto& matrixSide() const
+		{
+			if constexpr (isMatrixExpr<L>::value)
+				return l;
+			else
+				return r;
+		}
+	};
+
+	template <typename Op, typename E>
+	struct UnaryMatrix : MatrixExpr<UnaryMatrix<Op, E>>
+	{
+		E e;
+
+		explicit UnaryMatrix(const E& e) : e(e) {}
+
+		struct Row
+		{
+			typename E::Row e;
+			double operator[](size_t j) const { return Op::apply(e[j]); }
+		};
+
+		size_t rows() const { return e.rows(); }
+		size_t columns() const { return e.columns(); }
+		auto source() const { return e.source(); }
+		Row row(size_t i) const { return Row{ e.row(i) }; }
+	};
+
+	// 把操作数统一成矩阵表达式节点
+	template <typename M, typename = typename std::enable_if<std::is_same<M, BCmatrix>::value>::type>
+	MatrixLeaf<M> toMatrixExpr(const M& m) { return MatrixLeaf<M>(m); }
+
+	template <typename E>
+	const E& toMatrixExpr(const MatrixExpr<E>& e) { return e.self(); }
+
+	template <typename T, typename = typename std::enable_if<std::is_arithmetic<Decay<T>>::value>::type>
+	MatrixScalar toMatrixExpr(T&& v) { return MatrixScalar{ static_cast<double>(v) }; }
+
+	// 左值 BCarray<double> 直接引用；临时向量、其它元素类型或向量表达式先求值成 BCarray<double>
+	template <typename V, typename A = BCarray<double>>
+	MatrixVector<A> toMatrixExpr(V&& v, typename std::enable_if<isArrayLike<V>::value>::type* = nullptr)
+	{
+		if constexpr (std::is_same<Decay<V>, A>::value && std::is_lvalue_reference<V>::value)
+		{
+			return MatrixVector<A>(v);
+		}
+		else if constexpr (std::is_same<Decay<V>, A>::value)
+		{
+			return MatrixVector<A>(A(std::move(v)));
+		}
+		else
+		{
+			return MatrixVector<A>(A(toArrayExpr(v)));
+		}
+	}
+
+	template <typename T>
+	using MatrixNode = Decay<decltype(toMatrixExpr(std::declval<T>()))>;
+
+	template <typename Op, typename L, typename R>
+	auto matrixBinary(L&& l, R&& r)
+	{
+		using Node = BinaryMatrix<Op, MatrixNode<L&&>, MatrixNode<R&&>>;
+		if constexpr (isTemporaryMatrix<L&&>::value)
+		{
+			// 左操作数是临时矩阵：原地求值
+			Decay<L> out(std::move(l));
+			out = Node(toMatrixExpr(out), toMatrixExpr(std::forward<R>(r)));
+			return out;
+		}
+		else if constexpr (isTemporaryMatrix<R&&>::value)
+		{
+			Decay<R> out(std::move(r));
+			out = Node(toMatrixExpr(std::forward<L>(l)), toMatrixExpr(out));
+			return out;
+		}
+		else
+		{
+			return Node(toMatrixExpr(std::forward<L>(l)), toMatrixExpr(std::forward<R>(r)));
+		}
+	}
+
+	template <typename Op, typename L, typename R>
+	auto binary(L&& l, R&& r)
+	{
+		if constexpr (isMatrixLike<L>::value || isMatrixLike<R>::value)
+		{
+			return matrixBinary<Op>(std::forward<L>(l), std::forward<R>(r));
+		}
+		else
+		{
+			return arrayBinary<Op>(std::forward<L>(l), std::forward<R>(r));
+		}
+	}
+
+	template <typename E>
+	auto negate(E&& e)
+	{
+		if constexpr (isMatrixLike<E>::value)
+		{
+			using Node = UnaryMatrix<Neg, MatrixNode<E&&>>;
+			if constexpr (isTemporaryMatrix<E&&>::value)
+			{
+				Decay<E> out(std::move(e));
+				out = Node(toMatrixExpr(out));
+				return out;
+			}
+			else
+			{
+				return Node(toMatrixExpr(e));
+			}
+		}
+		else
+		{
+			using Node = UnaryArray<Neg, ArrayNode<E>>;
+			if constexpr (isTemporaryArray<E&&>::value)
+			{
+				Decay<E> out(std::move(e));
+				evaluateInto(out, Node(toArrayExpr(out)));
+				return out;
+			}
+			else
+			{
+				return Node(toArrayExpr(e));
+			}
+		}
+	}
+}
+
+// 逐元素四则运算：向量/矩阵与向量/矩阵/标量
+template <typename L, typename R, typename std::enable_if<BCexpr::isOperation<L, R>::value, int>::type = 0>
+auto operator+(L&& l, R&& r)
+{
+	return BCexpr::binary<BCexpr::Add>(std::forward<L>(l), std::forward<R>(r));
+}
+
+template <typename L, typename R, typename std::enable_if<BCexpr::isOperation<L, R>::value, int>::type = 0>
+auto operator-(L&& l, R&& r)
+{
+	return BCexpr::binary<BCexpr::Sub>(std::forward<L>(l), std::forward<R>(r));
+}
+
+template <typename L, typename R, typename std::enable_if<BCexpr::isOperation<L, R>::value, int>::type = 0>
+auto operator*(L&& l, R&& r)
+{
+	return BCexpr::binary<BCexpr::Mul>(std::forward<L>(l), std::forward<R>(r));
+}
+
+template <typename L, typename R, typename std::enable_if<BCexpr::isOperation<L, R>::value, int>::type = 0>
+auto operator/(L&& l, R&& r)
+{
+	return BCexpr::binary<BCexpr::Div>(std::forward<L>(l), std::forward<R>(r));
+}
+
+template <typename E, typename std::enable_if<BCexpr::isArrayLike<E>::value || BCexpr::isMatrixLike<E>::value, int>::type = 0>
+auto operator-(E&& e)
+{
+	return BCexpr::negate(std::forward<E>(e));
+}
+
+namespace BCexpr
+{
+	// 让表达式类型通过 ADL 也能找到上面的运算符
+	using ::operator+;
+	using ::operator-;
+	using ::operator*;
+	using ::operator/;
+}
+
+#endif
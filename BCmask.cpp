@@ -0,0 +1,83 @@
+﻿#include "stdafx.h"
+#include "BCmask.h"
+#include "BCsimd.h"
+#include <stdexcept>
+
+BCmask::BCmask(const vector<bool>& values) : vector<uint8_t>(values.size())
+{
+	for (size_t i = 0; i < values.size(); i++)
+		(*this)[i] = values[i] ? 1 : 0;
+}
+
+void BCmask::_checkSize(const BCmask& other) const
+{
+	if (size() != other.size())
+	{
+		throw invalid_argument("Mask sizes do not match.");
+	}
+}
+
+bool BCmask::test(size_t index) const
+{
+	return (*this)[index] != 0;
+}
+
+size_t BCmask::count() const
+{
+	return BCsimd::maskCount(data(), size());
+}
+
+bool BCmask::any() const
+{
+	return count() > 0;
+}
+
+bool BCmask::all() const
+{
+	return count() == size();
+}
+
+vector<size_t> BCmask::indices() const
+{
+	vector<size_t> result;
+	result.reserve(count());
+	for (size_t i = 0; i < size(); i++)
+	{
+		if ((*this)[i])
+			result.push_back(i);
+	}
+	return result;
+}
+
+BCmask BCmask::operator&&(const BCmask& other) const
+{
+	_checkSize(other);
+	BCmask result(size());
+	BCsimd::maskAnd(data(), other.data(), result.data(), size());
+	return result;
+}
+
+BCmask BCmask::operator&&(bool scalar) const
+{
+	return scalar ? *this : BCmask(size(), false);
+}
+
+BCmask BCmask::operator||(const BCmask& other) const
+{
+	_checkSize(other);
+	BCmask result(size());
+	BCsimd::maskOr(data(), other.data(), result.data(), size());
+	return result;
+}
+
+BCmask BCmask::operator||(bool scalar) const
+{
+	return scalar ? BCmask(size(), true) : *this;
+}
+
+BCmask BCmask::operator!() const
+{
+	BCmask result(size());
+	BCsimd::maskNot(data(), result.data(), size());
+	return result;
+}
@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include "stdafx.h"
+#ifndef BCMASK_H
+#define BCMASK_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+/**
+ * @class BCmask
+ * @brief 布尔掩码，由 BCarray 的比较和逻辑运算得到
+ *
+ * 每个元素占一个字节（0 或 1），便于 SIMD 处理；不使用 vector<bool> 的按位压缩存储。
+ * 常见用法：BCarray<double> big = a.filter(a > 10 && !(a == 20));
+ */
+class BCmask : public vector<uint8_t>
+{
+public:
+	BCmask() {}
+	explicit BCmask(size_t count, bool value = false) : vector<uint8_t>(count, value ? 1 : 0) {}
+	BCmask(const vector<bool>& values);
+
+	// 第 i 个元素是否为真
+	bool test(size_t index) const;
+	// 为真的元素个数
+	size_t count() const;
+	bool any() const;
+	bool all() const;
+	// 为真的元素下标
+	vector<size_t> indices() const;
+
+	BCmask operator&&(const BCmask& other) const;
+	BCmask operator&&(bool scalar) const;
+	BCmask operator||(const BCmask& other) const;
+	BCmask operator||(bool scalar) const;
+	BCmask operator!() const;
+
+private:
+	void _checkSize(const BCmask& other) const;
+};
+
+#endif
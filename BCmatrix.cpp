@@ -1,784 +1,1572 @@
-﻿#include "stdafx.h"
-#include "BCmatrix.h"
-#include "ST.h"
-
-void BCmatrix::_checkRowEqual(int size) const
-{
-	if (size != row)
-	{
-		throw invalid_argument("Row size does not match matrix dimensions.");
-	}
-}
-
-void BCmatrix::_checkColumnEqual(int size) const
-{
-	if (size != column)
-	{
-		throw invalid_argument("Column size does not match matrix dimensions.");
-	}
-}
-
-void BCmatrix::_checkRowRange(int index) const
-{
-	if (index < 0 || index >= row)
-	{
-		throw out_of_range("Row index out of range.");
-	}
-}
-
-void BCmatrix::_checkColumnRange(int index) const
-{
-	if (index < 0 || index >= column)
-	{
-		throw out_of_range("Column index out of range.");
-	}
-}
-
-BCmatrix::BCmatrix() {}
-
-BCmatrix::BCmatrix(size_t row, size_t column) : row(row), column(column), value(row, BCarray<double>(column, 0)) {}
-
-vector<BCarray<double>> BCmatrix::getValue() const
-{
-	return value;
-}
-
-vector<vector<double>> BCmatrix::getPureValue() const
-{
-	vector<vector<double>> res(row, vector<double>(column));
-	for (size_t i = 0; i < row; i++)
-	{
-		for (size_t j = 0; j < column; j++)
-		{
-			res[i][j] = value[i][j];
-		}
-	}
-	return res;
-}
-
-vector<int> BCmatrix::getGroup() const
-{
-	return group;
-}
-
-int BCmatrix::getRowCount() const
-{
-	return row;
-}
-
-int BCmatrix::getColumnCount() const
-{
-	return column;
-}
-
-pair<int, int> BCmatrix::getShape() const
-{
-	return make_pair(row, column);
-}
-
-vector<string> BCmatrix::getRowName() const
-{
-	return row_lst;
-}
-
-vector<string> BCmatrix::getColumnName() const
-{
-	return column_lst;
-}
-
-BCarray<double> BCmatrix::getRow(size_t row) const
-{
-	_checkRowRange(row);
-	return value[row];
-}
-
-BCmatrix BCmatrix::sliceRows(size_t start_index, size_t end_index) const {
-	if (start_index > end_index)
-		throw invalid_argument("sliceRows: start_index 必须 <= end_index");
-	if (end_index >= row)
-		throw out_of_range("sliceRows: end_index 越界");
-
-	size_t new_row_count = end_index - start_index + 1;
-	BCmatrix result(new_row_count, column);
-
-	result.column_lst = this->column_lst;
-
-	result.row_lst.clear();
-	for (size_t i = start_index; i <= end_index; i++) {
-		result.row_lst.push_back(this->row_lst[i]);
-	}
-
-	result.group.clear();
-	if (!this->group.empty())
-		result.set_group(this->getGroup());
-
-	result.value.clear();
-	result.value.reserve(new_row_count);
-	for (size_t i = start_index; i <= end_index; i++)
-		result.value.push_back(this->value[i]);
-
-	return result;
-}
-
-BCarray<double> BCmatrix::getColumn(size_t column) const
-{
-	_checkColumnRange(column);
-	BCarray<double> col(row);
-	for (size_t i = 0; i < row; i++)
-	{
-		col[i] = value[i][column];
-	}
-	return col;
-}
-
-double& BCmatrix::iloc(size_t row, size_t column)
-{
-	_checkRowRange(row);
-	_checkColumnRange(column);
-	return value[row][column];
-}
-
-double BCmatrix::iloc(size_t row, size_t column) const
-{
-	_checkRowRange(row);
-	_checkColumnRange(column);
-	return value[row][column];
-}
-
-int BCmatrix::findRow(string rowName) const
-{
-	for (size_t i = 0; i < row; i++)
-	{
-		if (row_lst[i] == rowName)
-		{
-			return i;
-		}
-	}
-	return -1;
-}
-
-int BCmatrix::findColumn(string columnName) const
-{
-	for (size_t i = 0; i < column; i++)
-	{
-		if (column_lst[i] == columnName)
-		{
-			return i;
-		}
-	}
-	return -1;
-}
-
-double& BCmatrix::loc(string rowName, string columnName)
-{
-	int rowIndex = findRow(rowName);
-	int columnIndex = findColumn(columnName);
-	if (rowIndex == -1 || columnIndex == -1)
-	{
-		throw out_of_range("Row or column name not found.");
-	}
-	return value[rowIndex][columnIndex];
-}
-
-double BCmatrix::loc(string rowName, string columnName) const
-{
-	int rowIndex = findRow(rowName);
-	int columnIndex = findColumn(columnName);
-	if (rowIndex == -1 || columnIndex == -1)
-	{
-		throw out_of_range("Row or column name not found.");
-	}
-	return value[rowIndex][columnIndex];
-}
-
-double& BCmatrix::operator()(size_t row, size_t column)
-{
-	return iloc(row, column);
-}
-
-double BCmatrix::operator()(size_t row, size_t column) const
-{
-	return iloc(row, column);
-}
-
-double& BCmatrix::operator()(string rowName, string columnName)
-{
-	return loc(rowName, columnName);
-}
-
-double BCmatrix::operator()(string rowName, string columnName) const
-{
-	return loc(rowName, columnName);
-}
-
-BCarray<double> BCmatrix::operator()(size_t index, char mod) const
-{
-	if (mod == 'r')
-	{
-		return getRow(index);
-	}
-	else if (mod == 'c')
-	{
-		return getColumn(index);
-	}
-	else
-	{
-		throw invalid_argument("Invalid mode. Use 'r' for row or 'c' for column.");
-	}
-}
-
-BCarray<double> BCmatrix::operator()(string name, char mod) const
-{
-	if (mod == 'r')
-	{
-		int index = findRow(name);
-		if (index == -1)
-		{
-			throw out_of_range("Row name not found.");
-		}
-		return getRow(index);
-	}
-	else if (mod == 'c')
-	{
-		int index = findColumn(name);
-		if (index == -1)
-		{
-			throw out_of_range("Column name not found.");
-		}
-		return getColumn(index);
-	}
-	else
-	{
-		throw invalid_argument("Invalid mode. Use 'r' for row or 'c' for column.");
-	}
-}
-
-void BCmatrix::setRowName(size_t index, string name)
-{
-	_checkRowRange(index);
-	row_lst[index] = name;
-}
-
-void BCmatrix::setColumnName(size_t index, string name)
-{
-	_checkColumnRange(index);
-	column_lst[index] = name;
-}
-
-void BCmatrix::deleteRow(size_t index)
-{
-	_checkRowRange(index);
-	value.erase(value.begin() + index);
-	row_lst.erase(row_lst.begin() + index);
-	--row;
-}
-
-void BCmatrix::deleteColumn(size_t index)
-{
-	_checkColumnRange(index);
-	for (size_t i = 0; i < row; i++)
-	{
-		value[i].erase(value[i].begin() + index);
-	}
-	column_lst.erase(column_lst.begin() + index);
-	--column;
-}
-
-void BCmatrix::addRow(const BCarray<double>& newRow, string name)
-{
-	_checkColumnEqual(newRow.size());
-	value.push_back(newRow);
-	row_lst.push_back(name);
-	++row;
-}
-
-void BCmatrix::addColumn(const BCarray<double>& newColumn, string name)
-{
-	_checkRowEqual(newColumn.size());
-	for (size_t i = 0; i < row; i++)
-	{
-		value[i].push_back(newColumn[i]);
-	}
-	column_lst.push_back(name);
-	++column;
-}
-
-// 实现和标量的四则运算
-BCmatrix BCmatrix::operator+(const double& scalar)
-{
-	BCmatrix result(*this);
-	for (size_t i = 0; i < row; i++)
-		for (size_t j = 0; j < column; j++)
-			result(i, j) += scalar;
-	return result;
-}
-
-BCmatrix BCmatrix::operator-(const double& scalar)
-{
-	return operator+(-scalar);
-}
-
-BCmatrix BCmatrix::operator*(const double& scalar)
-{
-	BCmatrix result(*this);
-	for (size_t i = 0; i < row; i++)
-		for (size_t j = 0; j < column; j++)
-			result(i, j) *= scalar;
-	return result;
-}
-
-BCmatrix BCmatrix::operator/(const double& scalar)
-{
-	return operator*(1.0 / scalar);
-}
-
-// 实现和向量的四则运算（注意行向量和列向量）
-BCmatrix BCmatrix::operator+(const BCarray<double>& vec)
-{
-	if (vec.isRowVector() && vec.size() == column)
-	{
-		BCmatrix result(*this);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				result(i, j) += vec[j];
-		return result;
-	}
-	else if (!vec.isRowVector() && vec.size() == row)
-	{
-		BCmatrix result(*this);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				result(i, j) += vec[i];
-		return result;
-	}
-	else
-	{
-		throw invalid_argument("Vector size does not match matrix dimensions.");
-	}
-}
-
-BCmatrix BCmatrix::operator-(const BCarray<double>& vec)
-{
-	return operator+(vec * -1);
-}
-
-BCmatrix BCmatrix::operator*(const BCarray<double>& vec)
-{
-	if (vec.isRowVector() && vec.size() == column)
-	{
-		BCmatrix result(*this);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				result(i, j) *= vec[j];
-		return result;
-	}
-	else if (!vec.isRowVector() && vec.size() == row)
-	{
-		BCmatrix result(*this);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				result(i, j) *= vec[i];
-		return result;
-	}
-	else
-	{
-		throw invalid_argument("Vector size does not match matrix dimensions.");
-	}
-}
-
-BCmatrix BCmatrix::operator/(const BCarray<double>& vec)
-{
-	if (vec.isRowVector() && vec.size() == column)
-	{
-		BCmatrix result(*this);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				result(i, j) /= vec[j];
-		return result;
-	}
-	else if (!vec.isRowVector() && vec.size() == row)
-	{
-		BCmatrix result(*this);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				result(i, j) /= vec[i];
-		return result;
-	}
-	else
-	{
-		throw invalid_argument("Vector size does not match matrix dimensions.");
-	}
-}
-
-void BCmatrix::clear()
-{
-	value.clear();
-	row_lst.clear();
-	column_lst.clear();
-	row = 0;
-	column = 0;
-}
-
-void BCmatrix::load_data(const string& filename)
-{
-	ifstream file(filename);
-	if (!file.is_open())
-	{
-		throw runtime_error("Failed to open file.");
-	}
-
-	this->clear();
-	string line;
-
-	// 读取表头
-	if (getline(file, line))
-	{
-		stringstream ss(line);
-		string token;
-		getline(ss, token, ','); // 跳过 "Gene ID"
-		while (getline(ss, token, ','))
-		{
-			column_lst.push_back(token);
-		}
-		column = column_lst.size();
-	}
-
-	// 读取每一行基因数据
-	while (getline(file, line))
-	{
-		stringstream ss(line);
-		string geneID;
-		getline(ss, geneID, ',');
-		row_lst.push_back(geneID);
-
-		BCarray<double> rowValues(column);
-		string token;
-		size_t colIdx = 0;
-		while (getline(ss, token, ','))
-		{
-			rowValues[colIdx++] = stod(token);
-		}
-		this->value.push_back(rowValues);
-	}
-
-	row = row_lst.size();
-	file.close();
-}
-
-void BCmatrix::load_group(const string& filename)
-{
-	ifstream file(filename);
-	if (!file.is_open())
-	{
-		throw runtime_error("Failed to open file.");
-	}
-
-	this->group.clear();
-	string line;
-
-	getline(file, line); // 跳过表头id
-	while (getline(file, line))
-	{
-		group.push_back(stoi(line));
-	}
-
-	// 检查group数是否与列数一致
-	if (group.size() != column)
-	{
-		cout << "group size:  " << group.size() << endl;
-		cout << "column size: " << column << endl;
-		throw runtime_error("group size does not match column size.\n group size:  " + to_string(group.size()) + "\ncolumn size: " + to_string(column));
-	}
-	file.close();
-}
-
-void BCmatrix::set_group(const vector<int> gp) {
-	this->group = gp;
-}
-
-void BCmatrix::to_csv(const string& filename) const
-{
-	ofstream out(filename);
-	if (!out.is_open())
-		throw runtime_error("Unable to open file for writing: " + filename);
-
-	out << "Gene";
-	for (const auto& sample_name : column_lst)
-		out << "," << sample_name;
-	out << "\n";
-
-	for (size_t i = 0; i < row; i++)
-	{
-		out << row_lst[i];
-		for (size_t j = 0; j < column; j++)
-			out << "," << setprecision(6) << value[i][j];
-		out << "\n";
-	}
-
-	out.close();
-}
-
-void BCmatrix::normalize(const string& method, const string& axis)
-{
-	if (axis == "column")
-	{
-		for (size_t j = 0; j < column; j++)
-		{
-			BCarray<double> col = this->getColumn(j);
-			BCarray<double> normCol = col.normalize(method);
-			for (size_t i = 0; i < row; i++)
-			{
-				value[i][j] = normCol[i];
-			}
-		}
-	}
-	else if (axis == "row")
-	{
-		for (size_t i = 0; i < row; i++)
-		{
-			BCarray<double> rowVec = this->getRow(i);
-			BCarray<double> normRow = rowVec.normalize(method);
-			for (size_t j = 0; j < column; j++)
-			{
-				value[i][j] = normRow[j];
-			}
-		}
-	}
-	else if (axis == "all")
-	{
-		// 把所有元素按行优先"拍瘪"到一个 BCarray
-		BCarray<double> flat;
-		flat.reserve(row * column);
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				flat.push_back(value[i][j]);
-
-		// 整体归一化
-		BCarray<double> normFlat = flat.normalize(method);
-
-		size_t idx = 0;
-		for (size_t i = 0; i < row; i++)
-			for (size_t j = 0; j < column; j++)
-				value[i][j] = normFlat[idx++];
-	}
-	else
-	{
-		throw invalid_argument("normalize(): 'axis' 参数必须为 'row', 'column' 或 'all'");
-	}
-}
-
-BCmatrix BCmatrix::t_test()
-{
-	BCmatrix result;
-	result.column = 3;
-	result.column_lst = { "log2_fc", "t", "p_value" };
-	result.group = group;
-
-	// 分实验组和对照组，进行t检验
-	for (size_t i = 0; i < row; i++)
-	{
-		BCarray<double> rowData = this->getRow(i);
-		pair<BCarray<double>, BCarray<double>> splitData = rowData.split(group);
-		StatTools::t_testResult t_testResult = StatTools::t_test(splitData.first, splitData.second);
-
-		vector<double> res = { t_testResult.log2_fc, t_testResult.t, t_testResult.p_value };
-		BCarray<double> rowResult(res);
-		result.addRow(rowResult, row_lst[i]);
-	}
-
-	// FDR调整
-	BCarray<double> fdr_p_values = StatTools::adjust_fdr(result.getColumn(2));
-	result.addColumn(fdr_p_values, "fdr_p_value");
-
-	return result;
-}
-
-BCmatrix BCmatrix::deseq2()
-{
-	BCmatrix result;
-	// 3 列：log2FC, pvalue, padj
-	result.column = 3;
-	result.column_lst = { "log2FC", "pvalue", "padj" };
-	result.group = this->group;
-
-	// 将 BCmatrix 中的 counts 提取为 G*N 的 vector  
-	size_t G = this->row;
-	size_t N = this->column;
-	vector<vector<double>> counts(G, vector<double>(N));
-	for (size_t i = 0; i < G; i++) {
-		BCarray<double> rowData = this->getRow(i);
-		for (size_t j = 0; j < N; j++) {
-			counts[i][j] = rowData[j];
-		}
-	}
-
-	vector<StatTools::DESeq2Result> deRes = StatTools::performDESeq2(counts, this->group);
-
-	// 将结果写入新的 BCmatrix
-	for (size_t i = 0; i < G; i++) {
-		vector<double> vals = {
-			deRes[i].log2FC,
-			deRes[i].pvalue,
-			deRes[i].padj
-		};
-		BCarray<double> rowArr(vals);
-		result.addRow(rowArr, this->row_lst[i]);
-	}
-
-	return result;
-}
-
-vector<vector<double>> BCmatrix::values() const
-{
-	vector<vector<double>> matrix(row);
-
-	for (size_t i = 0; i < row; i++)
-	{
-		matrix[i].resize(column);
-		for (size_t j = 0; j < column; j++) {
-			matrix[i][j] = value[i][j];
-		}
-	}
-
-	return matrix;
-}
-
-BCmatrix BCmatrix::performPCA(int num_components) const
-{
-	auto data = this->getPureValue();
-	auto transformed = StatTools::performPCA(data, num_components);
-
-	BCmatrix result(this->getRowCount(), static_cast<size_t>(num_components));
-
-	result.row_lst = this->row_lst;
-	result.column_lst.clear();
-	for (int j = 0; j < num_components; j++) {
-		result.column_lst.push_back("component_" + to_string(j + 1));
-	}
-
-	result.value.clear();
-	result.value.reserve(transformed.size());
-	for (size_t i = 0; i < transformed.size(); i++) {
-		result.value.emplace_back(transformed[i], true);
-	}
-	return result;
-}
-
-BCmatrix BCmatrix::performLLE(int n_neighbors, int dim, double reg) const {
-	auto data = this->getPureValue();
-	auto transformed = StatTools::performLLE(data, n_neighbors, dim, reg);
-
-	BCmatrix result(this->getRowCount(), static_cast<size_t>(dim));
-
-	result.row_lst = this->row_lst;
-	result.column_lst.clear();
-	for (int j = 0; j < dim; j++) {
-		result.column_lst.push_back("lle_" + to_string(j + 1));
-	}
-
-	result.value.clear();
-	result.value.reserve(transformed.size());
-	for (size_t i = 0; i < transformed.size(); i++) {
-		result.value.emplace_back(transformed[i], true);
-	}
-	return result;
-}
-
-BCmatrix BCmatrix::performTSNE(int dim, double perplexity, int max_iter, double lr) const
-{
-	auto data = this->getPureValue();
-	auto transformed = StatTools::performTSNE(data, dim, perplexity, max_iter, lr);
-
-	BCmatrix result(this->getRowCount(), static_cast<size_t>(dim));
-
-	result.row_lst = this->row_lst;
-	result.column_lst.clear();
-	for (int j = 0; j < dim; j++) {
-		result.column_lst.push_back("tsne_" + to_string(j + 1));
-	}
-
-	result.value.clear();
-	result.value.reserve(transformed.size());
-	for (size_t i = 0; i < transformed.size(); i++) {
-		result.value.emplace_back(transformed[i], true);
-	}
-	return result;
-}
-
-BCmatrix BCmatrix::describe(const string& axis) const
-{
-	static const vector<string> metrics = {
-		"count", "mean", "std", "min", "25%", "50%", "75%", "max",
-		"skewness", "kurtosis", "mode"
-	};
-	const size_t M = metrics.size();
-
-	// 统计方向
-	size_t N;
-	bool byColumn;
-	if (axis == "column") {
-		N = this->column;
-		byColumn = true;
-	}
-	else if (axis == "row") {
-		N = this->row;
-		byColumn = false;
-	}
-	else {
-		throw invalid_argument("describe: axis 必须是 'row' 或 'column'");
-	}
-
-	BCmatrix result(M, N);
-	result.row_lst = metrics;
-	result.column_lst = byColumn ? this->column_lst : this->row_lst;
-
-	for (size_t j = 0; j < N; j++) {
-		// 取出这一列或这一行的数据
-		BCarray<double> arr = byColumn ? this->getColumn(j) : this->getRow(j);
-		vector<double> vec = static_cast<vector<double>>(arr);
-
-		for (size_t i = 0; i < M; i++) {
-			double v = 0.0;
-			switch (i) {
-			case 0:  // count
-				v = static_cast<double>(vec.size());
-				break;
-			case 1:  // mean
-				v = StatTools::mean(vec);
-				break;
-			case 2:  // std
-				v = StatTools::sampleStd(vec);
-				break;
-			case 3:  // min
-				v = StatTools::min(vec);
-				break;
-			case 4:  // 25%
-				v = StatTools::percentile(vec, 0.25);
-				break;
-			case 5:  // 50%
-				v = StatTools::percentile(vec, 0.50);
-				break;
-			case 6:  // 75%
-				v = StatTools::percentile(vec, 0.75);
-				break;
-			case 7:  // max
-				v = StatTools::max(vec);
-				break;
-			case 8:  // skewness
-				v = StatTools::skewness(vec);
-				break;
-			case 9:  // kurtosis
-				v = StatTools::kurtosis(vec);
-				break;
-			case 10: // mode
-				v = StatTools::mode(vec);
-				break;
-			}
-			result.value[i][j] = v;
-		}
-	}
-
-	return result;
-}
-
-
+﻿#include "stdafx.h"
+#include "BCmatrix.h"
+#include "ST.h"
+#include "MappedFile.h"
+#include "BCmatrixFile.h"
+#include <charconv>
+#include <cstring>
+
+void BCmatrix::_checkRowEqual(int size) const
+{
+	if (size != row)
+	{
+		throw invalid_argument("Row size does not match matrix dimensions.");
+	}
+}
+
+void BCmatrix::_checkColumnEqual(int size) const
+{
+	if (size != column)
+	{
+		throw invalid_argument("Column size does not match matrix dimensions.");
+	}
+}
+
+void BCmatrix::_checkRowRange(int index) const
+{
+	if (index < 0 || index >= row)
+	{
+		throw out_of_range("Row index out of range.");
+	}
+}
+
+void BCmatrix::_checkColumnRange(int index) const
+{
+	if (index < 0 || index >= column)
+	{
+		throw out_of_range("Column index out of range.");
+	}
+}
+
+BCmatrix::BCmatrix() {}
+
+BCmatrix::BCmatrix(size_t row, size_t column) : row(row), column(column), value(row, BCarray<double>(column, 0)) {}
+
+const vector<BCarray<double>>& BCmatrix::getValue() const
+{
+	return value;
+}
+
+vector<vector<double>> BCmatrix::getPureValue() const
+{
+	vector<vector<double>> res;
+	res.reserve(row);
+	for (size_t i = 0; i < row; i++)
+	{
+		res.emplace_back(value[i].begin(), value[i].end());
+	}
+	return res;
+}
+
+const vector<int>& BCmatrix::getGroup() const
+{
+	return group;
+}
+
+int BCmatrix::getRowCount() const
+{
+	return row;
+}
+
+int BCmatrix::getColumnCount() const
+{
+	return column;
+}
+
+pair<int, int> BCmatrix::getShape() const
+{
+	return make_pair(row, column);
+}
+
+const vector<string>& BCmatrix::getRowName() const
+{
+	return row_lst;
+}
+
+const vector<string>& BCmatrix::getColumnName() const
+{
+	return column_lst;
+}
+
+BCarray<double> BCmatrix::getRow(size_t row) const
+{
+	_checkRowRange(row);
+	return value[row];
+}
+
+BCmatrix BCmatrix::sliceRows(size_t start_index, size_t end_index) const {
+	if (start_index > end_index)
+		throw invalid_argument("sliceRows: start_index 必须 <= end_index");
+	if (end_index >= row)
+		throw out_of_range("sliceRows: end_index 越界");
+
+	size_t new_row_count = end_index - start_index + 1;
+	BCmatrix result(new_row_count, column);
+
+	result.column_lst = this->column_lst;
+
+	result.row_lst.clear();
+	for (size_t i = start_index; i <= end_index; i++) {
+		result.row_lst.push_back(this->row_lst[i]);
+	}
+
+	result.group.clear();
+	if (!this->group.empty())
+		result.set_group(this->getGroup());
+
+	result.value.clear();
+	result.value.reserve(new_row_count);
+	for (size_t i = start_index; i <= end_index; i++)
+		result.value.push_back(this->value[i]);
+
+	return result;
+}
+
+BCarray<double> BCmatrix::getColumn(size_t column) const
+{
+	_checkColumnRange(column);
+	BCarray<double> col(row);
+	for (size_t i = 0; i < row; i++)
+	{
+		col[i] = value[i][column];
+	}
+	return col;
+}
+
+RowView BCmatrix::rowView(size_t row) const
+{
+	_checkRowRange(row);
+	return RowView(value[row].data(), column);
+}
+
+ColumnView BCmatrix::columnView(size_t column) const
+{
+	_checkColumnRange(column);
+	return ColumnView(value.data(), row, column);
+}
+
+double& BCmatrix::iloc(size_t row, size_t column)
+{
+	_checkRowRange(row);
+	_checkColumnRange(column);
+	return value[row][column];
+}
+
+double BCmatrix::iloc(size_t row, size_t column) const
+{
+	_checkRowRange(row);
+	_checkColumnRange(column);
+	return value[row][column];
+}
+
+int BCmatrix::NameIndex::find(const vector<string>& names, const string& name)
+{
+	if (!valid)
+	{
+		map.clear();
+		map.reserve(names.size());
+		hasDuplicates = false;
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			if (!map.emplace(names[i], i).second)
+				hasDuplicates = true;
+		}
+		valid = true;
+	}
+	auto it = map.find(name);
+	return it == map.end() ? -1 : static_cast<int>(it->second);
+}
+
+void BCmatrix::NameIndex::append(const string& name, size_t index)
+{
+	if (valid && !map.emplace(name, index).second)
+		hasDuplicates = true;
+}
+
+void BCmatrix::NameIndex::rename(size_t index, const string& oldName, const string& newName)
+{
+	if (!valid || oldName == newName)
+		return;
+	// 有重名时无法在 O(1) 内确定新的"第一次出现"位置，交给下次查找重建
+	if (hasDuplicates)
+	{
+		invalidate();
+		return;
+	}
+	map.erase(oldName);
+	auto res = map.emplace(newName, index);
+	if (!res.second)
+	{
+		hasDuplicates = true;
+		res.first->second = min(res.first->second, index);
+	}
+}
+
+void BCmatrix::NameIndex::erase(size_t index, const string& name, size_t newSize)
+{
+	if (!valid)
+		return;
+	// 删除末尾且无重名时直接移除；否则后面的索引都要平移，等下次查找时重建
+	if (index == newSize && !hasDuplicates)
+		map.erase(name);
+	else
+		invalidate();
+}
+
+void BCmatrix::NameIndex::invalidate()
+{
+	valid = false;
+	map.clear();
+}
+
+int BCmatrix::findRow(const string& rowName) const
+{
+	return row_index.find(row_lst, rowName);
+}
+
+int BCmatrix::findColumn(const string& columnName) const
+{
+	return column_index.find(column_lst, columnName);
+}
+
+vector<int> BCmatrix::findRows(const vector<string>& rowNames) const
+{
+	vector<int> indices(rowNames.size());
+	for (size_t k = 0; k < rowNames.size(); k++)
+	{
+		indices[k] = findRow(rowNames[k]);
+	}
+	return indices;
+}
+
+double& BCmatrix::loc(const string& rowName, const string& columnName)
+{
+	int rowIndex = findRow(rowName);
+	int columnIndex = findColumn(columnName);
+	if (rowIndex == -1 || columnIndex == -1)
+	{
+		throw out_of_range("Row or column name not found.");
+	}
+	return value[rowIndex][columnIndex];
+}
+
+double BCmatrix::loc(const string& rowName, const string& columnName) const
+{
+	int rowIndex = findRow(rowName);
+	int columnIndex = findColumn(columnName);
+	if (rowIndex == -1 || columnIndex == -1)
+	{
+		throw out_of_range("Row or column name not found.");
+	}
+	return value[rowIndex][columnIndex];
+}
+
+BCmatrix BCmatrix::locRows(const vector<string>& rowNames) const
+{
+	vector<int> indices = findRows(rowNames);
+
+	BCmatrix result;
+	result.row = indices.size();
+	result.column = column;
+	result.column_lst = column_lst;
+	result.group = group;
+	result.row_lst.reserve(indices.size());
+	result.value.reserve(indices.size());
+	for (size_t k = 0; k < indices.size(); k++)
+	{
+		if (indices[k] == -1)
+		{
+			throw out_of_range("Row name not found: " + rowNames[k]);
+		}
+		result.row_lst.push_back(row_lst[indices[k]]);
+		result.value.push_back(value[indices[k]]);
+	}
+	return result;
+}
+
+double& BCmatrix::operator()(size_t row, size_t column)
+{
+	return iloc(row, column);
+}
+
+double BCmatrix::operator()(size_t row, size_t column) const
+{
+	return iloc(row, column);
+}
+
+double& BCmatrix::operator()(string rowName, string columnName)
+{
+	return loc(rowName, columnName);
+}
+
+double BCmatrix::operator()(string rowName, string columnName) const
+{
+	return loc(rowName, columnName);
+}
+
+BCarray<double> BCmatrix::operator()(size_t index, char mod) const
+{
+	if (mod == 'r')
+	{
+		return getRow(index);
+	}
+	else if (mod == 'c')
+	{
+		return getColumn(index);
+	}
+	else
+	{
+		throw invalid_argument("Invalid mode. Use 'r' for row or 'c' for column.");
+	}
+}
+
+BCarray<double> BCmatrix::operator()(string name, char mod) const
+{
+	if (mod == 'r')
+	{
+		int index = findRow(name);
+		if (index == -1)
+		{
+			throw out_of_range("Row name not found.");
+		}
+		return getRow(index);
+	}
+	else if (mod == 'c')
+	{
+		int index = findColumn(name);
+		if (index == -1)
+		{
+			throw out_of_range("Column name not found.");
+		}
+		return getColumn(index);
+	}
+	else
+	{
+		throw invalid_argument("Invalid mode. Use 'r' for row or 'c' for column.");
+	}
+}
+
+void BCmatrix::setRowName(size_t index, string name)
+{
+	_checkRowRange(index);
+	row_index.rename(index, row_lst[index], name);
+	row_lst[index] = name;
+}
+
+void BCmatrix::setColumnName(size_t index, string name)
+{
+	_checkColumnRange(index);
+	column_index.rename(index, column_lst[index], name);
+	column_lst[index] = name;
+}
+
+void BCmatrix::deleteRow(size_t index)
+{
+	_checkRowRange(index);
+	value.erase(value.begin() + index);
+	row_index.erase(index, row_lst[index], row - 1);
+	row_lst.erase(row_lst.begin() + index);
+	--row;
+}
+
+void BCmatrix::deleteColumn(size_t index)
+{
+	_checkColumnRange(index);
+	for (size_t i = 0; i < row; i++)
+	{
+		value[i].erase(value[i].begin() + index);
+	}
+	column_index.erase(index, column_lst[index], column - 1);
+	column_lst.erase(column_lst.begin() + index);
+	--column;
+}
+
+void BCmatrix::addRow(const BCarray<double>& newRow, string name)
+{
+	_checkColumnEqual(newRow.size());
+	value.push_back(newRow);
+	row_index.append(name, row);
+	row_lst.push_back(name);
+	++row;
+}
+
+void BCmatrix::addColumn(const BCarray<double>& newColumn, string name)
+{
+	_checkRowEqual(newColumn.size());
+	for (size_t i = 0; i < row; i++)
+	{
+		value[i].push_back(newColumn[i]);
+	}
+	column_index.append(name, column);
+	column_lst.push_back(name);
+	++column;
+}
+
+void BCmatrix::clear()
+{
+	value.clear();
+	row_lst.clear();
+	column_lst.clear();
+	row_index.invalidate();
+	column_index.invalidate();
+	row = 0;
+	column = 0;
+}
+
+// 并行扫描换行符，返回 [begin, end) 内每一行的起始偏移
+static vector<size_t> indexLines(const char* buf, size_t begin, size_t end)
+{
+	const size_t minChunk = 1 << 20;
+	size_t chunk = max((end - begin + StatTools::threadCount() - 1) / StatTools::threadCount(), minChunk);
+	size_t nChunks = (end - begin + chunk - 1) / chunk;
+
+	vector<vector<size_t>> parts(nChunks);
+	StatTools::parallelFor(0, nChunks, [&](size_t lo, size_t hi)
+		{
+			for (size_t c = lo; c < hi; c++)
+			{
+				size_t from = begin + c * chunk;
+				const char* p = buf + from;
+				const char* stop = buf + min(end, from + chunk);
+				vector<size_t>& starts = parts[c];
+				if (from == begin)
+					starts.push_back(begin);
+				while (p < stop)
+				{
+					const char* nl = static_cast<const char*>(memchr(p, '\n', stop - p));
+					if (nl == nullptr)
+						break;
+					if (static_cast<size_t>(nl + 1 - buf) < end)
+						starts.push_back(nl + 1 - buf);
+					p = nl + 1;
+				}
+			}
+		});
+
+	size_t total = 0;
+	for (const auto& part : parts)
+		total += part.size();
+	vector<size_t> lineStarts;
+	lineStarts.reserve(total);
+	for (const auto& part : parts)
+		lineStarts.insert(lineStarts.end(), part.begin(), part.end());
+	return lineStarts;
+}
+
+// 切出一行中逗号分隔的字段，去掉行尾的 '\r'
+static void splitFields(const char* first, const char* last, vector<pair<const char*, const char*>>& fields)
+{
+	fields.clear();
+	if (last > first && *(last - 1) == '\r')
+		--last;
+	const char* p = first;
+	while (true)
+	{
+		const char* comma = static_cast<const char*>(memchr(p, ',', last - p));
+		if (comma == nullptr)
+		{
+			fields.emplace_back(p, last);
+			break;
+		}
+		fields.emplace_back(p, comma);
+		p = comma + 1;
+	}
+}
+
+// 不依赖 locale 地解析一个数值字段，允许首尾空白和前导 '+'
+static bool parseDouble(const char* first, const char* last, double& out)
+{
+	while (first < last && (*first == ' ' || *first == '\t'))
+		++first;
+	while (last > first && (*(last - 1) == ' ' || *(last - 1) == '\t'))
+		--last;
+	if (first < last && *first == '+')
+		++first;
+	if (first == last)
+		return false;
+	from_chars_result res = from_chars(first, last, out);
+	return res.ec == errc() && res.ptr == last;
+}
+
+void BCmatrix::load_data(const string& filename)
+{
+	MappedFile file(filename);
+	this->clear();
+
+	const char* buf = file.data();
+	size_t size = file.size();
+	size_t pos = 0;
+	// 跳过 Excel 等工具写入的 UTF-8 BOM
+	if (size >= 3 && memcmp(buf, "\xEF\xBB\xBF", 3) == 0)
+		pos = 3;
+	if (pos >= size)
+		return;
+
+	// 建立行索引
+	vector<size_t> lineStarts = indexLines(buf, pos, size);
+	auto lineEnd = [&](size_t k)
+		{
+			if (k + 1 < lineStarts.size())
+				return lineStarts[k + 1] - 1;
+			return buf[size - 1] == '\n' ? size - 1 : size;
+		};
+
+	// 读取表头
+	vector<pair<const char*, const char*>> fields;
+	splitFields(buf + lineStarts[0], buf + lineEnd(0), fields);
+	for (size_t f = 1; f < fields.size(); f++) // 跳过 "Gene ID"
+		column_lst.emplace_back(fields[f].first, fields[f].second);
+	column = column_lst.size();
+
+	// 跳过空行，记录每个数据行对应的文件行号
+	vector<size_t> dataLines;
+	dataLines.reserve(lineStarts.size());
+	for (size_t k = 1; k < lineStarts.size(); k++)
+	{
+		size_t len = lineEnd(k) - lineStarts[k];
+		if (len == 0 || (len == 1 && buf[lineStarts[k]] == '\r'))
+			continue;
+		dataLines.push_back(k);
+	}
+	row = dataLines.size();
+	row_lst.resize(row);
+	value.resize(row);
+
+	// 并行解析每一行，直接写入预分配好的行存储；出错时不留下半成品
+	try
+	{
+		StatTools::parallelFor(0, row, [&](size_t lo, size_t hi)
+			{
+				vector<pair<const char*, const char*>> cells;
+				cells.reserve(column + 1);
+				for (size_t i = lo; i < hi; i++)
+				{
+					size_t k = dataLines[i];
+					splitFields(buf + lineStarts[k], buf + lineEnd(k), cells);
+					if (cells.size() != column + 1)
+					{
+						throw runtime_error("load_data: 第 " + to_string(k + 1) + " 行有 " + to_string(cells.size() - 1)
+							+ " 个数值，而表头有 " + to_string(column) + " 列");
+					}
+					row_lst[i].assign(cells[0].first, cells[0].second);
+
+					BCarray<double>& rowValues = value[i];
+					rowValues.resize(column);
+					for (size_t j = 0; j < column; j++)
+					{
+						if (!parseDouble(cells[j + 1].first, cells[j + 1].second, rowValues[j]))
+						{
+							string token(cells[j + 1].first, min<size_t>(cells[j + 1].second - cells[j + 1].first, 32));
+							throw runtime_error("load_data: 第 " + to_string(k + 1) + " 行第 " + to_string(j + 2)
+								+ " 列（样本 \"" + column_lst[j] + "\"）无法解析为数值: \"" + token + "\"");
+						}
+					}
+				}
+			}, 256);
+	}
+	catch (...)
+	{
+		this->clear();
+		throw;
+	}
+}
+
+void BCmatrix::load_group(const string& filename)
+{
+	ifstream file(filename);
+	if (!file.is_open())
+	{
+		throw runtime_error("Failed to open file.");
+	}
+
+	this->group.clear();
+	string line;
+
+	getline(file, line); // 跳过表头id
+	while (getline(file, line))
+	{
+		group.push_back(stoi(line));
+	}
+
+	// 检查group数是否与列数一致
+	if (group.size() != column)
+	{
+		cout << "group size:  " << group.size() << endl;
+		cout << "column size: " << column << endl;
+		throw runtime_error("group size does not match column size.\n group size:  " + to_string(group.size()) + "\ncolumn size: " + to_string(column));
+	}
+	file.close();
+}
+
+void BCmatrix::set_group(const vector<int> gp) {
+	this->group = gp;
+}
+
+// 把一个数值追加到 buf；precision < 0 时用最短往返表示
+static void appendDouble(string& buf, double v, int precision)
+{
+	char tmp[64];
+	to_chars_result res = precision < 0
+		? to_chars(tmp, tmp + sizeof(tmp), v)
+		: to_chars(tmp, tmp + sizeof(tmp), v, chars_format::general, precision);
+	buf.append(tmp, res.ptr);
+}
+
+void BCmatrix::to_csv(const string& filename, int precision) const
+{
+	ofstream out(filename, ios::binary);
+	if (!out.is_open())
+		throw runtime_error("Unable to open file for writing: " + filename);
+
+	string header = "Gene";
+	for (const auto& sample_name : column_lst)
+	{
+		header += ',';
+		header += sample_name;
+	}
+	header += '\n';
+	out.write(header.data(), header.size());
+
+	// 行分块格式化：每一批的各块在多个线程上并行格式化，再按顺序写出
+	const size_t blockRows = 512;
+	const size_t nBlocks = (row + blockRows - 1) / blockRows;
+	const size_t batch = StatTools::threadCount() * 2;
+	vector<string> blocks(batch);
+	for (size_t b0 = 0; b0 < nBlocks; b0 += batch)
+	{
+		size_t b1 = min(nBlocks, b0 + batch);
+		StatTools::parallelFor(b0, b1, [&](size_t lo, size_t hi)
+			{
+				for (size_t b = lo; b < hi; b++)
+				{
+					string& buf = blocks[b - b0];
+					buf.clear();
+					size_t r1 = min(row, (b + 1) * blockRows);
+					for (size_t i = b * blockRows; i < r1; i++)
+					{
+						buf += row_lst[i];
+						for (size_t j = 0; j < column; j++)
+						{
+							buf += ',';
+							appendDouble(buf, value[i][j], precision);
+						}
+						buf += '\n';
+					}
+				}
+			});
+		for (size_t b = b0; b < b1; b++)
+			out.write(blocks[b - b0].data(), blocks[b - b0].size());
+	}
+
+	if (!out.good())
+		throw runtime_error("Failed to write file: " + filename);
+	out.close();
+}
+
+void BCmatrix::save_binary(const string& filename, bool compress) const
+{
+	BCmatrixFile::write(filename, *this, compress);
+}
+
+void BCmatrix::load_binary(const string& filename)
+{
+	BCmatrixFile file(filename);
+	this->clear();
+
+	row = file.rows();
+	column = file.columns();
+	row_lst = file.rowNames();
+	column_lst = file.columnNames();
+	if (!file.group().empty())
+		group = file.group();
+	value.resize(row);
+
+	// 压缩列需要先整列解码；未压缩列直接从映射内存读取
+	vector<const double*> columns(column);
+	vector<vector<double>> decoded(column);
+	StatTools::parallelFor(0, column, [&](size_t lo, size_t hi)
+		{
+			for (size_t j = lo; j < hi; j++)
+			{
+				columns[j] = file.columnData(j);
+				if (columns[j] == nullptr)
+				{
+					decoded[j].resize(row);
+					file.readColumn(j, decoded[j].data());
+					columns[j] = decoded[j].data();
+				}
+			}
+		});
+
+	// 列块转回行存储，按行分块并行
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi)
+		{
+			for (size_t i = lo; i < hi; i++)
+			{
+				value[i].resize(column);
+				for (size_t j = 0; j < column; j++)
+					value[i][j] = columns[j][i];
+			}
+		}, 256);
+}
+
+// 一组数据的归一化统计量；第一遍累加 sum / sq / 最值，z-score 第二遍再累加离差平方和
+struct NormStats
+{
+	size_t n = 0;
+	double sum = 0.0;
+	double sq = 0.0;
+	double minValue = numeric_limits<double>::infinity();
+	double maxValue = -numeric_limits<double>::infinity();
+	double mean = 0.0;
+	double shift = 0.0;
+	double scale = 1.0;
+
+	// 合并另一段数据的第一遍统计量（按整个矩阵归一化时使用）
+	void merge(const NormStats& other)
+	{
+		n += other.n;
+		sum += other.sum;
+		sq += other.sq;
+		minValue = std::min(minValue, other.minValue);
+		maxValue = std::max(maxValue, other.maxValue);
+	}
+};
+
+// 归一化内核，方法在编译期确定，内层循环没有分支派发。
+// 计算顺序与 BCarray::normalize_ 相同（均值 = 和 / n，先减后除），按行或按列时结果逐位一致
+template <NormMethod M>
+struct NormKernel
+{
+	static const bool twoPass = (M == NormMethod::ZScore);
+
+	static void first(NormStats& s, double x)
+	{
+		if constexpr (M == NormMethod::L2)
+		{
+			s.sq += x * x;
+		}
+		else if constexpr (M == NormMethod::MinMax)
+		{
+			if (x < s.minValue)
+				s.minValue = x;
+			if (x > s.maxValue)
+				s.maxValue = x;
+		}
+		else
+		{
+			s.sum += x;
+		}
+	}
+
+	// 第一遍结束后调用
+	static void prepare(NormStats& s)
+	{
+		if (s.n == 0)
+		{
+			throw invalid_argument("Vector is empty");
+		}
+		if constexpr (M == NormMethod::ZScore || M == NormMethod::Centralize)
+		{
+			s.mean = s.sum / s.n;
+			s.sq = 0.0;
+		}
+	}
+
+	static void second(NormStats& s, double x)
+	{
+		double d = x - s.mean;
+		s.sq += d * d;
+	}
+
+	// 全部统计量就绪后，算出 shift / scale 并检查退化情况
+	static void finish(NormStats& s)
+	{
+		if constexpr (M == NormMethod::L2)
+		{
+			s.scale = sqrt(s.sq);
+			if (s.scale == 0)
+				throw runtime_error("Cannot normalize a zero vector.");
+		}
+		else if constexpr (M == NormMethod::MinMax)
+		{
+			if (s.maxValue == s.minValue)
+				throw runtime_error("Cannot normalize a vector with all identical values.");
+			s.shift = s.minValue;
+			s.scale = s.maxValue - s.minValue;
+		}
+		else if constexpr (M == NormMethod::ZScore)
+		{
+			s.shift = s.mean;
+			s.scale = sqrt(s.sq / s.n);
+			if (s.scale == 0)
+				throw runtime_error("Cannot normalize a vector with zero standard deviation.");
+		}
+		else
+		{
+			s.shift = s.mean;
+		}
+	}
+
+	static double apply(const NormStats& s, double x)
+	{
+		if constexpr (M == NormMethod::L2)
+			return x / s.scale;
+		else if constexpr (M == NormMethod::Centralize)
+			return x - s.shift;
+		else
+			return (x - s.shift) / s.scale;
+	}
+};
+
+template <NormMethod M>
+static void normalizeRows(vector<BCarray<double>>& value, size_t row, size_t column)
+{
+	using K = NormKernel<M>;
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			double* x = value[i].data();
+			NormStats s;
+			s.n = column;
+			for (size_t j = 0; j < column; j++)
+				K::first(s, x[j]);
+			K::prepare(s);
+			if (K::twoPass) {
+				for (size_t j = 0; j < column; j++)
+					K::second(s, x[j]);
+			}
+			K::finish(s);
+			for (size_t j = 0; j < column; j++)
+				x[j] = K::apply(s, x[j]);
+		}
+	}, std::max<size_t>(1, 16384 / std::max<size_t>(column, 1)));
+}
+
+template <NormMethod M>
+static void normalizeColumns(vector<BCarray<double>>& value, size_t row, size_t column)
+{
+	// 每个线程负责若干列，按 BLOCK 列一组逐行扫描，读一行就能更新一组列的统计量
+	using K = NormKernel<M>;
+	const size_t BLOCK = 64;
+	StatTools::parallelFor(0, column, [&](size_t lo, size_t hi) {
+		vector<NormStats> stats(BLOCK);
+		for (size_t j0 = lo; j0 < hi; j0 += BLOCK) {
+			size_t nb = std::min(BLOCK, hi - j0);
+			for (size_t b = 0; b < nb; b++) {
+				stats[b] = NormStats();
+				stats[b].n = row;
+			}
+			for (size_t i = 0; i < row; i++) {
+				const double* x = value[i].data() + j0;
+				for (size_t b = 0; b < nb; b++)
+					K::first(stats[b], x[b]);
+			}
+			for (size_t b = 0; b < nb; b++)
+				K::prepare(stats[b]);
+			if (K::twoPass) {
+				for (size_t i = 0; i < row; i++) {
+					const double* x = value[i].data() + j0;
+					for (size_t b = 0; b < nb; b++)
+						K::second(stats[b], x[b]);
+				}
+			}
+			for (size_t b = 0; b < nb; b++)
+				K::finish(stats[b]);
+			for (size_t i = 0; i < row; i++) {
+				double* x = value[i].data() + j0;
+				for (size_t b = 0; b < nb; b++)
+					x[b] = K::apply(stats[b], x[b]);
+			}
+		}
+	}, 8);
+}
+
+template <NormMethod M>
+static void normalizeAll(vector<BCarray<double>>& value, size_t row, size_t column)
+{
+	// 两遍扫描：各行并行求部分统计量再合并，然后并行写回，不需要拍平的副本
+	using K = NormKernel<M>;
+	const size_t minRows = std::max<size_t>(1, 16384 / std::max<size_t>(column, 1));
+	vector<NormStats> partial(row);
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			const double* x = value[i].data();
+			for (size_t j = 0; j < column; j++)
+				K::first(partial[i], x[j]);
+		}
+	}, minRows);
+	NormStats s;
+	for (size_t i = 0; i < row; i++)
+		s.merge(partial[i]);
+	s.n = row * column;
+	K::prepare(s);
+	if (K::twoPass) {
+		StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; i++) {
+				NormStats& p = partial[i];
+				p.mean = s.mean;
+				p.sq = 0.0;
+				const double* x = value[i].data();
+				for (size_t j = 0; j < column; j++)
+					K::second(p, x[j]);
+			}
+		}, minRows);
+		for (size_t i = 0; i < row; i++)
+			s.sq += partial[i].sq;
+	}
+	K::finish(s);
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			double* x = value[i].data();
+			for (size_t j = 0; j < column; j++)
+				x[j] = K::apply(s, x[j]);
+		}
+	}, minRows);
+}
+
+template <NormMethod M>
+static void normalizeImpl(vector<BCarray<double>>& value, size_t row, size_t column, NormAxis axis)
+{
+	switch (axis)
+	{
+	case NormAxis::Row:
+		normalizeRows<M>(value, row, column);
+		break;
+	case NormAxis::Column:
+		normalizeColumns<M>(value, row, column);
+		break;
+	default:
+		normalizeAll<M>(value, row, column);
+		break;
+	}
+}
+
+NormMethod BCmatrix::parseNormMethod(const string& method)
+{
+	if (method == "L2")
+		return NormMethod::L2;
+	if (method == "minmax")
+		return NormMethod::MinMax;
+	if (method == "zscore")
+		return NormMethod::ZScore;
+	if (method == "centralize")
+		return NormMethod::Centralize;
+	throw invalid_argument("only L2, minmax, and zscore are supported.");
+}
+
+NormAxis BCmatrix::parseNormAxis(const string& axis)
+{
+	if (axis == "row")
+		return NormAxis::Row;
+	if (axis == "column")
+		return NormAxis::Column;
+	if (axis == "all")
+		return NormAxis::All;
+	throw invalid_argument("normalize(): 'axis' 参数必须为 'row', 'column' 或 'all'");
+}
+
+void BCmatrix::normalize(const string& method, const string& axis)
+{
+	NormAxis ax = parseNormAxis(axis);
+	normalize(parseNormMethod(method), ax);
+}
+
+void BCmatrix::normalize(NormMethod method, NormAxis axis)
+{
+	switch (method)
+	{
+	case NormMethod::L2:
+		normalizeImpl<NormMethod::L2>(value, row, column, axis);
+		break;
+	case NormMethod::MinMax:
+		normalizeImpl<NormMethod::MinMax>(value, row, column, axis);
+		break;
+	case NormMethod::ZScore:
+		normalizeImpl<NormMethod::ZScore>(value, row, column, axis);
+		break;
+	case NormMethod::Centralize:
+		normalizeImpl<NormMethod::Centralize>(value, row, column, axis);
+		break;
+	}
+}
+
+// 各列之和（并行按列分段，每列仍按行顺序累加，结果与串行一致）
+static vector<double> columnSums(const vector<BCarray<double>>& value, size_t row, size_t column)
+{
+	vector<double> sums(column, 0.0);
+	StatTools::parallelFor(0, column, [&](size_t lo, size_t hi) {
+		for (size_t i = 0; i < row; i++) {
+			const double* x = value[i].data();
+			for (size_t j = lo; j < hi; j++)
+				sums[j] += x[j];
+		}
+	}, 8);
+	return sums;
+}
+
+// 每列乘以各自的系数
+static void scaleColumns(vector<BCarray<double>>& value, size_t row, size_t column, const vector<double>& factor)
+{
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			double* x = value[i].data();
+			for (size_t j = 0; j < column; j++)
+				x[j] *= factor[j];
+		}
+	}, std::max<size_t>(1, 16384 / std::max<size_t>(column, 1)));
+}
+
+// 把各列缩放到和为 1e6
+static void scaleToMillion(vector<BCarray<double>>& value, size_t row, size_t column, const char* who)
+{
+	vector<double> factor = columnSums(value, row, column);
+	for (size_t j = 0; j < column; j++) {
+		if (!(factor[j] > 0))
+			throw runtime_error(string(who) + ": 第 " + to_string(j) + " 列的总和不为正，无法缩放");
+		factor[j] = 1e6 / factor[j];
+	}
+	scaleColumns(value, row, column, factor);
+}
+
+void BCmatrix::quantileNormalize()
+{
+	if (row == 0 || column == 0)
+		return;
+	if (row > numeric_limits<uint32_t>::max())
+		throw invalid_argument("quantileNormalize: 行数过多");
+
+	// 1. 各列并行排序，记下每个秩对应的行号
+	struct Entry
+	{
+		double v;
+		uint32_t r;
+	};
+	vector<vector<Entry>> sorted(column);
+	StatTools::parallelFor(0, column, [&](size_t lo, size_t hi) {
+		for (size_t j = lo; j < hi; j++) {
+			vector<Entry>& col = sorted[j];
+			col.resize(row);
+			for (size_t i = 0; i < row; i++) {
+				double v = value[i][j];
+				if (std::isnan(v))
+					throw invalid_argument("quantileNormalize: 第 " + to_string(j) + " 列含有 NaN");
+				col[i] = Entry{ v, static_cast<uint32_t>(i) };
+			}
+			std::sort(col.begin(), col.end(), [](const Entry& a, const Entry& b) { return a.v < b.v; });
+		}
+	});
+
+	// 2. 同一秩在各列上的均值
+	vector<double> rankMean(row, 0.0);
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t k = lo; k < hi; k++) {
+			double sum = 0.0;
+			for (size_t j = 0; j < column; j++)
+				sum += sorted[j][k].v;
+			rankMean[k] = sum / column;
+		}
+	}, 1024);
+
+	// 3. 写回：同一列中并列的值取它们所占各秩均值的平均
+	StatTools::parallelFor(0, column, [&](size_t lo, size_t hi) {
+		for (size_t j = lo; j < hi; j++) {
+			const vector<Entry>& col = sorted[j];
+			for (size_t a = 0; a < row;) {
+				size_t b = a + 1;
+				double sum = rankMean[a];
+				while (b < row && col[b].v == col[a].v)
+					sum += rankMean[b++];
+				double v = sum / (b - a);
+				for (size_t k = a; k < b; k++)
+					value[col[k].r][j] = v;
+				a = b;
+			}
+		}
+	});
+}
+
+void BCmatrix::cpm()
+{
+	scaleToMillion(value, row, column, "cpm");
+}
+
+void BCmatrix::tpm(const vector<double>& geneLengths)
+{
+	if (geneLengths.size() != row)
+		throw invalid_argument("tpm: 基因长度的个数必须等于行数");
+	for (size_t i = 0; i < row; i++) {
+		if (!(geneLengths[i] > 0))
+			throw invalid_argument("tpm: 第 " + to_string(i) + " 个基因长度不为正");
+	}
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++)
+			value[i] /= geneLengths[i];
+	}, std::max<size_t>(1, 16384 / std::max<size_t>(column, 1)));
+	scaleToMillion(value, row, column, "tpm");
+}
+
+void BCmatrix::logTransform(double base, double pseudocount)
+{
+	if (!(base > 0) || base == 1)
+		throw invalid_argument("logTransform: base 必须为正且不等于 1");
+	if (pseudocount < 0)
+		throw invalid_argument("logTransform: pseudocount 不能为负");
+	const double invLogBase = 1.0 / std::log(base);
+	const bool useLog1p = (pseudocount == 1.0);
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			double* x = value[i].data();
+			if (useLog1p) {
+				for (size_t j = 0; j < column; j++)
+					x[j] = std::log1p(x[j]) * invLogBase;
+			}
+			else {
+				for (size_t j = 0; j < column; j++)
+					x[j] = std::log(x[j] + pseudocount) * invLogBase;
+			}
+		}
+	}, std::max<size_t>(1, 4096 / std::max<size_t>(column, 1)));
+}
+
+void BCmatrix::vst()
+{
+	if (row == 0 || column < 2)
+		throw invalid_argument("vst: 至少需要一个基因和两个样本");
+
+	vector<double> sf = StatTools::estimateSizeFactors(value);
+
+	// 先只统计不修改：每个基因归一化后的均值和矩估计 dispersion，拟合失败时矩阵保持原样
+	vector<double> mu(row), disp(row);
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			const double* x = value[i].data();
+			double sum = 0.0;
+			for (size_t j = 0; j < column; j++)
+				sum += x[j] / sf[j];
+			double m = sum / column;
+			double var = 0.0;
+			for (size_t j = 0; j < column; j++) {
+				double d = x[j] / sf[j] - m;
+				var += d * d;
+			}
+			var /= (column - 1);
+			mu[i] = m;
+			disp[i] = m > 0 ? std::max((var - m) / (m * m), 0.0) : 0.0;
+		}
+	}, 256);
+	StatTools::DispersionTrend trend = StatTools::fitDispersionTrend(disp, mu);
+
+	StatTools::parallelFor(0, row, [&](size_t lo, size_t hi) {
+		for (size_t i = lo; i < hi; i++) {
+			double* x = value[i].data();
+			for (size_t j = 0; j < column; j++)
+				x[j] = StatTools::vstTransform(x[j] / sf[j], trend);
+		}
+	}, 256);
+}
+
+// 可写的列访问器：按行跨步读写 value 的某一列，供 StatTools::pAdjust 原地使用
+struct ColumnRef
+{
+	vector<BCarray<double>>& rows;
+	size_t col;
+	size_t size() const { return rows.size(); }
+	double& operator[](size_t i) const { return rows[i][col]; }
+};
+
+// 把 p 值所在列做 BH 调整后写入 fdrColumn；NaN 不参与
+static void fillFdr(vector<BCarray<double>>& value, size_t pColumn, size_t fdrColumn)
+{
+	StatTools::pAdjust(ColumnRef{ value, pColumn }, ColumnRef{ value, fdrColumn }, StatTools::PAdjustMethod::BH);
+}
+
+void BCmatrix::adjustPValues(const string& pColumn, StatTools::PAdjustMethod method, const string& outColumn)
+{
+	int p = findColumn(pColumn);
+	if (p < 0)
+		throw invalid_argument("Column not found: " + pColumn);
+	if (outColumn.empty() || outColumn == pColumn)
+	{
+		StatTools::pAdjustInPlace(ColumnRef{ value, static_cast<size_t>(p) }, method);
+		return;
+	}
+	int out = findColumn(outColumn);
+	if (out < 0)
+	{
+		addColumn(BCarray<double>(row, 0.0), outColumn);
+		out = static_cast<int>(column) - 1;
+	}
+	StatTools::pAdjust(ColumnRef{ value, static_cast<size_t>(p) }, ColumnRef{ value, static_cast<size_t>(out) }, method);
+}
+
+BCmatrix BCmatrix::t_test()
+{
+	_checkColumnEqual(group.size());
+
+	// 所有基因一次批量计算：每行只读一遍，行间并行
+	vector<StatTools::t_testResult> tests = StatTools::t_testBatch(value, group);
+
+	BCmatrix result;
+	result.column = 4;
+	result.column_lst = { "log2_fc", "t", "p_value", "fdr_p_value" };
+	result.group = group;
+
+	result.row = row;
+	result.row_lst = row_lst;
+	result.value.assign(row, BCarray<double>(4, 0.0));
+
+	for (size_t i = 0; i < row; i++)
+	{
+		result.value[i][0] = tests[i].log2_fc;
+		result.value[i][1] = tests[i].t;
+		result.value[i][2] = tests[i].p_value;
+	}
+	// FDR调整；p 值为 NaN 的行（方差为 0 等）不参与排序，FDR 也记为 NaN
+	fillFdr(result.value, 2, 3);
+
+	return result;
+}
+
+BCmatrix BCmatrix::permutationTest(const StatTools::PermutationOptions& options)
+{
+	_checkColumnEqual(group.size());
+
+	StatTools::PermutationResult perm = StatTools::permutationTTest(value, group, options);
+
+	BCmatrix result;
+	result.column_lst = { "log2_fc", "t", "p_value", "fdr_p_value" };
+	if (options.maxT)
+		result.column_lst.push_back("maxT_p_value");
+	result.column_lst.push_back("permutations");
+	result.column = result.column_lst.size();
+	result.group = group;
+
+	result.row = row;
+	result.row_lst = row_lst;
+	result.value.assign(row, BCarray<double>(result.column, 0.0));
+
+	for (size_t i = 0; i < row; i++)
+	{
+		BCarray<double>& r = result.value[i];
+		r[0] = perm.log2_fc[i];
+		r[1] = perm.t[i];
+		r[2] = perm.p_value[i];
+		if (options.maxT)
+			r[4] = perm.maxT_p_value[i];
+		r[result.column - 1] = static_cast<double>(perm.permutations[i]);
+	}
+	fillFdr(result.value, 2, 3);
+
+	return result;
+}
+
+// 按 group 与协变量拟合线性模型，可选 eBayes
+static StatTools::LinearModelFit fitLinearModel(const vector<BCarray<double>>& value, const vector<int>& group, const vector<vector<double>>& covariates, bool moderated)
+{
+	StatTools::LinearModel model(StatTools::designMatrix(group, covariates));
+	StatTools::LinearModelFit fit = model.fit(value);
+	if (moderated)
+		StatTools::eBayes(fit);
+	return fit;
+}
+
+BCmatrix BCmatrix::limma(int level, int reference, const vector<vector<double>>& covariates, bool moderated)
+{
+	_checkColumnEqual(group.size());
+	vector<int> levels = StatTools::groupLevels(group);
+	auto coefficientOf = [&levels](int l) -> long {
+		auto it = lower_bound(levels.begin(), levels.end(), l);
+		if (it == levels.end() || *it != l)
+			throw invalid_argument("Group level not found.");
+		// 最小的水平是基线，没有对应系数
+		return static_cast<long>(it - levels.begin()) - 1;
+	};
+	long a = coefficientOf(level);
+	long b = coefficientOf(reference);
+	if (a == b)
+		throw invalid_argument("Level and reference must differ.");
+
+	StatTools::LinearModelFit fit = fitLinearModel(value, group, covariates, moderated);
+	vector<double> contrast(fit.coefficients, 0.0);
+	if (a >= 0)
+		contrast[a + 1] += 1.0;
+	if (b >= 0)
+		contrast[b + 1] -= 1.0;
+	StatTools::ContrastResult test = StatTools::contrastTest(fit, contrast);
+
+	BCmatrix result;
+	result.column = 4;
+	result.column_lst = { "log2_fc", "t", "p_value", "fdr_p_value" };
+	result.group = group;
+	result.row = row;
+	result.row_lst = row_lst;
+	result.value.assign(row, BCarray<double>(4, 0.0));
+	for (size_t i = 0; i < row; i++)
+	{
+		result.value[i][0] = test.estimate[i];
+		result.value[i][1] = test.t[i];
+		result.value[i][2] = test.p_value[i];
+	}
+	fillFdr(result.value, 2, 3);
+	return result;
+}
+
+BCmatrix BCmatrix::anova(const vector<vector<double>>& covariates, bool moderated)
+{
+	_checkColumnEqual(group.size());
+	vector<int> levels = StatTools::groupLevels(group);
+	if (levels.size() < 2)
+		throw invalid_argument("ANOVA needs at least 2 groups.");
+
+	StatTools::LinearModelFit fit = fitLinearModel(value, group, covariates, moderated);
+	// 每个非基线水平的系数都为 0
+	size_t q = levels.size() - 1;
+	vector<vector<double>> contrasts(q, vector<double>(fit.coefficients, 0.0));
+	for (size_t k = 0; k < q; k++)
+		contrasts[k][k + 1] = 1.0;
+	StatTools::FTestResult test = StatTools::fTest(fit, contrasts);
+
+	BCmatrix result;
+	for (size_t k = 0; k < q; k++)
+		result.column_lst.push_back("coef_" + to_string(levels[k + 1]));
+	result.column_lst.push_back("F");
+	result.column_lst.push_back("p_value");
+	result.column_lst.push_back("fdr_p_value");
+	result.column = result.column_lst.size();
+	result.group = group;
+	result.row = row;
+	result.row_lst = row_lst;
+	result.value.assign(row, BCarray<double>(result.column, 0.0));
+	for (size_t i = 0; i < row; i++)
+	{
+		for (size_t k = 0; k < q; k++)
+			result.value[i][k] = fit.coef[i * fit.coefficients + k + 1];
+		result.value[i][q] = test.F[i];
+		result.value[i][q + 1] = test.p_value[i];
+	}
+	fillFdr(result.value, q + 1, q + 2);
+	return result;
+}
+
+BCmatrix BCmatrix::deseq2()
+{
+	BCmatrix result;
+	// log2FC, pvalue, padj，以及 DESeq2 结果表中的其余各列
+	result.column = 7;
+	result.column_lst = { "log2FC", "pvalue", "padj", "baseMean", "lfcSE", "stat", "dispersion" };
+	result.group = this->group;
+
+	// 直接在 BCmatrix 的行存储上计算，不复制计数矩阵
+	size_t G = this->row;
+	vector<StatTools::DESeq2Result> deRes = StatTools::performDESeq2(value, this->group);
+
+	// 将结果写入新的 BCmatrix
+	result.row = G;
+	result.row_lst = this->row_lst;
+	result.value.assign(G, BCarray<double>(7, 0.0));
+	for (size_t i = 0; i < G; i++) {
+		result.value[i][0] = deRes[i].log2FC;
+		result.value[i][1] = deRes[i].pvalue;
+		result.value[i][2] = deRes[i].padj;
+		result.value[i][3] = deRes[i].baseMean;
+		result.value[i][4] = deRes[i].lfcSE;
+		result.value[i][5] = deRes[i].stat;
+		result.value[i][6] = deRes[i].dispersion;
+	}
+
+	return result;
+}
+
+vector<vector<double>> BCmatrix::values() const
+{
+	return getPureValue();
+}
+
+// 超过该行数时 performPCA 按行块流式计算
+static const size_t PCA_STREAM_ROWS = 65536;
+// 流式 PCA 每块的行数
+static const size_t PCA_BLOCK_ROWS = 512;
+
+BCmatrix BCmatrix::_componentMatrix(const vector<string>& rowNames, const StatTools::DenseMatrix& scores, const string& prefix)
+{
+	BCmatrix result;
+	result.row = scores.rows;
+	result.column = scores.cols;
+	result.row_lst = rowNames;
+	for (size_t j = 0; j < scores.cols; j++) {
+		result.column_lst.push_back(prefix + to_string(j + 1));
+	}
+
+	result.value.reserve(scores.rows);
+	for (size_t i = 0; i < scores.rows; i++) {
+		BCarray<double> r(scores.cols, 0.0, true);
+		copy(scores.row(i), scores.row(i) + scores.cols, r.begin());
+		result.value.push_back(move(r));
+	}
+	return result;
+}
+
+// 把 [first, first + count) 行复制到 out（count × column，行优先）
+static void copyRows(const vector<BCarray<double>>& value, size_t first, size_t count, size_t column, double* out)
+{
+	for (size_t i = 0; i < count; i++)
+		copy(value[first + i].begin(), value[first + i].end(), out + i * column);
+}
+
+StatTools::PCAModel BCmatrix::fitPCA(int num_components) const
+{
+	if (num_components < 1)
+		throw invalid_argument("The number of components must be positive.");
+	if (row > PCA_STREAM_ROWS)
+	{
+		// 每块从各行的连续存储直接复制，不经过 getPureValue 的整表拷贝
+		auto res = StatTools::streamingPCA(row, column, static_cast<size_t>(num_components),
+			[this](size_t first, size_t count, double* out) {
+				copyRows(value, first, count, column, out);
+			}, PCA_BLOCK_ROWS, true, false);
+		return StatTools::PCAModel(res);
+	}
+
+	StatTools::DenseMatrix data(row, column);
+	copyRows(value, 0, row, column, data.data.data());
+	StatTools::PCAModel model(static_cast<size_t>(num_components));
+	model.fit(data);
+	return model;
+}
+
+BCmatrix BCmatrix::transformPCA(const StatTools::PCAModel& model) const
+{
+	StatTools::DenseMatrix scores(row, model.components());
+	StatTools::DenseMatrix block;
+	for (size_t first = 0; first < row; first += PCA_BLOCK_ROWS)
+	{
+		size_t count = min(PCA_BLOCK_ROWS, row - first);
+		block = StatTools::DenseMatrix(count, column);
+		copyRows(value, first, count, column, block.data.data());
+		auto s = model.transform(block);
+		copy(s.data.begin(), s.data.end(), scores.row(first));
+	}
+	return _componentMatrix(row_lst, scores);
+}
+
+BCmatrix BCmatrix::performPCA(int num_components) const
+{
+	return transformPCA(fitPCA(num_components));
+}
+
+BCmatrix BCmatrix::performPCAFromBinary(const string& filename, int num_components, size_t block_rows)
+{
+	if (num_components < 1)
+		throw invalid_argument("The number of components must be positive.");
+	BCmatrixFile file(filename);
+	auto res = StatTools::streamingPCA(file.rows(), file.columns(), static_cast<size_t>(num_components),
+		[&file](size_t first, size_t count, double* out) {
+			file.readRows(first, count, out);
+		}, block_rows);
+	return _componentMatrix(file.rowNames(), res.scores);
+}
+
+BCmatrix BCmatrix::performLLE(int n_neighbors, int dim, double reg) const {
+	auto data = this->getPureValue();
+	auto transformed = StatTools::performLLE(data, n_neighbors, dim, reg);
+
+	BCmatrix result(this->getRowCount(), static_cast<size_t>(dim));
+
+	result.row_lst = this->row_lst;
+	result.column_lst.clear();
+	for (int j = 0; j < dim; j++) {
+		result.column_lst.push_back("lle_" + to_string(j + 1));
+	}
+
+	result.value.clear();
+	result.value.reserve(transformed.size());
+	for (size_t i = 0; i < transformed.size(); i++) {
+		result.value.emplace_back(transformed[i], true);
+	}
+	return result;
+}
+
+BCmatrix BCmatrix::performTSNE(int dim, double perplexity, int max_iter, double lr) const
+{
+	if (row == 0)
+		throw invalid_argument("Input data X is empty.");
+	if (dim < 1 || max_iter < 0)
+		throw invalid_argument("Invalid input to performTSNE");
+	StatTools::TSNEOptions options;
+	options.dim = static_cast<size_t>(dim);
+	options.perplexity = perplexity;
+	options.maxIter = static_cast<size_t>(max_iter);
+	options.learningRate = lr;
+
+	StatTools::DenseMatrix data(row, column);
+	copyRows(value, 0, row, column, data.data.data());
+	return _componentMatrix(row_lst, StatTools::tsne(data, options), "tsne_");
+}
+
+BCmatrix BCmatrix::describe(const string& axis) const
+{
+	static const vector<string> metrics = {
+		"count", "mean", "std", "min", "25%", "50%", "75%", "max",
+		"skewness", "kurtosis", "mode"
+	};
+	const size_t M = metrics.size();
+
+	// 统计方向
+	size_t N;
+	bool byColumn;
+	if (axis == "column") {
+		N = this->column;
+		byColumn = true;
+	}
+	else if (axis == "row") {
+		N = this->row;
+		byColumn = false;
+	}
+	else {
+		throw invalid_argument("describe: axis 必须是 'row' 或 'column'");
+	}
+
+	BCmatrix result(M, N);
+	result.row_lst = metrics;
+	result.column_lst = byColumn ? this->column_lst : this->row_lst;
+
+	// 每个线程处理一段列（或行）：先把数据取到自己的缓冲区，再用 summarize 一次算出全部指标。
+	// 按列统计时一次取 COL_BLOCK 列，读一遍行就能填满几列的缓冲区，减少跨行的跳跃访问
+	const size_t COL_BLOCK = 8;
+	const size_t len = byColumn ? this->row : this->column;
+	auto store = [&result](size_t j, const StatTools::Summary& s) {
+		const double v[] = {
+			static_cast<double>(s.count), s.mean, s.sampleStd, s.min, s.q25, s.q50, s.q75, s.max,
+			s.skewness, s.kurtosis, s.mode
+		};
+		for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++)
+			result.value[i][j] = v[i];
+	};
+	StatTools::parallelFor(0, N, [&](size_t lo, size_t hi) {
+		vector<vector<double>> bufs(byColumn ? COL_BLOCK : 1);
+		for (auto& buf : bufs)
+			buf.reserve(len);
+		for (size_t j0 = lo; j0 < hi; j0 += bufs.size()) {
+			size_t nb = std::min(bufs.size(), hi - j0);
+			if (byColumn) {
+				for (size_t b = 0; b < nb; b++)
+					bufs[b].resize(len);
+				for (size_t r = 0; r < len; r++) {
+					const double* src = this->value[r].data() + j0;
+					for (size_t b = 0; b < nb; b++)
+						bufs[b][r] = src[b];
+				}
+			}
+			else {
+				RowView view = this->rowView(j0);
+				bufs[0].assign(view.begin(), view.end());
+			}
+			for (size_t b = 0; b < nb; b++)
+				store(j0 + b, StatTools::summarize(bufs[b]));
+		}
+	}, byColumn ? COL_BLOCK : 16);
+
+	return result;
+}
+
+
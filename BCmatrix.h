@@ -1,129 +1,353 @@
-﻿#pragma once
-
-#include "stdafx.h"
-#ifndef BCMATRIX_H
-#define BCMATRIX_H
-
-#include <iostream>
-using namespace std;
-#include <vector>
-#include "BCarray.h"
-#include <fstream>
-#include <sstream>
-
-class BCmatrix
-{
-private:
-	size_t row;
-	size_t column;
-	vector<string> row_lst;
-	vector<string> column_lst;
-	vector<BCarray<double>> value;
-	// 用来划分实验组和对照组
-	vector<int> group;
-
-	// 检查行数/列数是否相等
-	void _checkRowEqual(int size) const;
-	void _checkColumnEqual(int size) const;
-
-	// 检查行/列索引是否越界
-	void _checkRowRange(int index) const;
-	void _checkColumnRange(int index) const;
-
-public:
-	BCmatrix();
-	BCmatrix(size_t row, size_t column);
-
-	// 得到value和group
-	vector<BCarray<double>> getValue() const;
-	vector<vector<double>> getPureValue() const;
-	vector<int> getGroup() const;
-
-	// 获取行数和列数
-	int getRowCount() const;
-	int getColumnCount() const;
-	pair<int, int> getShape() const;
-
-	// 获取行名和列名
-	vector<string> getRowName() const;
-	vector<string> getColumnName() const;
-
-	// 获取行和列
-	BCarray<double> getRow(size_t row) const;
-	BCmatrix sliceRows(size_t start_index, size_t end_index) const; // 用来取特定的行数
-	BCarray<double> getColumn(size_t column) const;
-
-	// 根据行和列索引获取元素
-	double& iloc(size_t row, size_t column);
-	double iloc(size_t row, size_t column) const;
-
-	// 根据行名和列名获取索引
-	int findRow(string rowName) const;
-	int findColumn(string columnName) const;
-
-	// 根据行名和列名获取元素
-	double& loc(string rowName, string columnName);
-	double loc(string rowName, string columnName) const;
-
-	// 重载()，根据行列索引/名 获得元素
-	double& operator()(size_t row, size_t column);
-	double operator()(size_t row, size_t column) const;
-	double& operator()(string rowName, string columnName);
-	double operator()(string rowName, string columnName) const;
-
-	// 重载()，根据行列索引/名 获得行/列
-	// mod = 'r' 表示获取行，mod = 'c' 表示获取列
-	BCarray<double> operator()(size_t index, char mod = 'r') const;
-	BCarray<double> operator()(string name, char mod = 'r') const;
-
-	// 设置行名和列名
-	void setRowName(size_t index, string name);
-	void setColumnName(size_t index, string name);
-
-	// 删除行和列
-	void deleteRow(size_t index);
-	void deleteColumn(size_t index);
-
-	// 添加行和列
-	void addRow(const BCarray<double>& newRow, string name = "");
-	void addColumn(const BCarray<double>& newColumn, string name = "");
-
-	// 实现和标量的四则运算
-	BCmatrix operator+(const double& scalar);
-	BCmatrix operator-(const double& scalar);
-	BCmatrix operator*(const double& scalar);
-	BCmatrix operator/(const double& scalar);
-
-	// 实现和向量的四则运算（注意行向量和列向量）
-	BCmatrix operator+(const BCarray<double>& vec);
-	BCmatrix operator-(const BCarray<double>& vec);
-	BCmatrix operator*(const BCarray<double>& vec);
-	BCmatrix operator/(const BCarray<double>& vec);
-
-	// 用于清空和加载新的数据
-	void clear();
-	void load_data(const string& filename);
-	void load_group(const string& filename);
-	void set_group(const vector<int> gp);
-	// 导出数据
-	void to_csv(const string& filename) const;
-	vector<vector<double>> values() const;
-
-	// 数据归一化
-	void normalize(const string& method = "zscore", const string& axis = "column");
-
-	// 进行t-test
-	BCmatrix t_test();
-	BCmatrix deseq2();
-
-	// 降维
-	BCmatrix performPCA(int num_components = 2) const;
-	BCmatrix performLLE(int n_neighbors, int dim, double reg = 1e-3) const;
-	BCmatrix performTSNE(int dim = 2, double perplexity = 30.0, int max_iter = 1000, double lr = 200.0) const;
-
-	// 描述
-	BCmatrix describe(const string& axis = "column") const;
-
-};
-
-#endif
+﻿#pragma once
+
+#include "stdafx.h"
+#ifndef BCMATRIX_H
+#define BCMATRIX_H
+
+#include <iostream>
+using namespace std;
+#include <vector>
+#include "BCarray.h"
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <unordered_map>
+
+/**
+ * 行视图：不拥有数据，直接指向矩阵某一行的连续存储。
+ * 矩阵被修改形状（增删行列、clear、重新加载）后视图失效。
+ */
+class RowView
+{
+private:
+	const double* ptr;
+	size_t len;
+
+public:
+	RowView(const double* data, size_t size) : ptr(data), len(size) {}
+
+	size_t size() const { return len; }
+	bool empty() const { return len == 0; }
+	const double& operator[](size_t index) const { return ptr[index]; }
+	const double* data() const { return ptr; }
+	const double* begin() const { return ptr; }
+	const double* end() const { return ptr + len; }
+
+	// 需要独立副本时再显式拷贝
+	BCarray<double> toArray() const
+	{
+		BCarray<double> res;
+		res.assign(ptr, ptr + len);
+		return res;
+	}
+};
+
+/**
+ * 列视图：不拥有数据，按行跨步访问矩阵的某一列。
+ * 失效规则与 RowView 相同。
+ */
+class ColumnView
+{
+private:
+	const BCarray<double>* rows;
+	size_t len;
+	size_t col;
+
+public:
+	class const_iterator
+	{
+	private:
+		const BCarray<double>* row;
+		size_t col;
+
+	public:
+		using iterator_category = forward_iterator_tag;
+		using value_type = double;
+		using difference_type = ptrdiff_t;
+		using pointer = const double*;
+		using reference = const double&;
+
+		const_iterator(const BCarray<double>* row, size_t col) : row(row), col(col) {}
+
+		reference operator*() const { return (*row)[col]; }
+		const_iterator& operator++() { ++row; return *this; }
+		const_iterator operator++(int) { const_iterator tmp(*this); ++row; return tmp; }
+		bool operator==(const const_iterator& other) const { return row == other.row; }
+		bool operator!=(const const_iterator& other) const { return row != other.row; }
+	};
+
+	ColumnView(const BCarray<double>* rows, size_t size, size_t column) : rows(rows), len(size), col(column) {}
+
+	size_t size() const { return len; }
+	bool empty() const { return len == 0; }
+	const double& operator[](size_t index) const { return rows[index][col]; }
+	const_iterator begin() const { return const_iterator(rows, col); }
+	const_iterator end() const { return const_iterator(rows + len, col); }
+
+	// 需要独立副本时再显式拷贝
+	BCarray<double> toArray() const
+	{
+		BCarray<double> res(len, 0.0, false);
+		for (size_t i = 0; i < len; i++)
+			res[i] = rows[i][col];
+		return res;
+	}
+};
+
+// 归一化方法，每组数据（一行、一列或整个矩阵）做 x' = (x - shift) / scale 的变换
+enum class NormMethod
+{
+	L2,         // x / ||x||
+	MinMax,     // (x - min) / (max - min)
+	ZScore,     // (x - mean) / std，std 为总体标准差
+	Centralize  // x - mean
+};
+
+// 归一化方向
+enum class NormAxis
+{
+	Row,
+	Column,
+	All
+};
+
+class BCmatrix
+{
+private:
+	size_t row = 0;
+	size_t column = 0;
+	vector<string> row_lst;
+	vector<string> column_lst;
+	vector<BCarray<double>> value;
+	// 用来划分实验组和对照组
+	vector<int> group;
+
+	// 名字 -> 索引 的哈希索引：第一次查找时才建立，增删改名时同步维护或标记失效。
+	// 有重名时与线性查找一致，返回第一次出现的位置
+	class NameIndex
+	{
+	private:
+		unordered_map<string, size_t> map;
+		bool valid = false;
+		bool hasDuplicates = false;
+
+	public:
+		int find(const vector<string>& names, const string& name);
+		void append(const string& name, size_t index);
+		void rename(size_t index, const string& oldName, const string& newName);
+		void erase(size_t index, const string& name, size_t newSize);
+		void invalidate();
+	};
+	mutable NameIndex row_index;
+	mutable NameIndex column_index;
+
+	// 检查行数/列数是否相等
+	void _checkRowEqual(int size) const;
+	void _checkColumnEqual(int size) const;
+
+	// 检查行/列索引是否越界
+	void _checkRowRange(int index) const;
+	void _checkColumnRange(int index) const;
+
+	// 对矩阵表达式求值并写入自身，行名、列名和分组取自表达式最左侧的矩阵
+	template <typename E>
+	void _assignExpr(const E& e);
+
+	// 由降维结果构造矩阵，列名为 prefix 加序号（component_1, component_2, ...）
+	static BCmatrix _componentMatrix(const vector<string>& rowNames, const StatTools::DenseMatrix& scores, const string& prefix = "component_");
+
+public:
+	BCmatrix();
+	BCmatrix(size_t row, size_t column);
+
+	BCmatrix(const BCmatrix&) = default;
+	BCmatrix(BCmatrix&&) = default;
+	BCmatrix& operator=(const BCmatrix&) = default;
+	BCmatrix& operator=(BCmatrix&&) = default;
+
+	// 由矩阵表达式求值，例如 BCmatrix z = (m - mean) / sd;
+	template <typename E>
+	BCmatrix(const BCexpr::MatrixExpr<E>& expr);
+	template <typename E>
+	BCmatrix& operator=(const BCexpr::MatrixExpr<E>& expr);
+
+	// 得到value和group（返回常引用，不再拷贝）
+	const vector<BCarray<double>>& getValue() const;
+	vector<vector<double>> getPureValue() const;
+	const vector<int>& getGroup() const;
+
+	// 获取行数和列数
+	int getRowCount() const;
+	int getColumnCount() const;
+	pair<int, int> getShape() const;
+
+	// 获取行名和列名
+	const vector<string>& getRowName() const;
+	const vector<string>& getColumnName() const;
+
+	// 获取行和列
+	BCarray<double> getRow(size_t row) const;
+	BCmatrix sliceRows(size_t start_index, size_t end_index) const; // 用来取特定的行数
+	BCarray<double> getColumn(size_t column) const;
+
+	// 获取行/列的只读视图（不拷贝）
+	RowView rowView(size_t row) const;
+	ColumnView columnView(size_t column) const;
+
+	// 根据行和列索引获取元素
+	double& iloc(size_t row, size_t column);
+	double iloc(size_t row, size_t column) const;
+
+	// 根据行名和列名获取索引（哈希查找，找不到返回 -1）
+	int findRow(const string& rowName) const;
+	int findColumn(const string& columnName) const;
+	// 批量查找行索引
+	vector<int> findRows(const vector<string>& rowNames) const;
+
+	// 根据行名和列名获取元素
+	double& loc(const string& rowName, const string& columnName);
+	double loc(const string& rowName, const string& columnName) const;
+	// 按行名批量取出若干行（顺序与 rowNames 一致），常用于提取基因集
+	BCmatrix locRows(const vector<string>& rowNames) const;
+
+	// 重载()，根据行列索引/名 获得元素
+	double& operator()(size_t row, size_t column);
+	double operator()(size_t row, size_t column) const;
+	double& operator()(string rowName, string columnName);
+	double operator()(string rowName, string columnName) const;
+
+	// 重载()，根据行列索引/名 获得行/列
+	// mod = 'r' 表示获取行，mod = 'c' 表示获取列
+	BCarray<double> operator()(size_t index, char mod = 'r') const;
+	BCarray<double> operator()(string name, char mod = 'r') const;
+
+	// 设置行名和列名
+	void setRowName(size_t index, string name);
+	void setColumnName(size_t index, string name);
+
+	// 删除行和列
+	void deleteRow(size_t index);
+	void deleteColumn(size_t index);
+
+	// 添加行和列
+	void addRow(const BCarray<double>& newRow, string name = "");
+	void addColumn(const BCarray<double>& newColumn, string name = "");
+
+	// 和标量、向量（注意行向量和列向量）、矩阵的四则运算见 BCexpr.h，结果为惰性求值的表达式
+
+	// 用于清空和加载新的数据
+	void clear();
+	void load_data(const string& filename);
+	void load_group(const string& filename);
+	void set_group(const vector<int> gp);
+	// 导出数据。precision < 0 时输出能精确还原的最短表示，否则按有效数字位数输出
+	void to_csv(const string& filename, int precision = -1) const;
+	// 二进制列式格式（.bcm），读写远快于 CSV；compress 为 true 时压缩能变小的列
+	void save_binary(const string& filename, bool compress = false) const;
+	void load_binary(const string& filename);
+	vector<vector<double>> values() const;
+
+	// 数据归一化（原地、多线程）。method 为 L2 / minmax / zscore / centralize，axis 为 row / column / all
+	void normalize(const string& method = "zscore", const string& axis = "column");
+	void normalize(NormMethod method, NormAxis axis = NormAxis::Column);
+	static NormMethod parseNormMethod(const string& method);
+	static NormAxis parseNormAxis(const string& axis);
+
+	// RNA-seq 常用的样本（列）级变换，均为原地、多线程
+	// 分位数标准化：各列排序后用同秩均值替换，并列值取其秩均值的平均
+	void quantileNormalize();
+	// 每百万计数：x / 列和 * 1e6
+	void cpm();
+	// 每百万转录本：先除以基因长度（与行一一对应，单位任意），再按列缩放到和为 1e6
+	void tpm(const vector<double>& geneLengths);
+	// log(x + pseudocount) / log(base)；默认即 log2(x + 1)，base 取 e 且 pseudocount 为 1 时为 log1p
+	void logTransform(double base = 2.0, double pseudocount = 1.0);
+	// 方差稳定变换：median-of-ratios size factor 归一化后，按参数化 dispersion 趋势变换到 log2 尺度
+	void vst();
+
+	// 进行t-test
+	BCmatrix t_test();
+	// 置换检验：打乱 group 标签重新计算 Welch t，给出置换 p 值（可选 max-T 校正）
+	BCmatrix permutationTest(const StatTools::PermutationOptions& options = StatTools::PermutationOptions());
+	// 线性模型（limma）：group 可以有多个水平，covariates 为每个样本的协变量（每个长度等于列数）
+	// 检验 level 与 reference 两个水平之差，log2_fc = level - reference；moderated 为 true 时做 eBayes 方差收缩
+	BCmatrix limma(int level = 1, int reference = 0, const vector<vector<double>>& covariates = {}, bool moderated = true);
+	// 单因素方差分析：所有分组效应的联合 F 检验，可带协变量
+	BCmatrix anova(const vector<vector<double>>& covariates = {}, bool moderated = true);
+	// 对 p 值列做多重检验校正，直接在列上读写：outColumn 为空或与 pColumn 相同时原地覆盖，不存在时新增一列
+	void adjustPValues(const string& pColumn, StatTools::PAdjustMethod method = StatTools::PAdjustMethod::BH, const string& outColumn = "");
+	BCmatrix deseq2();
+
+	// 降维
+	// 行数超过 PCA_STREAM_ROWS 时按行块做增量 PCA，不再复制整个矩阵
+	BCmatrix performPCA(int num_components = 2) const;
+	// 拟合 PCA 模型（均值、尺度、载荷、解释方差），可保存后用于投影新的样本
+	StatTools::PCAModel fitPCA(int num_components = 2) const;
+	// 按行块把各行投影到已拟合的主成分上，列数必须与模型的特征数一致
+	BCmatrix transformPCA(const StatTools::PCAModel& model) const;
+	// 直接对二进制文件（.bcm）按行块做增量 PCA，内存只与块大小和主成分数有关（压缩列每块都要整列解码，宜用未压缩文件）
+	static BCmatrix performPCAFromBinary(const string& filename, int num_components = 2, size_t block_rows = 512);
+	BCmatrix performLLE(int n_neighbors, int dim, double reg = 1e-3) const;
+	BCmatrix performTSNE(int dim = 2, double perplexity = 30.0, int max_iter = 1000, double lr = 200.0) const;
+
+	// 描述
+	BCmatrix describe(const string& axis = "column") const;
+
+};
+
+template <typename E>
+BCmatrix::BCmatrix(const BCexpr::MatrixExpr<E>& expr)
+{
+	_assignExpr(expr.self());
+}
+
+template <typename E>
+BCmatrix& BCmatrix::operator=(const BCexpr::MatrixExpr<E>& expr)
+{
+	_assignExpr(expr.self());
+	return *this;
+}
+
+template <typename E>
+void BCmatrix::_assignExpr(const E& e)
+{
+	const size_t nr = e.rows();
+	const size_t nc = e.columns();
+	const BCmatrix* src = e.source();
+
+	// 形状不变时逐元素原地写回（表达式只在同一位置读写，引用自身也安全），否则写到新存储再交换
+	vector<BCarray<double>> fresh;
+	bool inPlace = (row == nr && column == nc && value.size() == nr);
+	if (!inPlace)
+	{
+		fresh.assign(nr, BCarray<double>(nc));
+	}
+	vector<BCarray<double>>& target = inPlace ? value : fresh;
+	StatTools::parallelFor(0, nr, [&](size_t lo, size_t hi)
+		{
+			for (size_t i = lo; i < hi; i++)
+			{
+				auto r = e.row(i);
+				double* out = target[i].data();
+				for (size_t j = 0; j < nc; j++)
+					out[j] = r[j];
+			}
+		}, nc == 0 ? nr : std::max<size_t>(1, 32768 / nc));
+
+	if (!inPlace)
+	{
+		value.swap(fresh);
+		row = nr;
+		column = nc;
+	}
+	if (src != this)
+	{
+		row_lst = src->row_lst;
+		column_lst = src->column_lst;
+		group = src->group;
+		row_index.invalidate();
+		column_index.invalidate();
+	}
+}
+
+#endif
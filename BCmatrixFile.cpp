@@ -0,0 +1,399 @@
+﻿#include "stdafx.h"
+#include "BCmatrixFile.h"
+#include "BCmatrix.h"
+#include "ST.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+static const char MAGIC[8] = { 'B', 'C', 'M', 'A', 'T', 'R', 'I', 'X' };
+static const uint32_t FORMAT_VERSION = 1;
+static const uint32_t DTYPE_FLOAT64 = 1;
+static const uint64_t ALIGNMENT = 64;
+
+#pragma pack(push, 1)
+struct BinaryHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t dtype;
+	uint64_t rows;
+	uint64_t columns;
+	uint32_t compression;
+	uint32_t alignment;
+	uint64_t rowNamesOffset;
+	uint64_t columnNamesOffset;
+	uint64_t groupOffset; // 0 表示没有分组信息
+	uint64_t directoryOffset;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(BinaryHeader) == 72, "BinaryHeader must be 72 bytes");
+
+// 字节重排：把 n 个 double 的第 k 个字节放在一起，指数位相同的数据会形成长游程
+static void shuffleBytes(const double* in, size_t n, vector<uint8_t>& out)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(in);
+	out.resize(n * sizeof(double));
+	for (size_t i = 0; i < n; i++)
+		for (size_t k = 0; k < sizeof(double); k++)
+			out[k * n + i] = bytes[i * sizeof(double) + k];
+}
+
+static void unshuffleBytes(const uint8_t* in, size_t n, double* out)
+{
+	uint8_t* bytes = reinterpret_cast<uint8_t*>(out);
+	for (size_t k = 0; k < sizeof(double); k++)
+		for (size_t i = 0; i < n; i++)
+			bytes[i * sizeof(double) + k] = in[k * n + i];
+}
+
+// PackBits 编码：控制字节 0..127 表示后面跟 c+1 个原样字节，128..255 表示下一个字节重复 c-125 次
+static void packBits(const vector<uint8_t>& in, vector<uint8_t>& out)
+{
+	out.clear();
+	size_t n = in.size();
+	size_t i = 0;
+	while (i < n)
+	{
+		size_t run = 1;
+		while (i + run < n && run < 130 && in[i + run] == in[i])
+			run++;
+		if (run >= 3)
+		{
+			out.push_back(static_cast<uint8_t>(run - 3 + 128));
+			out.push_back(in[i]);
+			i += run;
+			continue;
+		}
+
+		size_t start = i;
+		size_t len = 0;
+		while (i < n && len < 128)
+		{
+			if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2])
+				break;
+			i++;
+			len++;
+		}
+		out.push_back(static_cast<uint8_t>(len - 1));
+		out.insert(out.end(), in.begin() + start, in.begin() + start + len);
+	}
+}
+
+static void unpackBits(const uint8_t* in, size_t inBytes, vector<uint8_t>& out, size_t expected)
+{
+	out.clear();
+	out.reserve(expected);
+	size_t i = 0;
+	while (i < inBytes)
+	{
+		uint8_t c = in[i++];
+		if (c < 128)
+		{
+			size_t len = c + 1;
+			if (i + len > inBytes || out.size() + len > expected)
+				throw runtime_error("load_binary: 压缩列数据损坏");
+			out.insert(out.end(), in + i, in + i + len);
+			i += len;
+		}
+		else
+		{
+			size_t len = c - 125;
+			if (i >= inBytes || out.size() + len > expected)
+				throw runtime_error("load_binary: 压缩列数据损坏");
+			out.insert(out.end(), len, in[i++]);
+		}
+	}
+	if (out.size() != expected)
+		throw runtime_error("load_binary: 压缩列数据损坏");
+}
+
+static void writeName(ofstream& out, const string& name)
+{
+	uint32_t len = static_cast<uint32_t>(name.size());
+	out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+	out.write(name.data(), len);
+}
+
+static void padTo(ofstream& out, uint64_t alignment)
+{
+	static const char zeros[ALIGNMENT] = {};
+	uint64_t pos = static_cast<uint64_t>(out.tellp());
+	uint64_t pad = (alignment - pos % alignment) % alignment;
+	out.write(zeros, static_cast<streamsize>(pad));
+}
+
+BCmatrixFile::BCmatrixFile() : rows_(0), columns_(0) {}
+
+BCmatrixFile::BCmatrixFile(const string& filename) : BCmatrixFile()
+{
+	open(filename);
+}
+
+void BCmatrixFile::open(const string& filename)
+{
+	file_.open(filename);
+	filename_ = filename;
+	const char* base = file_.data();
+	size_t size = file_.size();
+
+	auto corrupt = [&filename](const string& what)
+		{
+			return runtime_error("load_binary: 文件 \"" + filename + "\" 损坏（" + what + "）");
+		};
+
+	if (size < sizeof(BinaryHeader))
+		throw corrupt("文件头不完整");
+	BinaryHeader header;
+	memcpy(&header, base, sizeof(header));
+	if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+		throw runtime_error("load_binary: \"" + filename + "\" 不是 BCmatrix 二进制文件");
+	if (header.version != FORMAT_VERSION)
+		throw runtime_error("load_binary: 不支持的文件版本 " + to_string(header.version));
+	if (header.dtype != DTYPE_FLOAT64)
+		throw runtime_error("load_binary: 不支持的数据类型 " + to_string(header.dtype));
+
+	rows_ = static_cast<size_t>(header.rows);
+	columns_ = static_cast<size_t>(header.columns);
+
+	// 顺序解析名字块
+	auto readNames = [&](uint64_t offset, size_t count, vector<string>& names)
+		{
+			names.clear();
+			names.reserve(count);
+			size_t pos = static_cast<size_t>(offset);
+			for (size_t i = 0; i < count; i++)
+			{
+				uint32_t len;
+				if (pos + sizeof(len) > size)
+					throw corrupt("名字块越界");
+				memcpy(&len, base + pos, sizeof(len));
+				pos += sizeof(len);
+				if (pos + len > size)
+					throw corrupt("名字块越界");
+				names.emplace_back(base + pos, len);
+				pos += len;
+			}
+		};
+	readNames(header.rowNamesOffset, rows_, row_names_);
+	readNames(header.columnNamesOffset, columns_, column_names_);
+
+	group_.clear();
+	if (header.groupOffset != 0)
+	{
+		if (header.groupOffset + columns_ * sizeof(int32_t) > size)
+			throw corrupt("分组块越界");
+		group_.resize(columns_);
+		for (size_t j = 0; j < columns_; j++)
+		{
+			int32_t g;
+			memcpy(&g, base + header.groupOffset + j * sizeof(int32_t), sizeof(g));
+			group_[j] = g;
+		}
+	}
+
+	if (header.directoryOffset + columns_ * sizeof(ColumnEntry) > size)
+		throw corrupt("列目录越界");
+	directory_.resize(columns_);
+	if (columns_ > 0)
+		memcpy(directory_.data(), base + header.directoryOffset, columns_ * sizeof(ColumnEntry));
+	for (const auto& entry : directory_)
+	{
+		if (entry.offset + entry.bytes > size)
+			throw corrupt("列数据越界");
+		if (entry.codec == RAW && entry.bytes != rows_ * sizeof(double))
+			throw corrupt("列长度与行数不符");
+		if (entry.codec != RAW && entry.codec != SHUFFLE_RLE)
+			throw corrupt("未知的列编码");
+	}
+}
+
+size_t BCmatrixFile::rows() const
+{
+	return rows_;
+}
+
+size_t BCmatrixFile::columns() const
+{
+	return columns_;
+}
+
+const vector<string>& BCmatrixFile::rowNames() const
+{
+	return row_names_;
+}
+
+const vector<string>& BCmatrixFile::columnNames() const
+{
+	return column_names_;
+}
+
+const vector<int>& BCmatrixFile::group() const
+{
+	return group_;
+}
+
+void BCmatrixFile::_checkColumnRange(size_t column) const
+{
+	if (column >= columns_)
+	{
+		throw out_of_range("Column index out of range.");
+	}
+}
+
+const double* BCmatrixFile::columnData(size_t column) const
+{
+	_checkColumnRange(column);
+	const ColumnEntry& entry = directory_[column];
+	if (entry.codec != RAW || rows_ == 0)
+		return nullptr;
+	return reinterpret_cast<const double*>(file_.data() + entry.offset);
+}
+
+void BCmatrixFile::readColumn(size_t column, double* out) const
+{
+	_checkColumnRange(column);
+	const ColumnEntry& entry = directory_[column];
+	const uint8_t* src = reinterpret_cast<const uint8_t*>(file_.data() + entry.offset);
+	if (entry.codec == RAW)
+	{
+		if (rows_ > 0)
+			memcpy(out, src, rows_ * sizeof(double));
+		return;
+	}
+	vector<uint8_t> shuffled;
+	unpackBits(src, static_cast<size_t>(entry.bytes), shuffled, rows_ * sizeof(double));
+	unshuffleBytes(shuffled.data(), rows_, out);
+}
+
+BCarray<double> BCmatrixFile::readColumn(size_t column) const
+{
+	BCarray<double> res(rows_, 0.0, false);
+	readColumn(column, res.data());
+	return res;
+}
+
+void BCmatrixFile::readRows(size_t first, size_t count, double* out) const
+{
+	if (first + count > rows_)
+	{
+		throw out_of_range("Row index out of range.");
+	}
+	vector<double> decoded;
+	for (size_t j = 0; j < columns_; j++)
+	{
+		const double* col = columnData(j);
+		if (col == nullptr)
+		{
+			// 压缩列只能整列解码
+			decoded.resize(rows_);
+			readColumn(j, decoded.data());
+			col = decoded.data();
+		}
+		for (size_t i = 0; i < count; i++)
+			out[i * columns_ + j] = col[first + i];
+	}
+}
+
+void BCmatrixFile::write(const string& filename, const BCmatrix& matrix, bool compress)
+{
+	ofstream out(filename, ios::binary | ios::trunc);
+	if (!out.is_open())
+		throw runtime_error("Unable to open file for writing: " + filename);
+
+	size_t rows = matrix.getRowCount();
+	size_t columns = matrix.getColumnCount();
+	const vector<int>& group = matrix.getGroup();
+
+	BinaryHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = FORMAT_VERSION;
+	header.dtype = DTYPE_FLOAT64;
+	header.rows = rows;
+	header.columns = columns;
+	header.compression = compress ? SHUFFLE_RLE : RAW;
+	header.alignment = static_cast<uint32_t>(ALIGNMENT);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	header.rowNamesOffset = static_cast<uint64_t>(out.tellp());
+	for (const auto& name : matrix.getRowName())
+		writeName(out, name);
+	header.columnNamesOffset = static_cast<uint64_t>(out.tellp());
+	for (const auto& name : matrix.getColumnName())
+		writeName(out, name);
+
+	if (group.size() == columns && columns > 0)
+	{
+		padTo(out, sizeof(int32_t));
+		header.groupOffset = static_cast<uint64_t>(out.tellp());
+		for (int g : group)
+		{
+			int32_t v = g;
+			out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+		}
+	}
+
+	// 目录先占位，写完列数据后再回填
+	padTo(out, sizeof(uint64_t));
+	header.directoryOffset = static_cast<uint64_t>(out.tellp());
+	vector<ColumnEntry> directory(columns);
+	out.write(reinterpret_cast<const char*>(directory.data()), static_cast<streamsize>(columns * sizeof(ColumnEntry)));
+
+	// 行存储转成列块：按列分批并行转置/压缩，再按顺序写出
+	const vector<BCarray<double>>& value = matrix.getValue();
+	const size_t batch = max<size_t>(StatTools::threadCount() * 4, 1);
+	vector<vector<double>> columnBuf(batch);
+	vector<vector<uint8_t>> packed(batch);
+	for (size_t j0 = 0; j0 < columns; j0 += batch)
+	{
+		size_t j1 = min(columns, j0 + batch);
+		StatTools::parallelFor(j0, j1, [&](size_t lo, size_t hi)
+			{
+				vector<uint8_t> shuffled;
+				for (size_t j = lo; j < hi; j++)
+				{
+					vector<double>& col = columnBuf[j - j0];
+					col.resize(rows);
+					for (size_t i = 0; i < rows; i++)
+						col[i] = value[i][j];
+					packed[j - j0].clear();
+					if (compress)
+					{
+						shuffleBytes(col.data(), rows, shuffled);
+						packBits(shuffled, packed[j - j0]);
+					}
+				}
+			});
+
+		for (size_t j = j0; j < j1; j++)
+		{
+			padTo(out, ALIGNMENT);
+			ColumnEntry& entry = directory[j];
+			entry.offset = static_cast<uint64_t>(out.tellp());
+			const vector<uint8_t>& p = packed[j - j0];
+			if (compress && p.size() < rows * sizeof(double))
+			{
+				entry.codec = SHUFFLE_RLE;
+				entry.bytes = p.size();
+				out.write(reinterpret_cast<const char*>(p.data()), static_cast<streamsize>(p.size()));
+			}
+			else
+			{
+				entry.codec = RAW;
+				entry.bytes = rows * sizeof(double);
+				out.write(reinterpret_cast<const char*>(columnBuf[j - j0].data()), static_cast<streamsize>(entry.bytes));
+			}
+		}
+	}
+
+	out.seekp(static_cast<streamoff>(header.directoryOffset));
+	out.write(reinterpret_cast<const char*>(directory.data()), static_cast<streamsize>(columns * sizeof(ColumnEntry)));
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	if (!out.good())
+		throw runtime_error("Failed to write file: " + filename);
+	out.close();
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include "stdafx.h"
+#ifndef BCMATRIXFILE_H
+#define BCMATRIXFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+#include "MappedFile.h"
+#include "BCarray.h"
+
+class BCmatrix;
+
+/**
+ * @class BCmatrixFile
+ * @brief BCmatrix 的二进制列式文件（.bcm）
+ *
+ * 文件布局（小端序）：
+ *   1. 72 字节文件头：魔数 "BCMATRIX"、版本、数据类型、行列数、压缩方式、各数据块偏移
+ *   2. 行名块、列名块：每个名字为 uint32 长度 + UTF-8 字节
+ *   3. 分组块（可选）：列数个 int32
+ *   4. 列目录：每列 {uint64 偏移, uint64 字节数, uint32 编码, uint32 保留}
+ *   5. 列数据块：每列按 64 字节对齐，未压缩时为连续的 float64
+ *
+ * 打开文件时只解析文件头、名字和目录，列数据在访问时才从内存映射中读取；
+ * 未压缩的列可以通过 columnData() 零拷贝访问。
+ */
+class BCmatrixFile
+{
+public:
+	// 列数据的编码方式
+	enum Codec : uint32_t
+	{
+		RAW = 0,     // 原始 float64
+		SHUFFLE_RLE = 1 // 字节重排 + PackBits 游程编码
+	};
+
+	BCmatrixFile();
+	explicit BCmatrixFile(const string& filename);
+
+	// 打开并解析文件头，失败时抛出 runtime_error
+	void open(const string& filename);
+
+	size_t rows() const;
+	size_t columns() const;
+	const vector<string>& rowNames() const;
+	const vector<string>& columnNames() const;
+	const vector<int>& group() const;
+
+	// 未压缩的列直接返回映射内存中的指针，压缩列返回 nullptr
+	const double* columnData(size_t column) const;
+	// 把第 column 列解码到 out（长度为 rows()）
+	void readColumn(size_t column, double* out) const;
+	BCarray<double> readColumn(size_t column) const;
+	// 读取 [first, first + count) 行，out 为 count*columns() 的行优先缓冲区
+	void readRows(size_t first, size_t count, double* out) const;
+
+	// 写出矩阵；compress 为 true 时对能变小的列做压缩
+	static void write(const string& filename, const BCmatrix& matrix, bool compress = false);
+
+private:
+	struct ColumnEntry
+	{
+		uint64_t offset;
+		uint64_t bytes;
+		uint32_t codec;
+		uint32_t reserved;
+	};
+
+	void _checkColumnRange(size_t column) const;
+
+	MappedFile file_;
+	string filename_;
+	size_t rows_;
+	size_t columns_;
+	vector<string> row_names_;
+	vector<string> column_names_;
+	vector<int> group_;
+	vector<ColumnEntry> directory_;
+};
+
+#endif
@@ -0,0 +1,603 @@
+﻿#include "stdafx.h"
+#include "BCsimd.h"
+#include "ST.h"
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BC_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BC_AVX2
+#else
+#define BC_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BC_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace BCsimd
+{
+	namespace
+	{
+		// 超过这个长度才分给多个线程，每个线程至少处理 PARALLEL_CHUNK 个元素
+		const size_t PARALLEL_THRESHOLD = size_t(1) << 19;
+		const size_t PARALLEL_CHUNK = size_t(1) << 17;
+
+		template <typename Fn>
+		void runChunked(size_t n, Fn&& fn)
+		{
+			if (n < PARALLEL_THRESHOLD)
+			{
+				fn(size_t(0), n);
+				return;
+			}
+			StatTools::parallelFor(0, n, fn, PARALLEL_CHUNK);
+		}
+
+		Isa detectIsa()
+		{
+#if defined(BC_SIMD_NEON)
+			return Isa::NEON;
+#elif defined(BC_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+			{
+				return Isa::Scalar;
+			}
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			// 操作系统需要保存 YMM 寄存器
+			if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			{
+				return Isa::Scalar;
+			}
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0 ? Isa::AVX2 : Isa::Scalar;
+#else
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") ? Isa::AVX2 : Isa::Scalar;
+#endif
+#else
+			return Isa::Scalar;
+#endif
+		}
+
+		std::atomic<int>& currentIsa()
+		{
+			static std::atomic<int> isa(static_cast<int>(detectIsa()));
+			return isa;
+		}
+
+		/* 逐元素运算：scalar 为标量实现，avx2 / neon 为对应的向量实现 */
+
+		struct AddOp
+		{
+			static double scalar(double a, double b) { return a + b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256d avx2(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static float64x2_t neon(float64x2_t a, float64x2_t b) { return vaddq_f64(a, b); }
+#endif
+		};
+
+		struct SubOp
+		{
+			static double scalar(double a, double b) { return a - b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256d avx2(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static float64x2_t neon(float64x2_t a, float64x2_t b) { return vsubq_f64(a, b); }
+#endif
+		};
+
+		struct MulOp
+		{
+			static double scalar(double a, double b) { return a * b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256d avx2(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static float64x2_t neon(float64x2_t a, float64x2_t b) { return vmulq_f64(a, b); }
+#endif
+		};
+
+		struct DivOp
+		{
+			static double scalar(double a, double b) { return a / b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256d avx2(__m256d a, __m256d b) { return _mm256_div_pd(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static float64x2_t neon(float64x2_t a, float64x2_t b) { return vdivq_f64(a, b); }
+#endif
+		};
+
+		// 操作数交换的减法和除法，用于 s - a、s / a
+		template <typename Op>
+		struct Reversed
+		{
+			static double scalar(double a, double b) { return Op::scalar(b, a); }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256d avx2(__m256d a, __m256d b) { return Op::avx2(b, a); }
+#endif
+#ifdef BC_SIMD_NEON
+			static float64x2_t neon(float64x2_t a, float64x2_t b) { return Op::neon(b, a); }
+#endif
+		};
+
+		template <typename Op>
+		void binaryScalar(const double* a, const double* b, double* out, size_t lo, size_t hi)
+		{
+			for (size_t i = lo; i < hi; i++)
+				out[i] = Op::scalar(a[i], b[i]);
+		}
+
+		template <typename Op>
+		void broadcastScalar(const double* a, double s, double* out, size_t lo, size_t hi)
+		{
+			for (size_t i = lo; i < hi; i++)
+				out[i] = Op::scalar(a[i], s);
+		}
+
+#ifdef BC_SIMD_X86
+		template <typename Op>
+		BC_AVX2 void binaryAvx2(const double* a, const double* b, double* out, size_t lo, size_t hi)
+		{
+			size_t i = lo;
+			for (; i + 8 <= hi; i += 8)
+			{
+				__m256d a0 = _mm256_loadu_pd(a + i);
+				__m256d a1 = _mm256_loadu_pd(a + i + 4);
+				__m256d b0 = _mm256_loadu_pd(b + i);
+				__m256d b1 = _mm256_loadu_pd(b + i + 4);
+				_mm256_storeu_pd(out + i, Op::avx2(a0, b0));
+				_mm256_storeu_pd(out + i + 4, Op::avx2(a1, b1));
+			}
+			for (; i < hi; i++)
+				out[i] = Op::scalar(a[i], b[i]);
+		}
+
+		template <typename Op>
+		BC_AVX2 void broadcastAvx2(const double* a, double s, double* out, size_t lo, size_t hi)
+		{
+			__m256d v = _mm256_set1_pd(s);
+			size_t i = lo;
+			for (; i + 8 <= hi; i += 8)
+			{
+				__m256d a0 = _mm256_loadu_pd(a + i);
+				__m256d a1 = _mm256_loadu_pd(a + i + 4);
+				_mm256_storeu_pd(out + i, Op::avx2(a0, v));
+				_mm256_storeu_pd(out + i + 4, Op::avx2(a1, v));
+			}
+			for (; i < hi; i++)
+				out[i] = Op::scalar(a[i], s);
+		}
+#endif
+
+#ifdef BC_SIMD_NEON
+		template <typename Op>
+		void binaryNeon(const double* a, const double* b, double* out, size_t lo, size_t hi)
+		{
+			size_t i = lo;
+			for (; i + 4 <= hi; i += 4)
+			{
+				float64x2_t a0 = vld1q_f64(a + i);
+				float64x2_t a1 = vld1q_f64(a + i + 2);
+				float64x2_t b0 = vld1q_f64(b + i);
+				float64x2_t b1 = vld1q_f64(b + i + 2);
+				vst1q_f64(out + i, Op::neon(a0, b0));
+				vst1q_f64(out + i + 2, Op::neon(a1, b1));
+			}
+			for (; i < hi; i++)
+				out[i] = Op::scalar(a[i], b[i]);
+		}
+
+		template <typename Op>
+		void broadcastNeon(const double* a, double s, double* out, size_t lo, size_t hi)
+		{
+			float64x2_t v = vdupq_n_f64(s);
+			size_t i = lo;
+			for (; i + 4 <= hi; i += 4)
+			{
+				float64x2_t a0 = vld1q_f64(a + i);
+				float64x2_t a1 = vld1q_f64(a + i + 2);
+				vst1q_f64(out + i, Op::neon(a0, v));
+				vst1q_f64(out + i + 2, Op::neon(a1, v));
+			}
+			for (; i < hi; i++)
+				out[i] = Op::scalar(a[i], s);
+		}
+#endif
+
+		template <typename Op>
+		void binary(const double* a, const double* b, double* out, size_t n)
+		{
+			Isa isa = activeIsa();
+			runChunked(n, [=](size_t lo, size_t hi)
+				{
+					switch (isa)
+					{
+#ifdef BC_SIMD_X86
+					case Isa::AVX2:
+						binaryAvx2<Op>(a, b, out, lo, hi);
+						return;
+#endif
+#ifdef BC_SIMD_NEON
+					case Isa::NEON:
+						binaryNeon<Op>(a, b, out, lo, hi);
+						return;
+#endif
+					default:
+						binaryScalar<Op>(a, b, out, lo, hi);
+					}
+				});
+		}
+
+		template <typename Op>
+		void broadcast(const double* a, double s, double* out, size_t n)
+		{
+			Isa isa = activeIsa();
+			runChunked(n, [=](size_t lo, size_t hi)
+				{
+					switch (isa)
+					{
+#ifdef BC_SIMD_X86
+					case Isa::AVX2:
+						broadcastAvx2<Op>(a, s, out, lo, hi);
+						return;
+#endif
+#ifdef BC_SIMD_NEON
+					case Isa::NEON:
+						broadcastNeon<Op>(a, s, out, lo, hi);
+						return;
+#endif
+					default:
+						broadcastScalar<Op>(a, s, out, lo, hi);
+					}
+				});
+		}
+
+		/* 比较：结果为每元素一个字节的 0/1 掩码 */
+
+#ifdef BC_SIMD_X86
+		// 4 位比较结果 -> 4 个字节的 0/1
+		const uint32_t EXPAND4[16] = {
+			0x00000000, 0x00000001, 0x00000100, 0x00000101,
+			0x00010000, 0x00010001, 0x00010100, 0x00010101,
+			0x01000000, 0x01000001, 0x01000100, 0x01000101,
+			0x01010000, 0x01010001, 0x01010100, 0x01010101 };
+
+		template <int Imm>
+		BC_AVX2 void compareAvx2(const double* a, const double* b, double s, bool scalarRhs, uint8_t* out, size_t lo, size_t hi)
+		{
+			__m256d v = _mm256_set1_pd(s);
+			size_t i = lo;
+			for (; i + 4 <= hi; i += 4)
+			{
+				__m256d rhs = scalarRhs ? v : _mm256_loadu_pd(b + i);
+				int bits = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a + i), rhs, Imm));
+				std::memcpy(out + i, &EXPAND4[bits], 4);
+			}
+			for (; i < hi; i++)
+			{
+				double y = scalarRhs ? s : b[i];
+				bool r;
+				switch (Imm)
+				{
+				case _CMP_LT_OQ: r = a[i] < y; break;
+				case _CMP_LE_OQ: r = a[i] <= y; break;
+				case _CMP_GT_OQ: r = a[i] > y; break;
+				case _CMP_GE_OQ: r = a[i] >= y; break;
+				case _CMP_EQ_OQ: r = a[i] == y; break;
+				default: r = a[i] != y; break;
+				}
+				out[i] = r ? 1 : 0;
+			}
+		}
+#endif
+
+		void compareScalarImpl(const double* a, const double* b, double s, bool scalarRhs, uint8_t* out, size_t lo, size_t hi, Cmp op)
+		{
+			for (size_t i = lo; i < hi; i++)
+			{
+				double y = scalarRhs ? s : b[i];
+				bool r;
+				switch (op)
+				{
+				case Cmp::LT: r = a[i] < y; break;
+				case Cmp::LE: r = a[i] <= y; break;
+				case Cmp::GT: r = a[i] > y; break;
+				case Cmp::GE: r = a[i] >= y; break;
+				case Cmp::EQ: r = a[i] == y; break;
+				default: r = a[i] != y; break;
+				}
+				out[i] = r ? 1 : 0;
+			}
+		}
+
+#ifdef BC_SIMD_NEON
+		uint64x2_t compareNeonLanes(float64x2_t x, float64x2_t y, Cmp op)
+		{
+			switch (op)
+			{
+			case Cmp::LT: return vcltq_f64(x, y);
+			case Cmp::LE: return vcleq_f64(x, y);
+			case Cmp::GT: return vcgtq_f64(x, y);
+			case Cmp::GE: return vcgeq_f64(x, y);
+			case Cmp::EQ: return vceqq_f64(x, y);
+			default: return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(x, y))));
+			}
+		}
+
+		void compareNeon(const double* a, const double* b, double s, bool scalarRhs, uint8_t* out, size_t lo, size_t hi, Cmp op)
+		{
+			float64x2_t v = vdupq_n_f64(s);
+			size_t i = lo;
+			for (; i + 2 <= hi; i += 2)
+			{
+				float64x2_t rhs = scalarRhs ? v : vld1q_f64(b + i);
+				uint64x2_t m = compareNeonLanes(vld1q_f64(a + i), rhs, op);
+				out[i] = static_cast<uint8_t>(vgetq_lane_u64(m, 0) & 1);
+				out[i + 1] = static_cast<uint8_t>(vgetq_lane_u64(m, 1) & 1);
+			}
+			compareScalarImpl(a, b, s, scalarRhs, out, i, hi, op);
+		}
+#endif
+
+		void compareDispatch(const double* a, const double* b, double s, bool scalarRhs, uint8_t* out, size_t n, Cmp op)
+		{
+			Isa isa = activeIsa();
+			runChunked(n, [=](size_t lo, size_t hi)
+				{
+#ifdef BC_SIMD_X86
+					if (isa == Isa::AVX2)
+					{
+						switch (op)
+						{
+						case Cmp::LT: compareAvx2<_CMP_LT_OQ>(a, b, s, scalarRhs, out, lo, hi); return;
+						case Cmp::LE: compareAvx2<_CMP_LE_OQ>(a, b, s, scalarRhs, out, lo, hi); return;
+						case Cmp::GT: compareAvx2<_CMP_GT_OQ>(a, b, s, scalarRhs, out, lo, hi); return;
+						case Cmp::GE: compareAvx2<_CMP_GE_OQ>(a, b, s, scalarRhs, out, lo, hi); return;
+						case Cmp::EQ: compareAvx2<_CMP_EQ_OQ>(a, b, s, scalarRhs, out, lo, hi); return;
+						default: compareAvx2<_CMP_NEQ_UQ>(a, b, s, scalarRhs, out, lo, hi); return;
+						}
+					}
+#endif
+#ifdef BC_SIMD_NEON
+					if (isa == Isa::NEON)
+					{
+						compareNeon(a, b, s, scalarRhs, out, lo, hi, op);
+						return;
+					}
+#endif
+					compareScalarImpl(a, b, s, scalarRhs, out, lo, hi, op);
+				});
+		}
+
+		/* 掩码运算 */
+
+		struct AndOp
+		{
+			static uint8_t scalar(uint8_t a, uint8_t b) { return a & b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256i avx2(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static uint8x16_t neon(uint8x16_t a, uint8x16_t b) { return vandq_u8(a, b); }
+#endif
+		};
+
+		struct OrOp
+		{
+			static uint8_t scalar(uint8_t a, uint8_t b) { return a | b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256i avx2(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static uint8x16_t neon(uint8x16_t a, uint8x16_t b) { return vorrq_u8(a, b); }
+#endif
+		};
+
+		// 掩码只含 0/1，取反即与 1 异或
+		struct XorOp
+		{
+			static uint8_t scalar(uint8_t a, uint8_t b) { return a ^ b; }
+#ifdef BC_SIMD_X86
+			static BC_AVX2 __m256i avx2(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+#ifdef BC_SIMD_NEON
+			static uint8x16_t neon(uint8x16_t a, uint8x16_t b) { return veorq_u8(a, b); }
+#endif
+		};
+
+#ifdef BC_SIMD_X86
+		template <typename Op>
+		BC_AVX2 void maskAvx2(const uint8_t* a, const uint8_t* b, uint8_t one, bool scalarRhs, uint8_t* out, size_t lo, size_t hi)
+		{
+			__m256i v = _mm256_set1_epi8(static_cast<char>(one));
+			size_t i = lo;
+			for (; i + 32 <= hi; i += 32)
+			{
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				__m256i y = scalarRhs ? v : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), Op::avx2(x, y));
+			}
+			for (; i < hi; i++)
+				out[i] = Op::scalar(a[i], scalarRhs ? one : b[i]);
+		}
+
+		BC_AVX2 size_t countAvx2(const uint8_t* a, size_t lo, size_t hi)
+		{
+			__m256i zero = _mm256_setzero_si256();
+			__m256i acc = zero;
+			size_t i = lo;
+			for (; i + 32 <= hi; i += 32)
+			{
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				acc = _mm256_add_epi64(acc, _mm256_sad_epu8(x, zero));
+			}
+			uint64_t lanes[4];
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+			size_t total = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+			for (; i < hi; i++)
+				total += a[i];
+			return total;
+		}
+#endif
+
+#ifdef BC_SIMD_NEON
+		template <typename Op>
+		void maskNeon(const uint8_t* a, const uint8_t* b, uint8_t one, bool scalarRhs, uint8_t* out, size_t lo, size_t hi)
+		{
+			uint8x16_t v = vdupq_n_u8(one);
+			size_t i = lo;
+			for (; i + 16 <= hi; i += 16)
+			{
+				uint8x16_t x = vld1q_u8(a + i);
+				uint8x16_t y = scalarRhs ? v : vld1q_u8(b + i);
+				vst1q_u8(out + i, Op::neon(x, y));
+			}
+			for (; i < hi; i++)
+				out[i] = Op::scalar(a[i], scalarRhs ? one : b[i]);
+		}
+
+		size_t countNeon(const uint8_t* a, size_t lo, size_t hi)
+		{
+			size_t total = 0;
+			size_t i = lo;
+			for (; i + 16 <= hi; i += 16)
+				total += vaddlvq_u8(vld1q_u8(a + i));
+			for (; i < hi; i++)
+				total += a[i];
+			return total;
+		}
+#endif
+
+		template <typename Op>
+		void maskDispatch(const uint8_t* a, const uint8_t* b, uint8_t one, bool scalarRhs, uint8_t* out, size_t n)
+		{
+			Isa isa = activeIsa();
+			runChunked(n, [=](size_t lo, size_t hi)
+				{
+					switch (isa)
+					{
+#ifdef BC_SIMD_X86
+					case Isa::AVX2:
+						maskAvx2<Op>(a, b, one, scalarRhs, out, lo, hi);
+						return;
+#endif
+#ifdef BC_SIMD_NEON
+					case Isa::NEON:
+						maskNeon<Op>(a, b, one, scalarRhs, out, lo, hi);
+						return;
+#endif
+					default:
+						for (size_t i = lo; i < hi; i++)
+							out[i] = Op::scalar(a[i], scalarRhs ? one : b[i]);
+					}
+				});
+		}
+	}
+
+	Isa activeIsa()
+	{
+		return static_cast<Isa>(currentIsa().load(std::memory_order_relaxed));
+	}
+
+	const char* isaName()
+	{
+		switch (activeIsa())
+		{
+		case Isa::AVX2:
+			return "AVX2";
+		case Isa::NEON:
+			return "NEON";
+		default:
+			return "scalar";
+		}
+	}
+
+	void setIsa(Isa isa)
+	{
+		if (isa != Isa::Scalar && isa != detectIsa())
+		{
+			throw std::invalid_argument("setIsa: instruction set is not supported by this CPU.");
+		}
+		currentIsa().store(static_cast<int>(isa), std::memory_order_relaxed);
+	}
+
+	void add(const double* a, const double* b, double* out, size_t n) { binary<AddOp>(a, b, out, n); }
+	void sub(const double* a, const double* b, double* out, size_t n) { binary<SubOp>(a, b, out, n); }
+	void mul(const double* a, const double* b, double* out, size_t n) { binary<MulOp>(a, b, out, n); }
+	void div(const double* a, const double* b, double* out, size_t n) { binary<DivOp>(a, b, out, n); }
+
+	void addScalar(const double* a, double s, double* out, size_t n) { broadcast<AddOp>(a, s, out, n); }
+	void subScalar(const double* a, double s, double* out, size_t n) { broadcast<SubOp>(a, s, out, n); }
+	void mulScalar(const double* a, double s, double* out, size_t n) { broadcast<MulOp>(a, s, out, n); }
+	void divScalar(const double* a, double s, double* out, size_t n) { broadcast<DivOp>(a, s, out, n); }
+
+	void scalarSub(double s, const double* a, double* out, size_t n) { broadcast<Reversed<SubOp>>(a, s, out, n); }
+	void scalarDiv(double s, const double* a, double* out, size_t n) { broadcast<Reversed<DivOp>>(a, s, out, n); }
+
+	void neg(const double* a, double* out, size_t n)
+	{
+		// 乘以 -1 与取负完全一致（包括 0 的符号）
+		broadcast<MulOp>(a, -1.0, out, n);
+	}
+
+	void compare(const double* a, const double* b, uint8_t* out, size_t n, Cmp op)
+	{
+		compareDispatch(a, b, 0.0, false, out, n, op);
+	}
+
+	void compareScalar(const double* a, double s, uint8_t* out, size_t n, Cmp op)
+	{
+		compareDispatch(a, nullptr, s, true, out, n, op);
+	}
+
+	void nonzero(const double* a, uint8_t* out, size_t n)
+	{
+		compareDispatch(a, nullptr, 0.0, true, out, n, Cmp::NE);
+	}
+
+	void maskAnd(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n) { maskDispatch<AndOp>(a, b, 0, false, out, n); }
+	void maskOr(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n) { maskDispatch<OrOp>(a, b, 0, false, out, n); }
+	void maskNot(const uint8_t* a, uint8_t* out, size_t n) { maskDispatch<XorOp>(a, nullptr, 1, true, out, n); }
+
+	size_t maskCount(const uint8_t* a, size_t n)
+	{
+		Isa isa = activeIsa();
+		std::atomic<size_t> total(0);
+		runChunked(n, [&total, a, isa](size_t lo, size_t hi)
+			{
+				size_t part = 0;
+				switch (isa)
+				{
+#ifdef BC_SIMD_X86
+				case Isa::AVX2:
+					part = countAvx2(a, lo, hi);
+					break;
+#endif
+#ifdef BC_SIMD_NEON
+				case Isa::NEON:
+					part = countNeon(a, lo, hi);
+					break;
+#endif
+				default:
+					for (size_t i = lo; i < hi; i++)
+						part += a[i];
+				}
+				total += part;
+			});
+		return total.load();
+	}
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include "stdafx.h"
+#ifndef BCSIMD_H
+#define BCSIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 连续 double 数组的逐元素 SIMD 内核。
+ *
+ * x86 上运行时检测 CPU，支持 AVX2 时走 AVX2 实现，否则走标量实现；aarch64 上固定使用 NEON。
+ * 可以用 setIsa 强制切换到标量实现（便于对比结果）。
+ * 大数组会按块分给多个线程，使吞吐量接近内存带宽。
+ * 所有内核允许 out 与输入指向同一块内存（原地计算），但不允许部分重叠。
+ * 布尔掩码每个元素占一个字节，取值只有 0 和 1。
+ */
+namespace BCsimd
+{
+	enum class Isa
+	{
+		Scalar,
+		AVX2,
+		NEON
+	};
+
+	enum class Cmp
+	{
+		LT,
+		LE,
+		GT,
+		GE,
+		EQ,
+		NE
+	};
+
+	// 当前使用的指令集
+	Isa activeIsa();
+	const char* isaName();
+	// 切换指令集，当前 CPU 不支持时抛出 invalid_argument
+	void setIsa(Isa isa);
+
+	// out = a op b
+	void add(const double* a, const double* b, double* out, size_t n);
+	void sub(const double* a, const double* b, double* out, size_t n);
+	void mul(const double* a, const double* b, double* out, size_t n);
+	void div(const double* a, const double* b, double* out, size_t n);
+
+	// out = a op s
+	void addScalar(const double* a, double s, double* out, size_t n);
+	void subScalar(const double* a, double s, double* out, size_t n);
+	void mulScalar(const double* a, double s, double* out, size_t n);
+	void divScalar(const double* a, double s, double* out, size_t n);
+
+	// out = s op a
+	void scalarSub(double s, const double* a, double* out, size_t n);
+	void scalarDiv(double s, const double* a, double* out, size_t n);
+
+	// out = -a
+	void neg(const double* a, double* out, size_t n);
+
+	// 比较，结果写成掩码
+	void compare(const double* a, const double* b, uint8_t* out, size_t n, Cmp op);
+	void compareScalar(const double* a, double s, uint8_t* out, size_t n, Cmp op);
+	// out = (a != 0)
+	void nonzero(const double* a, uint8_t* out, size_t n);
+
+	// 掩码运算
+	void maskAnd(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n);
+	void maskOr(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n);
+	void maskNot(const uint8_t* a, uint8_t* out, size_t n);
+	size_t maskCount(const uint8_t* a, size_t n);
+}
+
+#endif
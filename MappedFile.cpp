@@ -0,0 +1,175 @@
+﻿#include "stdafx.h"
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data_(nullptr), size_(0), open_(false), file_(nullptr), mapping_(nullptr) {}
+#else
+MappedFile::MappedFile() : data_(nullptr), size_(0), open_(false), fd_(-1) {}
+#endif
+
+MappedFile::MappedFile(const string& filename) : MappedFile()
+{
+	open(filename);
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : MappedFile()
+{
+	_moveFrom(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		_moveFrom(other);
+	}
+	return *this;
+}
+
+void MappedFile::_moveFrom(MappedFile& other)
+{
+	data_ = other.data_;
+	size_ = other.size_;
+	open_ = other.open_;
+#ifdef _WIN32
+	file_ = other.file_;
+	mapping_ = other.mapping_;
+	other.file_ = nullptr;
+	other.mapping_ = nullptr;
+#else
+	fd_ = other.fd_;
+	other.fd_ = -1;
+#endif
+	other.data_ = nullptr;
+	other.size_ = 0;
+	other.open_ = false;
+}
+
+void MappedFile::open(const string& filename)
+{
+	close();
+#ifdef _WIN32
+	// 路径按 UTF-8 处理（Qt 的 toStdString() 给出的就是 UTF-8）
+	int wlen = MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, nullptr, 0);
+	wstring wpath(wlen > 0 ? wlen - 1 : 0, L'\0');
+	if (wlen > 1)
+		MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, &wpath[0], wlen);
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw runtime_error("Failed to open file: " + filename);
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		throw runtime_error("Failed to get file size: " + filename);
+	}
+	file_ = file;
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	open_ = true;
+
+	// 空文件无法建立映射，直接视为长度为 0
+	if (size_ == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		close();
+		throw runtime_error("Failed to map file: " + filename);
+	}
+	mapping_ = mapping;
+	data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr)
+	{
+		close();
+		throw runtime_error("Failed to map file: " + filename);
+	}
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw runtime_error("Failed to open file: " + filename);
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		::close(fd);
+		throw runtime_error("Failed to get file size: " + filename);
+	}
+	fd_ = fd;
+	size_ = static_cast<size_t>(st.st_size);
+	open_ = true;
+
+	// 空文件无法建立映射，直接视为长度为 0
+	if (size_ == 0)
+		return;
+
+	void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (addr == MAP_FAILED)
+	{
+		close();
+		throw runtime_error("Failed to map file: " + filename);
+	}
+	madvise(addr, size_, MADV_SEQUENTIAL);
+	data_ = static_cast<const char*>(addr);
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data_ != nullptr)
+		UnmapViewOfFile(data_);
+	if (mapping_ != nullptr)
+		CloseHandle(static_cast<HANDLE>(mapping_));
+	if (file_ != nullptr)
+		CloseHandle(static_cast<HANDLE>(file_));
+	file_ = nullptr;
+	mapping_ = nullptr;
+#else
+	if (data_ != nullptr)
+		munmap(const_cast<char*>(data_), size_);
+	if (fd_ >= 0)
+		::close(fd_);
+	fd_ = -1;
+#endif
+	data_ = nullptr;
+	size_ = 0;
+	open_ = false;
+}
+
+bool MappedFile::isOpen() const
+{
+	return open_;
+}
+
+const char* MappedFile::data() const
+{
+	return data_;
+}
+
+size_t MappedFile::size() const
+{
+	return size_;
+}
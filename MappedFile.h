@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include "stdafx.h"
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+using namespace std;
+
+/**
+ * @class MappedFile
+ * @brief 只读内存映射文件（Windows 与 POSIX），析构时自动解除映射
+ *
+ * 用于大文件的快速读取：文件内容直接映射进地址空间，不经过 iostream 缓冲。
+ * 对象只可移动不可拷贝。
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	explicit MappedFile(const string& filename);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	// 打开并映射文件，失败时抛出 runtime_error
+	void open(const string& filename);
+	// 解除映射并关闭文件
+	void close();
+
+	bool isOpen() const;
+	const char* data() const;
+	size_t size() const;
+
+private:
+	void _moveFrom(MappedFile& other);
+
+	const char* data_;
+	size_t size_;
+	bool open_;
+#ifdef _WIN32
+	void* file_;    // HANDLE
+	void* mapping_; // HANDLE
+#else
+	int fd_;
+#endif
+};
+
+#endif
@@ -1,1868 +1,7126 @@
-﻿#pragma once
-
-#ifndef ST_H
-#define ST_H
-
-#define _USE_MATH_DEFINES
-#include <iostream>
-#include <numeric>
-#include <vector>
-#include <random>
-#include <algorithm>
-#include <stdexcept>
-#include <cmath>
-#include <limits>
-#include <utility>
-#include <cstdlib>
-#include <unordered_set>
-#include <map>
-#include <unordered_map>
-#include <functional>
-#include <boost/math/distributions/students_t.hpp>
-
-namespace StatTools
-{
-	/*
-	第一次扩展
-	基础统计部分
-	*/
-
-	/**
-	 * Throws an exception if the vector is empty or contains non-numeric elements.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector to check.
-	 * @throws std::invalid_argument If the vector is empty.
-	 */
-	template <typename T>
-	inline void checkVector(const std::vector<T>& vec)
-	{
-		if (vec.empty())
-		{
-			throw std::invalid_argument("Vector is empty");
-		}
-		static_assert(std::is_arithmetic<T>::value, "Vector elements must be numeric");
-	}
-
-	/**
-	 * Checks if the vector contains any duplicate elements.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector to check.
-	 * @return True if duplicates are found, false otherwise.
-	 */
-	template <typename T>
-	inline bool hasDuplicates(const std::vector<T>& vec)
-	{
-		return vec.size() != std::unordered_set<T>(vec.begin(), vec.end()).size();
-	}
-
-	/**
-	 * Calculates the sum of all elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The sum of the elements.
-	 */
-	template <typename T>
-	inline T sum(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		return std::accumulate(vec.begin(), vec.end(), T{});
-	}
-
-	/**
-	 * Finds the maximum value in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The maximum value.
-	 */
-	template <typename T>
-	inline T max(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		return *std::max_element(vec.begin(), vec.end());
-	}
-
-	/**
-	 * Finds the minimum value in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The minimum value.
-	 */
-	template <typename T>
-	inline T min(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		return *std::min_element(vec.begin(), vec.end());
-	}
-
-	/**
-	 * Calculates the mean (average) of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The mean value as a double.
-	 */
-	template <typename T>
-	inline double mean(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		return static_cast<double>(sum<T>(vec)) / vec.size();
-	}
-
-	/**
-	 * Calculates the Euclidean norm (magnitude) of the elements in the vector.
-	 * This is also known as the L2 norm or the Euclidean length of the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The Euclidean norm as a double.
-	 */
-	template <typename T>
-	inline double norm(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		double sumOfSquares = 0.0;
-		for (const auto& x : vec)
-		{
-			sumOfSquares += x * x;
-		}
-		return std::sqrt(sumOfSquares);
-	}
-
-	/**
-	 * Calculates the p-norm of the elements in the vector.
-	 * The p-norm is a generalization of the Euclidean norm, where p can be any positive real number.
-	 * For p = 2, this is the Euclidean norm (L2 norm).
-	 * For p = 1, this is the Manhattan norm (L1 norm).
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @param ord The order of the norm (must be a positive real number).
-	 * @return The p-norm as a double.
-	 */
-	template <typename T>
-	inline double norm(const std::vector<T>& vec, int ord)
-	{
-		checkVector(vec);
-		if (ord <= 0)
-		{
-			throw std::invalid_argument("The order of the norm (ord) must be a positive number");
-		}
-		switch (ord)
-		{
-		case 1:
-		{
-			double sumAbs = 0.0;
-			for (const auto& x : vec)
-			{
-				sumAbs += std::abs(x);
-			}
-			return sumAbs;
-		}
-		case 2:
-		{
-			return norm(vec);
-		}
-		default:
-		{
-			double sumOfPowers = 0.0;
-			for (const auto& x : vec)
-			{
-				sumOfPowers += std::pow(std::abs(x), ord);
-			}
-			return std::pow(sumOfPowers, 1.0 / ord);
-		}
-		}
-	}
-
-	/**
-	 * Calculates the median of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements (will be modified).
-	 * @return The median value.
-	 */
-	template <typename T>
-	inline T median(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		std::vector<T> sortedVec(vec);
-		std::sort(sortedVec.begin(), sortedVec.end());
-		size_t size = sortedVec.size();
-		if (size % 2 == 0)
-		{
-			return (sortedVec[size / 2 - 1] + sortedVec[size / 2]) / 2;
-		}
-		else
-		{
-			return sortedVec[size / 2];
-		}
-	}
-
-	/**
-	 * Calculates the population variance of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The population variance.
-	 */
-	template <typename T>
-	inline double populationVar(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		double meanVal = mean(vec);
-		double variance = 0.0;
-		for (const auto& x : vec)
-		{
-			variance += (x - meanVal) * (x - meanVal);
-		}
-		return variance / vec.size();
-	}
-
-	/**
-	 * Calculates the sample variance of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The sample variance.
-	 */
-	template <typename T>
-	inline double sampleVar(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		double meanVal = mean(vec);
-		double variance = 0.0;
-		for (const auto& x : vec)
-		{
-			variance += (x - meanVal) * (x - meanVal);
-		}
-		return variance / (vec.size() - 1);
-	}
-
-	/**
-	 * Calculates the variance of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @param isSample Indicates whether to calculate sample variance (true) or population variance (false).
-	 * @return The variance.
-	 */
-	template <typename T>
-	inline double var(const std::vector<T>& vec, bool isSample = false)
-	{
-		return isSample ? sampleVar(vec) : populationVar(vec);
-	}
-
-	/**
-	 * Calculates the population standard deviation of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The population standard deviation.
-	 */
-	template <typename T>
-	inline double populationStd(const std::vector<T>& vec)
-	{
-		return std::sqrt(populationVar(vec));
-	}
-
-	/**
-	 * Calculates the sample standard deviation of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The sample standard deviation.
-	 */
-	template <typename T>
-	inline double sampleStd(const std::vector<T>& vec)
-	{
-		return std::sqrt(sampleVar(vec));
-	}
-
-	/**
-	 * Calculates the standard deviation of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @param isSample Indicates whether to calculate sample standard deviation (true) or population standard deviation (false).
-	 * @return The standard deviation.
-	 */
-	template <typename T>
-	inline double std(const std::vector<T>& vec, bool isSample = false)
-	{
-		return std::sqrt(var(vec, isSample));
-	}
-
-	/**
-	 * Calculates the skewness of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The skewness.
-	 */
-	template <typename T>
-	inline double skewness(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		if (vec.size() < 3)
-		{
-			throw std::invalid_argument("Skewness is undefined for vector of size less than 3");
-		}
-		double meanVal = mean(vec);
-		double stdVal = populationStd(vec);
-		double skew = 0.0;
-		for (const auto& x : vec)
-		{
-			skew += std::pow((x - meanVal) / stdVal, 3);
-		}
-		return skew / vec.size();
-	}
-
-	/**
-	 * Calculates the kurtosis of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The kurtosis.
-	 */
-	template <typename T>
-	inline double kurtosis(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		if (vec.size() < 4)
-		{
-			throw std::invalid_argument("Kurtosis is undefined for vector of size less than 4");
-		}
-		double meanVal = mean(vec);
-		double stdVal = populationStd(vec);
-		double kurt = 0.0;
-		for (const auto& x : vec)
-		{
-			kurt += std::pow((x - meanVal) / stdVal, 4);
-		}
-		return kurt / vec.size() - 3;
-	}
-
-	/**
-	 * Calculates the percentile of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @param p The percentile to calculate (between 0 and 1).
-	 * @return The percentile value.
-	 */
-	template <typename T>
-	inline double percentile(const std::vector<T>& vec, double p)
-	{
-		checkVector(vec);
-		if (p < 0 || p > 1)
-		{
-			throw std::invalid_argument("Percentile must be between 0 and 1");
-		}
-		std::vector<T> sortedVec(vec);
-		std::sort(sortedVec.begin(), sortedVec.end());
-		size_t index = static_cast<size_t>(p * (sortedVec.size() - 1));
-		return sortedVec[index];
-	}
-
-	/**
-	 * Finds the mode of the elements in the vector.
-	 *
-	 * @tparam T The type of elements in the vector.
-	 * @param vec The vector containing the elements.
-	 * @return The mode value.
-	 */
-	template <typename T>
-	inline T mode(const std::vector<T>& vec)
-	{
-		checkVector(vec);
-		std::unordered_map<T, int> freqMap;
-		for (const auto& x : vec)
-		{
-			freqMap[x]++;
-		}
-		T modeValue = vec[0];
-		int maxFreq = 0;
-		for (const auto& pair : freqMap)
-		{
-			if (pair.second > maxFreq)
-			{
-				maxFreq = pair.second;
-				modeValue = pair.first;
-			}
-		}
-		return modeValue;
-	}
-
-	/**
-	 * Calculates the covariance between two vectors.
-	 *
-	 * @tparam T The type of elements in the vectors.
-	 * @param vec1 The first vector.
-	 * @param vec2 The second vector.
-	 * @param isSample Indicates whether to calculate sample covariance (true) or population covariance (false).
-	 * @return The covariance.
-	 */
-	template <typename T>
-	inline double covariance(const std::vector<T>& vec1, const std::vector<T>& vec2, bool isSample = false)
-	{
-		if (vec1.size() != vec2.size())
-		{
-			throw std::invalid_argument("Vectors must be of the same size");
-		}
-		checkVector(vec1);
-		checkVector(vec2);
-		double mean1 = mean(vec1);
-		double mean2 = mean(vec2);
-		double cov = 0.0;
-		for (size_t i = 0; i < vec1.size(); ++i)
-		{
-			cov += (vec1[i] - mean1) * (vec2[i] - mean2);
-		}
-		return isSample ? cov / (vec1.size() - 1) : cov / vec1.size();
-	}
-
-	/**
-	 * Calculates the correlation coefficient between two vectors.
-	 *
-	 * @tparam T The type of elements in the vectors.
-	 * @param vec1 The first vector.
-	 * @param vec2 The second vector.
-	 * @return The correlation coefficient.
-	 */
-	template <typename T>
-	inline double correlation(const std::vector<T>& vec1, const std::vector<T>& vec2)
-	{
-		return covariance(vec1, vec2) / (std(vec1) * std(vec2));
-	}
-
-	/*
-	第二次扩展
-	t-test
-	*/
-	struct t_testResult
-	{
-		double t;
-		double p_value;
-		double log2_fc;
-	};
-
-	/**
-	 * Performs a two-sample t-test on two vectors.
-	 *
-	 * @tparam T The type of elements in the vectors.
-	 * @param vec1 The first vector.
-	 * @param vec2 The second vector.
-	 * @return A t_testResult object containing the t-statistic, p-value, and log2 fold change.
-	 */
-	template <typename T>
-	inline t_testResult t_test(const std::vector<T>& vec1, const std::vector<T>& vec2, bool log2_data = true)
-	{
-		// 计算t统计量
-		double m1 = mean(vec1);
-		double m2 = mean(vec2);
-		double s1 = var(vec1, true) / vec1.size();
-		double s2 = var(vec2, true) / vec2.size();
-
-		// 计算log2 fold change
-		double log2_fc = 0;
-		if (log2_data)
-			// 数据已经经过了log2处理，所以直接相减即可
-			log2_fc = m1 - m2;
-		else
-			log2_fc = std::log2(m1 / m2);
-
-		// 计算t值和自由度
-		double t = (m1 - m2) / std::sqrt(s1 + s2);
-		double df = std::pow(s1 + s2, 2) / (std::pow(s1, 2) / (vec1.size() - 1) + std::pow(s2, 2) / (vec2.size() - 1));
-
-		boost::math::students_t dist(df);
-		double p = 2 * boost::math::cdf(boost::math::complement(dist, std::abs(t)));
-
-		return { t, p, log2_fc };
-	}
-
-	/**
-	 * Adjusts the false discovery rate (FDR) of a set of p-values using the Benjamini-Hochberg method.
-	 *
-	 * @param p_values A vector of p-values to be adjusted.
-	 * @return A vector of adjusted p-values.
-	 */
-	inline std::vector<double> adjust_fdr(std::vector<double> p_values)
-	{
-		size_t n = p_values.size();
-		std::vector<std::pair<double, int>> pv_with_index;
-		for (size_t i = 0; i < n; ++i)
-			pv_with_index.push_back({ p_values[i], i });
-		std::sort(pv_with_index.begin(), pv_with_index.end());
-
-		std::vector<double> q_values(n);
-		double prev_q = 1.0;
-		for (int i = n - 1; i >= 0; --i)
-		{
-			double unadjusted = pv_with_index[i].first * n / (i + 1);
-			double q = std::min(unadjusted, prev_q);
-			q_values[pv_with_index[i].second] = q;
-			prev_q = q;
-		}
-		return q_values;
-	}
-
-	/*
-	第三次扩展
-	线性代数 + PCA + Kmeans
-	*/
-
-	/**
-	 * Multiplies two matrices.
-	 *
-	 * This function performs matrix multiplication, computing the product of two matrices A and B.
-	 * The number of columns in matrix A must be equal to the number of rows in matrix B.
-	 *
-	 * @param A The first matrix, represented as a 2D vector.
-	 * @param B The second matrix, represented as a 2D vector.
-	 * @return A new matrix that is the product of A and B, represented as a 2D vector.
-	 * @throws std::invalid_argument If the number of columns in A does not match the number of rows in B.
-	 */
-	inline std::vector<std::vector<double>> multiplyMatrix(const std::vector<std::vector<double>>& A, const std::vector<std::vector<double>>& B)
-	{
-		size_t rowsA = A.size();
-		size_t colsA = A[0].size();
-		size_t rowsB = B.size();
-		size_t colsB = B[0].size();
-
-		if (colsA != rowsB)
-		{
-			throw std::invalid_argument("Matrix dimensions do not match for multiplication");
-		}
-
-		std::vector<std::vector<double>> C(rowsA, std::vector<double>(colsB, 0.0));
-		for (size_t i = 0; i < rowsA; ++i)
-		{
-			for (size_t j = 0; j < colsB; ++j)
-			{
-				for (size_t k = 0; k < colsA; ++k)
-				{
-					C[i][j] += A[i][k] * B[k][j];
-				}
-			}
-		}
-		return C;
-	}
-
-	/**
-	 * Finds the position of the largest off-diagonal element in a square matrix.
-	 *
-	 * This function scans the upper triangular part of the matrix (excluding the diagonal)
-	 * and returns the indices of the element with the largest absolute value.
-	 *
-	 * @param mat The square matrix represented as a 2D vector.
-	 * @return A pair of integers representing the indices (row, column) of the largest off-diagonal element.
-	 *         The row index is less than the column index, as the function only considers the upper triangle.
-	 * @throws std::invalid_argument If the matrix is not square (i.e., number of rows is not equal to the number of columns).
-	 */
-	inline std::pair<int, int> findMaxOffDiagonal(const std::vector<std::vector<double>>& mat)
-	{
-		int n = mat.size();
-		double max_val = 0.0;
-		std::pair<int, int> max_pos = { 0, 1 };
-		for (int i = 0; i < n; ++i)
-		{
-			for (int j = i + 1; j < n; ++j)
-			{
-				double abs_val = fabs(mat[i][j]);
-				if (abs_val > max_val)
-				{
-					max_val = abs_val;
-					max_pos = { i, j };
-				}
-			}
-		}
-		return max_pos;
-	}
-
-	/**
-	 * Performs QR decomposition of a matrix.
-	 *
-	 * This function decomposes a matrix A into an orthogonal matrix Q and an upper triangular matrix R
-	 * such that A = QR. The decomposition is done using the Gram-Schmidt process.
-	 *
-	 * @param A The matrix to decompose, represented as a 2D vector.
-	 * @return A pair of matrices Q and R, represented as 2D vectors.
-	 * @throws std::invalid_argument If the matrix A is not square or has incompatible dimensions.
-	 */
-	inline std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> qrDecomposition(std::vector<std::vector<double>> A)
-	{
-		size_t rows = A.size();
-		size_t cols = A[0].size();
-		std::vector<std::vector<double>> Q(rows, std::vector<double>(cols, 0.0));
-		std::vector<std::vector<double>> R(rows, std::vector<double>(cols, 0.0));
-
-		for (size_t i = 0; i < rows; ++i)
-		{
-			Q[i][i] = 1.0;
-		}
-
-		for (size_t j = 0; j < cols; ++j)
-		{
-			double norm = 0.0;
-			for (size_t i = 0; i < rows; ++i)
-			{
-				norm += A[i][j] * A[i][j];
-			}
-			R[j][j] = sqrt(norm);
-
-			std::vector<double> q_col(rows);
-			for (size_t i = 0; i < rows; ++i)
-			{
-				q_col[i] = A[i][j] / R[j][j];
-			}
-
-			for (size_t k = j + 1; k < cols; ++k)
-			{
-				double dot_prod = 0.0;
-				for (size_t i = 0; i < rows; ++i)
-				{
-					dot_prod += q_col[i] * A[i][k];
-				}
-				R[j][k] = dot_prod;
-				for (size_t i = 0; i < rows; ++i)
-				{
-					A[i][k] -= q_col[i] * dot_prod;
-				}
-			}
-
-			for (size_t i = 0; i < rows; ++i)
-			{
-				Q[i][j] = q_col[i];
-			}
-		}
-
-		return { Q, R };
-	}
-
-	/**
-	 * Computes the eigenvalues and eigenvectors of a matrix using QR iteration.
-	 *
-	 * This function iteratively applies QR decomposition to a matrix and updates it until the matrix
-	 * converges to a diagonal form. The diagonal elements are the eigenvalues, and the columns of the
-	 * matrix Q are the eigenvectors.
-	 *
-	 * @param A The matrix to compute eigenvalues and eigenvectors for, represented as a 2D vector.
-	 * @param max_iter The maximum number of iterations to perform in the QR algorithm.
-	 * @param tol The tolerance value to check for convergence. If the change in eigenvalues is less than this, the algorithm stops.
-	 * @return A pair of the eigenvalues (as a vector) and the eigenvectors (as a 2D vector).
-	 * @throws std::invalid_argument If the matrix A is not square or has incompatible dimensions.
-	 */
-	inline std::pair<std::vector<double>, std::vector<std::vector<double>>> eigenvalues_and_eigenvectors(std::vector<std::vector<double>>& A, int max_iter = 1000, double tol = 1e-6)
-	{
-		size_t n = A.size();
-		std::vector<double> eigenvals(n);
-		std::vector<std::vector<double>> eigenvectors(n, std::vector<double>(n, 0.0));
-
-		for (size_t i = 0; i < n; ++i)
-		{
-			eigenvectors[i][i] = 1.0;
-		}
-
-		for (int iter = 0; iter < max_iter; ++iter)
-		{
-			std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> result = qrDecomposition(A);
-			std::vector<std::vector<double>> Q = result.first;
-			std::vector<std::vector<double>> R = result.second;
-
-			A = multiplyMatrix(R, Q);
-
-			bool converged = true;
-			for (size_t i = 0; i < n; ++i)
-			{
-				eigenvals[i] = A[i][i];
-				if (fabs(A[i][i] - eigenvals[i]) > tol)
-				{
-					converged = false;
-				}
-			}
-
-			eigenvectors = multiplyMatrix(Q, eigenvectors);
-
-			if (converged)
-				break;
-		}
-
-		return { eigenvals, eigenvectors };
-	}
-
-	/**
-	 * Performs Principal Component Analysis (PCA) on a dataset.
-	 *
-	 * This function standardizes the input data, computes the covariance matrix, and performs
-	 * eigenvalue decomposition to find the principal components. The data is then projected onto
-	 * the first 'num_components' principal components.
-	 *
-	 * @param data The dataset to perform PCA on, represented as a 2D vector. Rows are samples and columns are features.
-	 * @param num_components The number of principal components to retain after dimensionality reduction.
-	 * @return A new matrix with the projected data, with the shape (n, num_components), where n is the number of samples.
-	 * @throws std::invalid_argument If the number of components is larger than the number of features.
-	 */
-	inline std::vector<std::vector<double>> performPCA(std::vector<std::vector<double>> data, int num_components)
-	{
-		size_t row = data.size();
-		size_t col = data[0].size();
-
-		// 数据标准化
-		// 计算每列的均值
-		std::vector<double> means(col, 0.0);
-		for (size_t j = 0; j < col; ++j)
-		{
-			for (size_t i = 0; i < row; ++i)
-			{
-				means[j] += data[i][j];
-			}
-			means[j] /= row;
-		}
-
-		// 计算每列的标准差
-		std::vector<double> stddevs(col, 0.0);
-		for (size_t j = 0; j < col; ++j)
-		{
-			for (size_t i = 0; i < row; ++i)
-			{
-				stddevs[j] += pow(data[i][j] - means[j], 2);
-			}
-			stddevs[j] = sqrt(stddevs[j] / row);
-		}
-
-		// 标准化数据
-		for (size_t i = 0; i < row; ++i)
-		{
-			for (size_t j = 0; j < col; ++j)
-			{
-				data[i][j] = (data[i][j] - means[j]) / stddevs[j];
-			}
-		}
-
-		// 计算协方差矩阵
-		std::vector<std::vector<double>> cov_matrix(col, std::vector<double>(col, 0.0));
-		for (size_t i = 0; i < col; ++i)
-		{
-			for (size_t j = i; j < col; ++j)
-			{
-				double sum = 0.0;
-				for (size_t k = 0; k < row; ++k)
-				{
-					sum += data[k][i] * data[k][j];
-				}
-				cov_matrix[i][j] = sum / (row - 1);
-				cov_matrix[j][i] = cov_matrix[i][j];
-			}
-		}
-
-		auto result = eigenvalues_and_eigenvectors(cov_matrix);
-
-		// 选择前num_components个主成分
-		std::vector<size_t> indices(col);
-		std::iota(indices.begin(), indices.end(), 0);
-		sort(indices.begin(), indices.end(), [&result](size_t i1, size_t i2)
-			{ return result.first[i1] > result.first[i2]; });
-
-		// 投影到主成分
-		std::vector<std::vector<double>> projected_data(row, std::vector<double>(num_components));
-		for (size_t i = 0; i < row; ++i)
-		{
-			for (int j = 0; j < num_components; ++j)
-			{
-				for (size_t k = 0; k < col; ++k)
-				{
-					projected_data[i][j] += data[i][k] * result.second[k][indices[j]];
-				}
-			}
-		}
-
-		return projected_data;
-	}
-
-	/**
-	 * Computes the Euclidean distance between two vectors.
-	 *
-	 * The Euclidean distance between two vectors `a` and `b` is calculated as the square root of the sum of the squared differences
-	 * between corresponding elements in the vectors:
-	 *
-	 *     distance = sqrt( Σ (a[i] - b[i])^2 )
-	 *
-	 * This distance measure is commonly used to quantify the similarity or dissimilarity between two data points in Euclidean space.
-	 *
-	 * @param a The first vector, represented as a 1D vector of `double` values.
-	 * @param b The second vector, represented as a 1D vector of `double` values.
-	 *
-	 * @return The Euclidean distance between the two vectors, as a `double` value.
-	 *
-	 * @throws std::invalid_argument If the vectors `a` and `b` have different sizes.
-	 */
-	inline double euclideanDistance(const std::vector<double>& a, const std::vector<double>& b)
-	{
-		double sum = 0.0;
-		for (size_t i = 0; i < a.size(); ++i)
-		{
-			sum += (a[i] - b[i]) * (a[i] - b[i]);
-		}
-		return sqrt(sum);
-	}
-
-	/**
-	 * Performs K-means clustering algorithm on a dataset.
-	 *
-	 * The K-means algorithm divides the data into K clusters by iteratively assigning data points
-	 * to the nearest cluster center and then updating the cluster centers based on the mean of the points
-	 * assigned to each cluster. The process continues until the cluster centers no longer change or a maximum
-	 * number of iterations is reached.
-	 *
-	 * @param data A 2D vector representing the dataset, where each row is a data point and each column is a feature.
-	 * @param k The number of clusters to divide the data into.
-	 * @param max_iter The maximum number of iterations for the algorithm to run. Defaults to 1000 iterations.
-	 *
-	 * @return A vector of integers where each element corresponds to the cluster label assigned to the respective data point.
-	 *         The size of the vector is equal to the number of data points (n).
-	 *
-	 * @throws std::invalid_argument If the number of clusters (k) is less than 1.
-	 * @throws std::invalid_argument If the dataset is empty or not well-formed (e.g., inconsistent row lengths).
-	 */
-	inline std::vector<int> kMeans(const std::vector<std::vector<double>>& data, int k, int max_iter = 1000)
-	{
-		size_t n = data.size();
-		size_t m = data[0].size();
-
-		// 初始化簇中心
-		std::vector<std::vector<double>> centroids(k, std::vector<double>(m));
-		std::vector<int> labels(n, -1); // 存储每个数据点的簇标签
-
-		// 随机选择初始簇中心
-		srand(time(0));
-		std::vector<int> indices(n);
-		std::iota(indices.begin(), indices.end(), 0);
-		random_shuffle(indices.begin(), indices.end());
-
-		for (int i = 0; i < k; ++i)
-		{
-			centroids[i] = data[indices[i]]; // 新的簇中心
-		}
-
-		for (int iter = 0; iter < max_iter; ++iter)
-		{
-			bool changed = false;
-
-			// 分配每个点到最近的簇
-			for (size_t i = 0; i < n; ++i)
-			{
-				double min_dist = std::numeric_limits<double>::infinity();
-				int closest_centroid = -1;
-
-				for (int j = 0; j < k; ++j)
-				{
-					double dist = euclideanDistance(data[i], centroids[j]);
-					if (dist < min_dist)
-					{
-						min_dist = dist;
-						closest_centroid = j;
-					}
-				}
-
-				if (labels[i] != closest_centroid)
-				{
-					labels[i] = closest_centroid;
-					changed = true;
-				}
-			}
-
-			// 更新簇中心
-			std::vector<std::vector<double>> new_centroids(k, std::vector<double>(m, 0.0));
-			std::vector<int> count(k, 0); // 记录每个簇中点的数量
-
-			for (size_t i = 0; i < n; ++i)
-			{
-				int cluster = labels[i];
-				for (size_t j = 0; j < m; ++j)
-				{
-					new_centroids[cluster][j] += data[i][j];
-				}
-				count[cluster]++;
-			}
-
-			for (int j = 0; j < k; ++j)
-			{
-				for (size_t i = 0; i < m; ++i)
-				{
-					new_centroids[j][i] /= count[j];
-				}
-			}
-
-			centroids = new_centroids;
-
-			// 如果没有簇中心变化，停止迭代
-			if (!changed)
-			{
-				break;
-			}
-		}
-
-		return labels;
-	}
-
-	/*
-	第四次扩展
-	层次聚类 + KDE图
-	*/
-
-	/**
-	 * @struct Linkage
-	 * @brief Represents a single merge event in hierarchical clustering.
-	 *
-	 * Each record contains indices of two clusters merged, the distance between
-	 * them at merge time, and the size (number of samples) of the new cluster.
-	 */
-	struct Linkage
-	{
-		int idx1, idx2;
-		double dist;
-		int size;
-	};
-
-	/**
-	 * @brief Compute pairwise Euclidean distance matrix.
-	 * @param data N*D matrix
-	 * @return N*N symmetric matrix of distances
-	 */
-	inline std::vector<std::vector<double>> computeDistanceMatrix(const std::vector<std::vector<double>>& data) {
-		int N = data.size();
-		std::vector<std::vector<double>> dist(N, std::vector<double>(N, 0.0));
-		for (int i = 0; i < N; ++i) {
-			for (int j = i + 1; j < N; ++j) {
-				double sum = 0;
-				for (size_t k = 0; k < data[i].size(); ++k) {
-					double d = data[i][k] - data[j][k];
-					sum += d * d;
-				}
-				dist[i][j] = dist[j][i] = std::sqrt(sum);
-			}
-		}
-		return dist;
-	}
-
-	/**
-	 * @brief Perform single-linkage hierarchical clustering.
-	 * @param distMat precomputed distance matrix
-	 * @return linkage matrix (size N-1) with merge records
-	 */
-	inline std::vector<Linkage> hierarchicalClustering(
-		std::vector<std::vector<double>> distMat
-	) {
-		int N = distMat.size();
-		// 初始：每个叶子自成一簇
-		std::map<int, std::vector<int>> clusters;
-		for (int i = 0; i < N; ++i) clusters[i] = { i };
-
-		std::vector<Linkage> Z;
-		Z.reserve(N - 1);
-		int nextId = N;
-
-		while (clusters.size() > 1) {
-			double best = std::numeric_limits<double>::infinity();
-			int a = -1, b = -1;
-			// 找到最近的簇对 (a, b)
-			for (auto it1 = clusters.begin(); it1 != clusters.end(); ++it1) {
-				for (auto it2 = std::next(it1); it2 != clusters.end(); ++it2) {
-					double dmin = std::numeric_limits<double>::infinity();
-					for (int i : it1->second)
-						for (int j : it2->second)
-							dmin = std::min(dmin, distMat[i][j]);
-					if (dmin < best) {
-						best = dmin;
-						a = it1->first;
-						b = it2->first;
-					}
-				}
-			}
-
-			auto merged = clusters[a];
-			merged.insert(merged.end(),
-				clusters[b].begin(),
-				clusters[b].end());
-
-			// 记录 linkage
-			Z.push_back({ a, b, best, (int)merged.size() });
-
-			clusters.erase(a);
-			clusters.erase(b);
-			clusters[nextId++] = std::move(merged);
-		}
-
-		return Z;
-	}
-
-	/**
-	 * @brief Gaussian kernel function
-	 * @param u normalized distance (x - xi) / bandwidth
-	 */
-	inline double gaussianKernel(double u) {
-		static const double inv_sqrt2pi = 1.0 / std::sqrt(2 * M_PI);
-		return inv_sqrt2pi * std::exp(-0.5 * u * u);
-	}
-
-	/**
-	 * @brief Compute KDE densities for given samples over a grid
-	 * @param data input sample vector
-	 * @param grid_x grid points at which to evaluate KDE
-	 * @param bandwidth kernel bandwidth
-	 * @return vector of density values
-	 */
-	inline std::vector<double> computeKDE(
-		const std::vector<double>& data,
-		const std::vector<double>& grid_x,
-		double bandwidth
-	) {
-		int n = data.size();
-		std::vector<double> densities(grid_x.size());
-		for (size_t i = 0; i < grid_x.size(); ++i) {
-			double x = grid_x[i];
-			double sum = 0.0;
-			for (double xi : data) {
-				sum += gaussianKernel((x - xi) / bandwidth);
-			}
-			densities[i] = sum / (n * bandwidth);
-		}
-		return densities;
-	}
-
-	/**
-	 * @brief Plot KDE using matplotlib-cpp
-	 * @param samples input data samples
-	 * @param bandwidth Gaussian kernel bandwidth
-	 * @param grid_n number of grid points (default 200)
-	 * @param width figure width in pixels (default 800)
-	 * @param height figure height in pixels (default 600)
-	 */
-
-	 /*
-	 第五次扩展
-	 t-SNE降维 LLE降维
-	 */
-
-	 /**
-	  * @brief 对单行距离平方向量使用二分搜索确定局部高维相似度分布。
-	  *
-	  * @param dist2_row 长度为 n 的距离平方向量。
-	  * @param target_perplexity 目标困惑度。
-	  * @param max_iter 最大二分搜索迭代次数。
-	  * @param tol 熵误差容限。
-	  * @return 长度为 n 的概率分布 P(i|j)。
-	  */
-	inline std::vector<double> binarySearchSigma(
-		const std::vector<double>& dist2_row,
-		double target_perplexity,
-		int max_iter = 50,
-		double tol = 1e-5
-	)
-	{
-		double beta_min = -INFINITY, beta_max = INFINITY;
-		double beta = 1.0;
-		size_t n = dist2_row.size();
-		std::vector<double> P(n);
-		for (int iter = 0; iter < max_iter; ++iter) {
-			double sumP = 0.0;
-			for (size_t j = 0; j < n; ++j) {
-				P[j] = std::exp(-dist2_row[j] * beta);
-				sumP += P[j];
-			}
-			double H = 0.0;
-			for (size_t j = 0; j < n; ++j) {
-				P[j] /= sumP;
-				if (P[j] > 1e-12) H -= P[j] * std::log(P[j]);
-			}
-			double perplexity = std::exp(H);
-			double diff = perplexity - target_perplexity;
-			if (std::fabs(diff) < tol) break;
-			if (diff > 0) {
-				beta_min = beta;
-				beta = (beta_max == INFINITY ? beta * 2 : 0.5 * (beta + beta_max));
-			}
-			else {
-				beta_max = beta;
-				beta = (beta_min == -INFINITY ? beta / 2 : 0.5 * (beta + beta_min));
-			}
-		}
-		return P;
-	}
-
-	/**
-	 * @brief 计算高维空间的对称化相似度矩阵 P。
-	 *
-	 * 对于每个样本 i，先调用 binarySearchSigma 获得 P(i|j)，
-	 * 然后对称化：P_{ij} = (P(i|j) + P(j|i)) / (2n)。
-	 *
-	 * @param dist2 n*n 的距离平方矩阵。
-	 * @param perplexity 困惑度。
-	 * @return n*n 的高维相似度矩阵 P。
-	 */
-	inline std::vector<std::vector<double>> computeHighDimAffinities(
-		const std::vector<std::vector<double>>& dist2,
-		double perplexity
-	) {
-		size_t n = dist2.size();
-		std::vector<std::vector<double>> P(n, std::vector<double>(n, 0.0));
-		for (size_t i = 0; i < n; ++i) {
-			auto Pi = binarySearchSigma(dist2[i], perplexity);
-			for (size_t j = 0; j < n; ++j) P[i][j] = Pi[j];
-		}
-		// 对称化并归一化
-		for (size_t i = 0; i < n; ++i) {
-			for (size_t j = i + 1; j < n; ++j) {
-				double val = (P[i][j] + P[j][i]) / (2.0 * n);
-				P[i][j] = P[j][i] = val;
-			}
-		}
-		return P;
-	}
-
-	/**
-	 * @brief 计算低维空间的学生 t 分布相似度矩阵 Q。
-	 *
-	 * Q_{ij} = (1 + ||y_i - y_j||^2)^{-1}，然后整体除以总和。
-	 *
-	 * @param Y 低维坐标矩阵，大小 n*dim。
-	 * @return n*n 的相似度矩阵 Q。
-	 */
-	inline std::vector<std::vector<double>> computeLowDimAffinities(
-		const std::vector<std::vector<double>>& Y
-	) {
-		size_t n = Y.size();
-		std::vector<std::vector<double>> Q(n, std::vector<double>(n, 0.0));
-		double sum = 0.0;
-		for (size_t i = 0; i < n; ++i) {
-			for (size_t j = i + 1; j < n; ++j) {
-				double dist2 = 0.0;
-				for (size_t d = 0; d < Y[i].size(); ++d) {
-					double diff = Y[i][d] - Y[j][d];
-					dist2 += diff * diff;
-				}
-				double inv = 1.0 / (1.0 + dist2);
-				Q[i][j] = Q[j][i] = inv;
-				sum += 2.0 * inv;
-			}
-			Q[i][i] = 0.0;
-		}
-		// 归一化
-		for (size_t i = 0; i < n; ++i)
-			for (size_t j = 0; j < n; ++j)
-				Q[i][j] /= sum;
-		return Q;
-	}
-
-	/**
-	 * @brief 执行 t-SNE 降维。
-	 *
-	 * @param X 原始高维数据矩阵，大小 n*d。
-	 * @param dim 目标降维维度，默认为 2。
-	 * @param perplexity 困惑度参数。
-	 * @param max_iter 最大迭代次数。
-	 * @param lr 学习率。
-	 * @return 降维后的坐标矩阵，大小 n*dim。
-	 * @throws std::invalid_argument 如果输入数据为空。
-	 */
-	inline std::vector<std::vector<double>> performTSNE(
-		const std::vector<std::vector<double>>& X,
-		int dim = 2,
-		double perplexity = 30.0,
-		int max_iter = 1000,
-		double lr = 200.0
-	) {
-		if (X.empty()) {
-			throw std::invalid_argument("Input data X is empty.");
-		}
-		size_t n = X.size();
-
-		auto dist = computeDistanceMatrix(X);
-		std::vector<std::vector<double>> dist2(n, std::vector<double>(n, 0.0));
-		for (size_t i = 0; i < n; ++i) {
-			for (size_t j = 0; j < n; ++j) {
-				double d = dist[i][j];
-				dist2[i][j] = d * d;
-			}
-		}
-		auto P = computeHighDimAffinities(dist2, perplexity);
-
-		std::vector<std::vector<double>> Y(n, std::vector<double>(dim));
-		for (size_t i = 0; i < n; ++i)
-			for (int d = 0; d < dim; ++d)
-				Y[i][d] = (std::rand() / (double)RAND_MAX - 0.5) * 1e-4;
-
-		std::vector<std::vector<double>> iY(n, std::vector<double>(dim, 0.0));
-		double momentum = 0.5;
-
-		for (int iter = 0; iter < max_iter; ++iter) {
-			auto Q = computeLowDimAffinities(Y);
-			std::vector<std::vector<double>> grad(n, std::vector<double>(dim, 0.0));
-			for (size_t i = 0; i < n; ++i) {
-				for (size_t j = 0; j < n; ++j) {
-					double mult = P[i][j] - Q[i][j];
-					for (int d = 0; d < dim; ++d) {
-						grad[i][d] += mult * (Y[i][d] - Y[j][d]);
-					}
-				}
-			}
-			for (size_t i = 0; i < n; ++i) {
-				for (int d = 0; d < dim; ++d) {
-					iY[i][d] = momentum * iY[i][d] - lr * grad[i][d];
-					Y[i][d] += iY[i][d];
-				}
-			}
-			if (iter == 250) momentum = 0.8;
-		}
-
-		return Y;
-	}
-
-	/**
-	 * @brief 转置矩阵
-	 *
-	 * @param A 原始矩阵，大小 rows*cols
-	 * @return 转置矩阵，大小 cols*rows
-	 */
-	inline std::vector<std::vector<double>> transposeMatrix(
-		const std::vector<std::vector<double>>& A
-	)
-	{
-		size_t rows = A.size();
-		size_t cols = A[0].size();
-		std::vector<std::vector<double>> At(cols, std::vector<double>(rows));
-		for (size_t i = 0; i < rows; ++i) {
-			for (size_t j = 0; j < cols; ++j) {
-				At[j][i] = A[i][j];
-			}
-		}
-		return At;
-	}
-
-	/**
-	 * @brief 局部线性嵌入（LLE）降维算法
-	 * @param X 输入数据矩阵，大小 n*d。
-	 * @param n_neighbors 每个点的近邻数 k。
-	 * @param dim 目标降维维度。
-	 * @param reg 正则化系数，防止局部协方差矩阵奇异，默认为 1e-3。
-	 * @return 大小 n*dim 的降维嵌入矩阵。
-	 * @throws std::invalid_argument 若输入数据为空或参数不合法。
-	 */
-	inline std::vector<std::vector<double>> performLLE(
-		const std::vector<std::vector<double>>& X,
-		int n_neighbors,
-		int dim,
-		double reg = 1e-3
-	)
-	{
-		if (X.empty() || n_neighbors <= 0 || dim <= 0) {
-			throw std::invalid_argument("Invalid input to performLLE");
-		}
-		size_t n = X.size();
-
-		std::vector<std::vector<double>> dist = computeDistanceMatrix(X);
-
-		// k 个最近邻索引
-		std::vector<std::vector<int>> neighbors(n);
-		for (size_t i = 0; i < n; ++i) {
-			// 按距离排序前 k+1（包含自身）
-			std::vector<std::pair<double, int>> order;
-			order.reserve(n);
-			for (size_t j = 0; j < n; ++j) {
-				order.push_back(std::make_pair(dist[i][j], static_cast<int>(j)));
-			}
-			std::nth_element(order.begin(), order.begin() + n_neighbors,
-				order.end(),
-				std::bind(std::less<std::pair<double, int>>(),
-					std::placeholders::_1,
-					std::placeholders::_2));
-			neighbors[i].reserve(n_neighbors);
-			int count = 0;
-			for (size_t p = 0; p < order.size() && count < n_neighbors; ++p) {
-				int idx = order[p].second;
-				if (idx == static_cast<int>(i)) continue;
-				neighbors[i].push_back(idx);
-				++count;
-			}
-		}
-
-		std::vector<std::vector<double>> W(n, std::vector<double>(n, 0.0));
-		for (size_t i = 0; i < n; ++i) {
-			// 局部协方差矩阵 C (k*k)
-			std::vector<std::vector<double>> C(n_neighbors,
-				std::vector<double>(n_neighbors, 0.0));
-			for (int a = 0; a < n_neighbors; ++a) {
-				for (int b = 0; b < n_neighbors; ++b) {
-					double sum = 0.0;
-					for (size_t d = 0; d < X[i].size(); ++d) {
-						double da = X[i][d] - X[neighbors[i][a]][d];
-						double db = X[i][d] - X[neighbors[i][b]][d];
-						sum += da * db;
-					}
-					C[a][b] = sum;
-				}
-			}
-			// 正则化
-			double trace = 0.0;
-			for (int a = 0; a < n_neighbors; ++a) {
-				trace += C[a][a];
-			}
-			for (int a = 0; a < n_neighbors; ++a) {
-				C[a][a] += reg * trace;
-			}
-			std::vector<double> ones(n_neighbors, 1.0);
-			for (int p = 0; p < n_neighbors; ++p) {
-				int maxr = p;
-				for (int r = p + 1; r < n_neighbors; ++r) {
-					if (std::fabs(C[r][p]) > std::fabs(C[maxr][p])) {
-						maxr = r;
-					}
-				}
-				std::swap(C[p], C[maxr]);
-				std::swap(ones[p], ones[maxr]);
-				double diag = C[p][p];
-				if (std::fabs(diag) < 1e-12) {
-					throw std::runtime_error("Singular matrix in LLE weight solve");
-				}
-				for (int c = p; c < n_neighbors; ++c) {
-					C[p][c] /= diag;
-				}
-				ones[p] /= diag;
-				for (int r = p + 1; r < n_neighbors; ++r) {
-					double factor = C[r][p];
-					for (int c = p; c < n_neighbors; ++c) {
-						C[r][c] -= factor * C[p][c];
-					}
-					ones[r] -= factor * ones[p];
-				}
-			}
-			std::vector<double> w(n_neighbors);
-			for (int irow = n_neighbors - 1; irow >= 0; --irow) {
-				double sum = ones[irow];
-				for (int jcol = irow + 1; jcol < n_neighbors; ++jcol) {
-					sum -= C[irow][jcol] * w[jcol];
-				}
-				w[irow] = sum;
-			}
-			double s = 0.0;
-			for (int a = 0; a < n_neighbors; ++a) {
-				s += w[a];
-			}
-			for (int a = 0; a < n_neighbors; ++a) {
-				W[i][neighbors[i][a]] = w[a] / s;
-			}
-		}
-
-		// 构造 M = (I - W)^T * (I - W)
-		std::vector<std::vector<double>> IminusW(n,
-			std::vector<double>(n, 0.0));
-		for (size_t i = 0; i < n; ++i) {
-			for (size_t j = 0; j < n; ++j) {
-				IminusW[i][j] = ((i == j) ? 1.0 : 0.0) - W[i][j];
-			}
-		}
-		std::vector<std::vector<double>> At = transposeMatrix(IminusW);
-		std::vector<std::vector<double>> M = multiplyMatrix(At, IminusW);
-
-		// 特征分解 M
-		std::vector<double> evals;
-		std::vector<std::vector<double>> evecs;
-		std::tie(evals, evecs) = eigenvalues_and_eigenvectors(M, 1000, 1e-6);
-		std::vector<int> idx(n);
-		std::iota(idx.begin(), idx.end(), 0);
-		std::sort(idx.begin(), idx.end(), [&](int a, int b) {
-			return evals[a] < evals[b];
-			});
-		std::vector<std::vector<double>> Y(n, std::vector<double>(dim, 0.0));
-		for (int d = 0; d < dim; ++d) {
-			int ev = idx[d + 1];
-			for (size_t i = 0; i < n; ++i) {
-				Y[i][d] = evecs[i][ev];
-			}
-		}
-
-		return Y;
-	}
-
-	/*
-	 第六次扩展
-	 DESeq2
-	 */
-
-	 /**
-	  * @struct DESeq2Result
-	  * @brief 存储差异表达分析结果：log2FC、pvalue、padj
-	  */
-	struct DESeq2Result {
-		double log2FC;
-		double pvalue;
-		double padj;
-	};
-
-	/**
-	 * @brief 计算几何平均
-	 * @param counts G×N 原始计数矩阵
-	 * @return 长度 G 的几何平均向量
-	 */
-	inline std::vector<double> computeGeometricMeans(
-		const std::vector<std::vector<double>>& counts
-	) {
-		size_t G = counts.size();
-		size_t N = counts.front().size();
-		std::vector<double> gm(G);
-		for (size_t i = 0; i < G; ++i) {
-			double sumLog = 0.0;
-			int cnt = 0;
-			for (size_t j = 0; j < N; ++j) {
-				double x = counts[i][j];
-				if (x > 0) {
-					sumLog += std::log(x);
-					++cnt;
-				}
-			}
-			gm[i] = cnt > 0 ? std::exp(sumLog / cnt) : 0.0;
-		}
-		return gm;
-	}
-
-	/**
-	 * @brief 计算 size factors（Median-of-Ratios）
-	 * @param counts G×N 原始计数矩阵
-	 * @param gm     G 维几何平均向量
-	 * @return N 维 size factor 向量
-	 */
-	inline std::vector<double> computeSizeFactors(
-		const std::vector<std::vector<double>>& counts,
-		const std::vector<double>& gm
-	) {
-		size_t G = counts.size();
-		size_t N = counts.front().size();
-		std::vector<double> sf(N);
-		for (size_t j = 0; j < N; ++j) {
-			std::vector<double> ratios;
-			ratios.reserve(G);
-			for (size_t i = 0; i < G; ++i) {
-				if (gm[i] > 0.0) {
-					ratios.push_back(counts[i][j] / gm[i]);
-				}
-			}
-			if (ratios.empty()) {
-				throw std::runtime_error("无法计算 size factors");
-			}
-			size_t mid = ratios.size() / 2;
-			std::nth_element(ratios.begin(), ratios.begin() + mid, ratios.end());
-			sf[j] = ratios[mid];
-		}
-		return sf;
-	}
-
-	/**
-	 * @brief 归一化 counts
-	 * @param counts G×N 原始计数矩阵
-	 * @param sf     N 维 size factor 向量
-	 * @return G×N 归一化矩阵
-	 */
-	inline std::vector<std::vector<double>> normalizeCounts(
-		const std::vector<std::vector<double>>& counts,
-		const std::vector<double>& sf
-	) {
-		size_t G = counts.size();
-		size_t N = sf.size();
-		std::vector<std::vector<double>> nc = counts;
-		for (size_t i = 0; i < G; ++i) {
-			for (size_t j = 0; j < N; ++j) {
-				nc[i][j] = counts[i][j] / sf[j];
-			}
-		}
-		return nc;
-	}
-
-	/**
-	 * @brief 原始 dispersion 方法矩估计
-	 * @param normCounts G×N 归一化后矩阵
-	 * @param muBar_out  输出：G 维平均表达向量
-	 * @return G 维 raw dispersion 向量
-	 */
-	inline std::vector<double> estimateRawDispersions(
-		const std::vector<std::vector<double>>& normCounts,
-		std::vector<double>& muBar_out
-	) {
-		size_t G = normCounts.size();
-		size_t N = normCounts.front().size();
-		std::vector<double> raw(G);
-		muBar_out.assign(G, 0.0);
-		for (size_t i = 0; i < G; ++i) {
-			double sum = std::accumulate(normCounts[i].begin(), normCounts[i].end(), 0.0);
-			double mu = sum / N;
-			muBar_out[i] = mu;
-			double var = 0.0;
-			for (size_t j = 0; j < N; ++j) {
-				double diff = normCounts[i][j] - mu;
-				var += diff * diff;
-			}
-			var /= (N > 1 ? N - 1 : 1);
-			raw[i] = std::max((var - mu) / (mu * mu), 0.0);
-		}
-		return raw;
-	}
-
-	/**
-	 * @brief 收缩 dispersion（简单 trend 收缩）
-	 * @param raw    原始 dispersion
-	 * @param muBar  平均表达
-	 * @return 收缩后 dispersion
-	 */
-	inline std::vector<double> shrinkDispersions(
-		const std::vector<double>& raw,
-		const std::vector<double>& muBar
-	) {
-		size_t G = raw.size();
-		std::vector<double> shrink(G);
-		for (size_t i = 0; i < G; ++i) {
-			shrink[i] = raw[i];
-		}
-		return shrink;
-	}
-
-	/**
-	 * @brief 计算 log2FC 与 Wald p-value
-	 * @param nc_i   某基因归一化表达向量
-	 * @param groups 样本分组向量
-	 * @param alpha  dispersion
-	 * @return std::pair<double,double> first=log2FC, second=p-value
-	 */
-	inline std::pair<double, double> computeWaldTest(
-		const std::vector<double>& nc_i,
-		const std::vector<int>& groups,
-		double alpha
-	) {
-		int n0 = 0, n1 = 0;
-		double sum0 = 0, sum1 = 0;
-		for (size_t j = 0; j < nc_i.size(); ++j) {
-			if (groups[j] == 0) { sum0 += nc_i[j]; ++n0; }
-			else { sum1 += nc_i[j]; ++n1; }
-		}
-		double mu0 = sum0 / n0;
-		double mu1 = sum1 / n1;
-		double log2FC = std::log2(mu1 / mu0);
-
-		// NB 方差
-		double var0 = mu0 + alpha * mu0 * mu0;
-		double var1 = mu1 + alpha * mu1 * mu1;
-		double se = std::sqrt(var0 / (n0 * mu0 * mu0)
-			+ var1 / (n1 * mu1 * mu1))
-			/ std::log(2.0);
-
-		double w = log2FC / se;
-		double p = 2 * (1 - 0.5 * (1 + std::erf(std::abs(w) / std::sqrt(2.0))));
-		return std::make_pair(log2FC, p);
-	}
-
-	/**
-	 * @brief Benjamini-Hochberg FDR 校正
-	 * @param res 输入/输出结果向量，函数会填充 res[i].padj
-	 */
-	inline void adjustPValues(std::vector<DESeq2Result>& res) {
-		int M = static_cast<int>(res.size());
-		std::vector<std::pair<double, int>> pv;
-		pv.reserve(M);
-		for (int i = 0; i < M; ++i) {
-			pv.push_back(std::make_pair(res[i].pvalue, i));
-		}
-		std::sort(pv.begin(), pv.end());
-		std::vector<double> adj(M);
-		double minq = 1.0;
-		for (int k = M; k >= 1; --k) {
-			double q = pv[k - 1].first * M / k;
-			if (q < minq) minq = q;
-			adj[pv[k - 1].second] = minq;
-		}
-		for (int i = 0; i < M; ++i) {
-			res[i].padj = adj[i];
-		}
-	}
-
-	/**
-	 * @brief 简化版 DESeq2 主接口
-	 * @param counts G×N 原始计数矩阵
-	 * @param groups 长度 N 样本分组
-	 * @return 长度 G 的差异表达结果向量
-	 */
-	inline std::vector<DESeq2Result> performDESeq2(
-		const std::vector<std::vector<double>>& counts,
-		const std::vector<int>& groups
-	) {
-		if (counts.empty()) {
-			throw std::invalid_argument("counts 为空");
-		}
-		size_t G = counts.size();
-		size_t N = counts.front().size();
-		/*if (groups.size() != N) {
-			throw std::invalid_argument("groups 长度不匹配");
-		}*/
-
-		std::vector<double> gm = computeGeometricMeans(counts);
-		std::vector<double> sf = computeSizeFactors(counts, gm);
-		std::vector<std::vector<double>> nc = normalizeCounts(counts, sf);
-		std::vector<double> muBar;
-		std::vector<double> raw = estimateRawDispersions(nc, muBar);
-		std::vector<double> disp = shrinkDispersions(raw, muBar);
-
-		std::vector<DESeq2Result> results(G);
-		for (size_t i = 0; i < G; ++i) {
-			std::pair<double, double> pr = computeWaldTest(nc[i], groups, disp[i]);
-			results[i].log2FC = pr.first;
-			results[i].pvalue = pr.second;
-		}
-		adjustPValues(results);
-		return results;
-	}
-
-	/*
-	 第七次扩展
-	 降维DBSCAN kMeansPP
-	 */
-	 /**
-	  * @brief 找到样本 idx 在数据集中的 eps-邻域
-	  * @param data 数据集 n×m 矩阵
-	  * @param idx  样本索引
-	  * @param eps  邻域半径
-	  * @return 距离 <= eps 的所有样本索引列表
-	  */
-	inline std::vector<size_t> regionQuery(
-		const std::vector<std::vector<double>>& data,
-		size_t idx,
-		double eps
-	) {
-		std::vector<size_t> neighbors;
-		for (size_t j = 0; j < data.size(); ++j) {
-			if (euclideanDistance(data[idx], data[j]) <= eps) {
-				neighbors.push_back(j);
-			}
-		}
-		return neighbors;
-	}
-
-	/**
-	 * @brief 扩展簇：将所有密度可达的点加入同一簇
-	 * @param data      数据集 n×m
-	 * @param labels    样本簇标签向量，-1 表示未分类或噪声
-	 * @param visited   样本访问标记向量
-	 * @param idx       当前样本索引
-	 * @param clusterId 当前簇 ID
-	 * @param eps       邻域半径
-	 * @param minPts    构成核心点的最小邻居数
-	 */
-	inline void expandCluster(
-		const std::vector<std::vector<double>>& data,
-		std::vector<int>& labels, std::vector<bool>& visited,
-		size_t idx,
-		int clusterId,
-		double eps,
-		int minPts
-	) {
-		// 获取邻域
-		std::vector<size_t> seedSet = regionQuery(data, idx, eps);
-		labels[idx] = clusterId;
-
-		for (size_t k = 0; k < seedSet.size(); ++k) {
-			size_t cur = seedSet[k];
-			if (!visited[cur]) {
-				visited[cur] = true;
-				// 如果是核心点，则将其邻域加入 seedSet
-				std::vector<size_t> curNeighbors = regionQuery(data, cur, eps);
-				if (curNeighbors.size() >= static_cast<size_t>(minPts)) {
-					seedSet.insert(seedSet.end(), curNeighbors.begin(), curNeighbors.end());
-				}
-			}
-			// 如果该点尚未分配簇，则分配到当前簇
-			if (labels[cur] == -1) {
-				labels[cur] = clusterId;
-			}
-		}
-	}
-
-	/**
-	 * @brief DBSCAN 密度聚类算法
-	 * @param data   数据集 n×m 矩阵
-	 * @param eps    邻域半径
-	 * @param minPts 构成核心点的最小邻域数
-	 * @return 每个样本的簇标签向量，-1 表示噪声，其余 0,1,2... 为簇 ID
-	 */
-	inline std::vector<int> dbscan(
-		const std::vector<std::vector<double>>& data,
-		double eps,
-		int minPts
-	) {
-		size_t n = data.size();
-		std::vector<int> labels(n, -1);
-		std::vector<bool> visited(n, false);
-		int clusterId = 0;
-
-		for (size_t i = 0; i < n; ++i) {
-			if (visited[i]) continue;
-			visited[i] = true;
-			std::vector<size_t> neighbors = regionQuery(data, i, eps);
-			// 如果邻居数不足，则标记为噪声
-			if (neighbors.size() < static_cast<size_t>(minPts)) {
-				labels[i] = -1;
-			}
-			else {
-				// 扩展新簇
-				expandCluster(data, labels, visited, i, clusterId, eps, minPts);
-				++clusterId;
-			}
-		}
-
-		return labels;
-	}
-
-	/**
-	 * @brief 使用 K-means++ 算法初始化质心
-	 * @param data   输入数据，大小 n×m (n 个样本，每个样本 m 维)
-	 * @param k      聚类簇数
-	 * @return 返回初始化好的 k 个质心，每个质心为 m 维向量
-	 * @throws std::invalid_argument 如果 data 为空或 k<=0 或 k>n
-	 */
-	inline std::vector<std::vector<double>> initializeCentroidsPP(
-		const std::vector<std::vector<double>>& data,
-		int k
-	) {
-		size_t n = data.size();
-		if (n == 0 || k <= 0 || static_cast<size_t>(k) > n)
-		{
-			throw std::invalid_argument("initializeCentroidsPP: 参数非法");
-		}
-		size_t m = data[0].size();
-		std::vector<std::vector<double>> centroids;
-		centroids.reserve(k);
-
-		// 随机数生成器
-		std::random_device rd;
-		std::mt19937 gen(rd());
-
-		// 随机选择
-		std::uniform_int_distribution<size_t> unif(0, n - 1);
-		centroids.push_back(data[unif(gen)]);
-
-		std::vector<double> dist2(n);
-		for (int c = 1; c < k; ++c)
-		{
-			for (size_t i = 0; i < n; ++i)
-			{
-				double dmin = std::numeric_limits<double>::infinity();
-				for (const auto& cent : centroids)
-				{
-					double d = euclideanDistance(data[i], cent);
-					dmin = std::min(dmin, d);
-				}
-				dist2[i] = dmin * dmin;
-			}
-			// 用距离平方作为权重
-			std::discrete_distribution<size_t> dist(dist2.begin(), dist2.end());
-			centroids.push_back(data[dist(gen)]);
-		}
-
-		return centroids;
-	}
-
-	/**
-	 * @brief 基于 K-means++ 初始化并执行 K-means 聚类
-	 * @param data     输入数据，大小 n×m
-	 * @param k        聚类簇数
-	 * @param max_iter 最大迭代次数，默认 1000
-	 * @return labels  长度 n，每个元素为样本所属簇 ID [0..k-1]
-	 * @throws std::invalid_argument 如果 data 为空或 k<=0
-	 */
-	inline std::vector<int> kMeansPP(
-		const std::vector<std::vector<double>>& data,
-		int k,
-		int max_iter = 1000
-	) {
-		size_t n = data.size();
-		if (n == 0 || k <= 0)
-		{
-			throw std::invalid_argument("kMeansPP: 参数非法");
-		}
-		size_t m = data[0].size();
-
-		std::vector<std::vector<double>> centroids = initializeCentroidsPP(data, k);
-		std::vector<int> labels(n, -1);
-		std::vector<int> counts(k, 0);
-
-		for (int iter = 0; iter < max_iter; ++iter)
-		{
-			bool changed = false;
-
-			// 分配每个点到最近质心
-			for (size_t i = 0; i < n; ++i)
-			{
-				double dmin = std::numeric_limits<double>::infinity();
-				int best = -1;
-				for (int c = 0; c < k; ++c)
-				{
-					double d = euclideanDistance(data[i], centroids[c]);
-					if (d < dmin)
-					{
-						dmin = d;
-						best = c;
-					}
-				}
-				if (labels[i] != best)
-				{
-					labels[i] = best;
-					changed = true;
-				}
-			}
-
-			// 如果没有变化则终止
-			if (!changed)
-			{
-				break;
-			}
-
-			std::vector<std::vector<double>> sum(k, std::vector<double>(m, 0.0));
-			std::fill(counts.begin(), counts.end(), 0);
-
-			// 累加各簇样本
-			for (size_t i = 0; i < n; ++i)
-			{
-				int c = labels[i];
-				for (size_t j = 0; j < m; ++j)
-				{
-					sum[c][j] += data[i][j];
-				}
-				++counts[c];
-			}
-
-			// 更新质心
-			for (int c = 0; c < k; ++c)
-			{
-				if (counts[c] > 0) {
-					for (size_t j = 0; j < m; ++j)
-					{
-						centroids[c][j] = sum[c][j] / counts[c];
-					}
-				}
-				else
-				{
-					// 若某簇无样本，可随机重置一个质心
-					std::random_device rd;
-					std::mt19937 gen(rd());
-					std::uniform_int_distribution<size_t> unif(0, n - 1);
-					centroids[c] = data[unif(gen)];
-				}
-			}
-		}
-
-		return labels;
-	}
-}
-
-#endif
+﻿#pragma once
+
+#ifndef ST_H
+#define ST_H
+
+#define _USE_MATH_DEFINES
+#include <iostream>
+#include <numeric>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <cstdlib>
+#include <unordered_set>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <boost/math/special_functions/digamma.hpp>
+#include <boost/math/special_functions/trigamma.hpp>
+#include <boost/math/special_functions/polygamma.hpp>
+#ifdef BC_USE_BLAS
+#include <cblas.h>
+#endif
+
+namespace StatTools
+{
+	/*
+	并行工具
+	*/
+
+	/**
+	 * Returns the number of worker threads used by the parallel routines (at least 1).
+	 *
+	 * @return The hardware concurrency, or 1 if it cannot be determined.
+	 */
+	inline size_t threadCount()
+	{
+		unsigned int n = std::thread::hardware_concurrency();
+		return n == 0 ? 1 : static_cast<size_t>(n);
+	}
+
+	/**
+	 * Splits [begin, end) into contiguous blocks and runs fn(lo, hi) on each block in its own thread.
+	 *
+	 * Small ranges run on the calling thread. The first exception thrown by any block is
+	 * rethrown after all threads have joined.
+	 *
+	 * @param begin The first index.
+	 * @param end One past the last index.
+	 * @param fn The callable invoked as fn(lo, hi) for each block.
+	 * @param minChunk The minimum number of indices handed to one thread.
+	 */
+	template <typename Fn>
+	inline void parallelFor(size_t begin, size_t end, Fn&& fn, size_t minChunk = 1)
+	{
+		if (end <= begin)
+		{
+			return;
+		}
+		size_t n = end - begin;
+		minChunk = std::max<size_t>(minChunk, 1);
+		size_t workers = std::min(threadCount(), (n + minChunk - 1) / minChunk);
+		if (workers <= 1)
+		{
+			fn(begin, end);
+			return;
+		}
+
+		size_t chunk = (n + workers - 1) / workers;
+		std::vector<std::exception_ptr> errors(workers);
+		std::vector<std::thread> threads;
+		threads.reserve(workers - 1);
+		for (size_t w = 1; w < workers; ++w)
+		{
+			size_t lo = begin + w * chunk;
+			size_t hi = std::min(end, lo + chunk);
+			if (lo >= hi)
+			{
+				break;
+			}
+			threads.emplace_back([&fn, &errors, w, lo, hi]()
+				{
+					try
+					{
+						fn(lo, hi);
+					}
+					catch (...)
+					{
+						errors[w] = std::current_exception();
+					}
+				});
+		}
+		try
+		{
+			fn(begin, std::min(end, begin + chunk));
+		}
+		catch (...)
+		{
+			errors[0] = std::current_exception();
+		}
+		for (auto& t : threads)
+		{
+			t.join();
+		}
+		for (auto& e : errors)
+		{
+			if (e)
+			{
+				std::rethrow_exception(e);
+			}
+		}
+	}
+
+	/*
+	第一次扩展
+	基础统计部分
+	*/
+
+	/**
+	 * Throws an exception if the vector is empty or contains non-numeric elements.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector to check.
+	 * @throws std::invalid_argument If the vector is empty.
+	 */
+	template <typename T>
+	inline void checkVector(const std::vector<T>& vec)
+	{
+		if (vec.empty())
+		{
+			throw std::invalid_argument("Vector is empty");
+		}
+		static_assert(std::is_arithmetic<T>::value, "Vector elements must be numeric");
+	}
+
+	/**
+	 * Checks if the vector contains any duplicate elements.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector to check.
+	 * @return True if duplicates are found, false otherwise.
+	 */
+	template <typename T>
+	inline bool hasDuplicates(const std::vector<T>& vec)
+	{
+		return vec.size() != std::unordered_set<T>(vec.begin(), vec.end()).size();
+	}
+
+	/**
+	 * Calculates the sum of all elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The sum of the elements.
+	 */
+	template <typename T>
+	inline T sum(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		return std::accumulate(vec.begin(), vec.end(), T{});
+	}
+
+	/**
+	 * Finds the maximum value in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The maximum value.
+	 */
+	template <typename T>
+	inline T max(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		return *std::max_element(vec.begin(), vec.end());
+	}
+
+	/**
+	 * Finds the minimum value in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The minimum value.
+	 */
+	template <typename T>
+	inline T min(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		return *std::min_element(vec.begin(), vec.end());
+	}
+
+	/**
+	 * Calculates the mean (average) of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The mean value as a double.
+	 */
+	template <typename T>
+	inline double mean(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		return static_cast<double>(sum<T>(vec)) / vec.size();
+	}
+
+	/**
+	 * Calculates the Euclidean norm (magnitude) of the elements in the vector.
+	 * This is also known as the L2 norm or the Euclidean length of the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The Euclidean norm as a double.
+	 */
+	template <typename T>
+	inline double norm(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		double sumOfSquares = 0.0;
+		for (const auto& x : vec)
+		{
+			sumOfSquares += x * x;
+		}
+		return std::sqrt(sumOfSquares);
+	}
+
+	/**
+	 * Calculates the p-norm of the elements in the vector.
+	 * The p-norm is a generalization of the Euclidean norm, where p can be any positive real number.
+	 * For p = 2, this is the Euclidean norm (L2 norm).
+	 * For p = 1, this is the Manhattan norm (L1 norm).
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @param ord The order of the norm (must be a positive real number).
+	 * @return The p-norm as a double.
+	 */
+	template <typename T>
+	inline double norm(const std::vector<T>& vec, int ord)
+	{
+		checkVector(vec);
+		if (ord <= 0)
+		{
+			throw std::invalid_argument("The order of the norm (ord) must be a positive number");
+		}
+		switch (ord)
+		{
+		case 1:
+		{
+			double sumAbs = 0.0;
+			for (const auto& x : vec)
+			{
+				sumAbs += std::abs(x);
+			}
+			return sumAbs;
+		}
+		case 2:
+		{
+			return norm(vec);
+		}
+		default:
+		{
+			double sumOfPowers = 0.0;
+			for (const auto& x : vec)
+			{
+				sumOfPowers += std::pow(std::abs(x), ord);
+			}
+			return std::pow(sumOfPowers, 1.0 / ord);
+		}
+		}
+	}
+
+	/**
+	 * Calculates the median of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The median value.
+	 */
+	template <typename T>
+	inline T median(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		// 选择算法 O(n)：先定位上中位数，偶数长度时下中位数是左半部分的最大值
+		std::vector<T> work(vec);
+		size_t size = work.size();
+		auto mid = work.begin() + size / 2;
+		std::nth_element(work.begin(), mid, work.end());
+		if (size % 2 == 0)
+		{
+			T lower = *std::max_element(work.begin(), mid);
+			return (lower + *mid) / 2;
+		}
+		else
+		{
+			return *mid;
+		}
+	}
+
+	/**
+	 * Calculates the population variance of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The population variance.
+	 */
+	template <typename T>
+	inline double populationVar(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		double meanVal = mean(vec);
+		double variance = 0.0;
+		for (const auto& x : vec)
+		{
+			variance += (x - meanVal) * (x - meanVal);
+		}
+		return variance / vec.size();
+	}
+
+	/**
+	 * Calculates the sample variance of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The sample variance.
+	 */
+	template <typename T>
+	inline double sampleVar(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		double meanVal = mean(vec);
+		double variance = 0.0;
+		for (const auto& x : vec)
+		{
+			variance += (x - meanVal) * (x - meanVal);
+		}
+		return variance / (vec.size() - 1);
+	}
+
+	/**
+	 * Calculates the variance of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @param isSample Indicates whether to calculate sample variance (true) or population variance (false).
+	 * @return The variance.
+	 */
+	template <typename T>
+	inline double var(const std::vector<T>& vec, bool isSample = false)
+	{
+		return isSample ? sampleVar(vec) : populationVar(vec);
+	}
+
+	/**
+	 * Calculates the population standard deviation of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The population standard deviation.
+	 */
+	template <typename T>
+	inline double populationStd(const std::vector<T>& vec)
+	{
+		return std::sqrt(populationVar(vec));
+	}
+
+	/**
+	 * Calculates the sample standard deviation of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The sample standard deviation.
+	 */
+	template <typename T>
+	inline double sampleStd(const std::vector<T>& vec)
+	{
+		return std::sqrt(sampleVar(vec));
+	}
+
+	/**
+	 * Calculates the standard deviation of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @param isSample Indicates whether to calculate sample standard deviation (true) or population standard deviation (false).
+	 * @return The standard deviation.
+	 */
+	template <typename T>
+	inline double std(const std::vector<T>& vec, bool isSample = false)
+	{
+		return std::sqrt(var(vec, isSample));
+	}
+
+	/**
+	 * Calculates the skewness of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The skewness.
+	 */
+	template <typename T>
+	inline double skewness(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		if (vec.size() < 3)
+		{
+			throw std::invalid_argument("Skewness is undefined for vector of size less than 3");
+		}
+		double meanVal = mean(vec);
+		double stdVal = populationStd(vec);
+		double skew = 0.0;
+		for (const auto& x : vec)
+		{
+			skew += std::pow((x - meanVal) / stdVal, 3);
+		}
+		return skew / vec.size();
+	}
+
+	/**
+	 * Calculates the kurtosis of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The kurtosis.
+	 */
+	template <typename T>
+	inline double kurtosis(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		if (vec.size() < 4)
+		{
+			throw std::invalid_argument("Kurtosis is undefined for vector of size less than 4");
+		}
+		double meanVal = mean(vec);
+		double stdVal = populationStd(vec);
+		double kurt = 0.0;
+		for (const auto& x : vec)
+		{
+			kurt += std::pow((x - meanVal) / stdVal, 4);
+		}
+		return kurt / vec.size() - 3;
+	}
+
+	/**
+	 * How a quantile is read off the order statistics x[0] <= ... <= x[n-1], with h = p * (n - 1).
+	 */
+	enum class QuantileMethod
+	{
+		Lower,   // x[floor(h)]，与 percentile() 一致
+		Linear,  // x[floor(h)] 与 x[floor(h)+1] 线性插值，即 R 的 type 7 / numpy 默认
+		Nearest  // 最接近 h 的那个下标，恰在中间时取偶数下标（与 numpy 'nearest' 一致）
+	};
+
+	namespace detail
+	{
+		inline void checkProbability(double p)
+		{
+			if (!(p >= 0 && p <= 1))
+			{
+				throw std::invalid_argument("Percentile must be between 0 and 1");
+			}
+		}
+
+		// 第 p 分位数用到的下标 (lo, hi) 和插值权重 frac
+		inline void quantilePosition(size_t n, double p, QuantileMethod method, size_t& lo, size_t& hi, double& frac)
+		{
+			double h = p * (n - 1);
+			lo = static_cast<size_t>(h);
+			if (lo > n - 1)
+			{
+				lo = n - 1;
+			}
+			hi = lo;
+			frac = 0.0;
+			if (method == QuantileMethod::Linear)
+			{
+				frac = h - lo;
+				if (frac > 0 && lo + 1 < n)
+				{
+					hi = lo + 1;
+				}
+			}
+			else if (method == QuantileMethod::Nearest)
+			{
+				double f = h - lo;
+				if (lo + 1 < n && (f > 0.5 || (f == 0.5 && lo % 2 == 1)))
+				{
+					lo = hi = lo + 1;
+				}
+			}
+		}
+
+		// 递归地只在需要的位置做划分：indices 为升序下标，完成后 work[indices[k]] 都是对应的顺序统计量
+		template <typename T>
+		inline void multiSelect(std::vector<T>& work, size_t first, size_t last,
+			const size_t* idxBegin, const size_t* idxEnd)
+		{
+			while (idxBegin != idxEnd)
+			{
+				const size_t* mid = idxBegin + (idxEnd - idxBegin) / 2;
+				std::nth_element(work.begin() + first, work.begin() + *mid, work.begin() + last);
+				// 左半部分递归，右半部分循环
+				multiSelect(work, first, *mid, idxBegin, mid);
+				first = *mid + 1;
+				idxBegin = mid + 1;
+			}
+		}
+	}
+
+	/**
+	 * Calculates several quantiles with one selection pass (no full sort).
+	 *
+	 * The positions needed by all p values are partitioned recursively with nth_element, so
+	 * k quantiles cost O(n log k) instead of one O(n log n) sort per quantile.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param work The values. Reordered in place, so pass a scratch copy.
+	 * @param ps The probabilities (each between 0 and 1), in any order.
+	 * @param method How to interpolate between order statistics.
+	 * @return The quantiles, in the same order as ps.
+	 */
+	template <typename T>
+	inline std::vector<double> quantilesInPlace(std::vector<T>& work, const std::vector<double>& ps,
+		QuantileMethod method = QuantileMethod::Linear)
+	{
+		checkVector(work);
+		const size_t n = work.size();
+		std::vector<size_t> lo(ps.size()), hi(ps.size());
+		std::vector<double> frac(ps.size());
+		std::vector<size_t> needed;
+		needed.reserve(ps.size() * 2);
+		for (size_t k = 0; k < ps.size(); ++k)
+		{
+			detail::checkProbability(ps[k]);
+			detail::quantilePosition(n, ps[k], method, lo[k], hi[k], frac[k]);
+			needed.push_back(lo[k]);
+			needed.push_back(hi[k]);
+		}
+		std::sort(needed.begin(), needed.end());
+		needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+		detail::multiSelect(work, 0, n, needed.data(), needed.data() + needed.size());
+
+		std::vector<double> result(ps.size());
+		for (size_t k = 0; k < ps.size(); ++k)
+		{
+			double a = static_cast<double>(work[lo[k]]);
+			double b = static_cast<double>(work[hi[k]]);
+			result[k] = frac[k] > 0 ? a + frac[k] * (b - a) : a;
+		}
+		return result;
+	}
+
+	/**
+	 * Calculates several quantiles of a vector. See quantilesInPlace().
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @param ps The probabilities (each between 0 and 1).
+	 * @param method How to interpolate between order statistics.
+	 * @return The quantiles, in the same order as ps.
+	 */
+	template <typename T>
+	inline std::vector<double> quantiles(const std::vector<T>& vec, const std::vector<double>& ps,
+		QuantileMethod method = QuantileMethod::Linear)
+	{
+		std::vector<T> work(vec);
+		return quantilesInPlace(work, ps, method);
+	}
+
+	/**
+	 * Calculates one quantile of a vector in O(n) time by selection.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @param p The probability (between 0 and 1).
+	 * @param method How to interpolate between order statistics.
+	 * @return The quantile.
+	 */
+	template <typename T>
+	inline double quantile(const std::vector<T>& vec, double p, QuantileMethod method = QuantileMethod::Linear)
+	{
+		checkVector(vec);
+		detail::checkProbability(p);
+		size_t lo, hi;
+		double frac;
+		detail::quantilePosition(vec.size(), p, method, lo, hi, frac);
+		std::vector<T> work(vec);
+		std::nth_element(work.begin(), work.begin() + lo, work.end());
+		double a = static_cast<double>(work[lo]);
+		if (hi == lo)
+		{
+			return a;
+		}
+		// 上一个顺序统计量是右半部分的最小值
+		double b = static_cast<double>(*std::min_element(work.begin() + lo + 1, work.end()));
+		return a + frac * (b - a);
+	}
+
+	/**
+	 * Streaming quantile sketch (merging t-digest).
+	 *
+	 * Values are buffered and periodically merged into at most about `compression` centroids,
+	 * which are kept small near the tails, so extreme quantiles stay accurate. Memory does not
+	 * grow with the number of values, which makes it suitable for data read in chunks that do
+	 * not fit in memory. Two digests can be merged, e.g. one per thread.
+	 */
+	class TDigest
+	{
+	public:
+		explicit TDigest(double compression = 200.0)
+			: compression_(compression), total_(0.0),
+			min_(std::numeric_limits<double>::infinity()), max_(-std::numeric_limits<double>::infinity())
+		{
+			if (compression <= 0)
+			{
+				throw std::invalid_argument("TDigest: compression must be positive");
+			}
+			bufferLimit_ = static_cast<size_t>(compression * 5);
+			buffer_.reserve(bufferLimit_);
+		}
+
+		// 加入一个值（NaN 被忽略）
+		void add(double x, double weight = 1.0)
+		{
+			if (std::isnan(x) || weight <= 0)
+			{
+				return;
+			}
+			buffer_.push_back({ x, weight });
+			min_ = std::min(min_, x);
+			max_ = std::max(max_, x);
+			if (buffer_.size() >= bufferLimit_)
+			{
+				compress();
+			}
+		}
+
+		template <typename T>
+		void add(const std::vector<T>& values)
+		{
+			for (const auto& x : values)
+			{
+				add(static_cast<double>(x));
+			}
+		}
+
+		// 合并另一个 t-digest
+		void merge(const TDigest& other)
+		{
+			other.compress();
+			for (const auto& c : other.centroids_)
+			{
+				buffer_.push_back(c);
+			}
+			min_ = std::min(min_, other.min_);
+			max_ = std::max(max_, other.max_);
+			compress();
+		}
+
+		double count() const
+		{
+			compress();
+			return total_;
+		}
+
+		/**
+		 * Estimates the p-quantile (0 <= p <= 1), interpolating between centroid centres.
+		 *
+		 * @throws std::invalid_argument If p is out of range or no value has been added.
+		 */
+		double quantile(double p) const
+		{
+			detail::checkProbability(p);
+			compress();
+			if (centroids_.empty())
+			{
+				throw std::invalid_argument("TDigest is empty");
+			}
+			if (p == 0)
+			{
+				return min_;
+			}
+			if (p == 1)
+			{
+				return max_;
+			}
+			if (centroids_.size() == 1)
+			{
+				return min_ + p * (max_ - min_);
+			}
+			double target = p * total_;
+			// 每个质心的权重看作均匀分布在其中心两侧，中心位于累计权重 cum + w/2 处
+			double cum = 0.0;
+			for (size_t i = 0; i < centroids_.size(); ++i)
+			{
+				const Centroid& c = centroids_[i];
+				double centre = cum + c.weight / 2;
+				if (target < centre)
+				{
+					if (i == 0)
+					{
+						// 最左侧：在最小值和第一个质心中心之间插值
+						double t = c.weight > 1 ? target / centre : 0.0;
+						return min_ + t * (c.mean - min_);
+					}
+					const Centroid& prev = centroids_[i - 1];
+					double prevCentre = cum - prev.weight / 2;
+					double t = (target - prevCentre) / (centre - prevCentre);
+					return prev.mean + t * (c.mean - prev.mean);
+				}
+				cum += c.weight;
+			}
+			// 最右侧：在最后一个质心中心和最大值之间插值
+			const Centroid& last = centroids_.back();
+			double lastCentre = total_ - last.weight / 2;
+			double t = last.weight > 1 ? (target - lastCentre) / (total_ - lastCentre) : 1.0;
+			return last.mean + t * (max_ - last.mean);
+		}
+
+	private:
+		struct Centroid
+		{
+			double mean;
+			double weight;
+		};
+
+		// 把缓冲区与已有质心一起排序，再按 k1 尺度函数合并相邻质心
+		void compress() const
+		{
+			if (buffer_.empty())
+			{
+				return;
+			}
+			for (const auto& c : centroids_)
+			{
+				buffer_.push_back(c);
+			}
+			std::sort(buffer_.begin(), buffer_.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+			double total = 0.0;
+			for (const auto& c : buffer_)
+			{
+				total += c.weight;
+			}
+
+			const double pi = 3.14159265358979323846;
+			auto scale = [this, pi](double q) { return compression_ / (2 * pi) * std::asin(2 * std::min(std::max(q, 0.0), 1.0) - 1); };
+			centroids_.clear();
+			Centroid cur = buffer_[0];
+			double cumBefore = 0.0;
+			double kLow = scale(0.0);
+			for (size_t i = 1; i < buffer_.size(); ++i)
+			{
+				const Centroid& next = buffer_[i];
+				double q = (cumBefore + cur.weight + next.weight) / total;
+				if (scale(q) - kLow <= 1.0)
+				{
+					// 合并后仍不超过一个尺度单位
+					cur.mean += (next.mean - cur.mean) * next.weight / (cur.weight + next.weight);
+					cur.weight += next.weight;
+				}
+				else
+				{
+					cumBefore += cur.weight;
+					kLow = scale(cumBefore / total);
+					centroids_.push_back(cur);
+					cur = next;
+				}
+			}
+			centroids_.push_back(cur);
+			total_ = total;
+			buffer_.clear();
+		}
+
+		double compression_;
+		size_t bufferLimit_;
+		mutable std::vector<Centroid> buffer_;
+		mutable std::vector<Centroid> centroids_;
+		mutable double total_;
+		double min_;
+		double max_;
+	};
+
+	/**
+	 * Calculates the percentile of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @param p The percentile to calculate (between 0 and 1).
+	 * @return The percentile value.
+	 */
+	template <typename T>
+	inline double percentile(const std::vector<T>& vec, double p)
+	{
+		return quantile(vec, p, QuantileMethod::Lower);
+	}
+
+	/**
+	 * Finds the mode of the elements in the vector.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector containing the elements.
+	 * @return The mode value.
+	 */
+	template <typename T>
+	inline T mode(const std::vector<T>& vec)
+	{
+		checkVector(vec);
+		std::unordered_map<T, int> freqMap;
+		for (const auto& x : vec)
+		{
+			freqMap[x]++;
+		}
+		T modeValue = vec[0];
+		int maxFreq = 0;
+		for (const auto& pair : freqMap)
+		{
+			if (pair.second > maxFreq)
+			{
+				maxFreq = pair.second;
+				modeValue = pair.first;
+			}
+		}
+		return modeValue;
+	}
+
+	/**
+	 * Sorts a vector in ascending order. Vectors of doubles longer than a few hundred elements
+	 * use an LSD radix sort on the IEEE bit pattern (6 passes of 11 bits), which is several
+	 * times faster than std::sort; other vectors use std::sort.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param vec The vector to sort in place.
+	 */
+	template <typename T>
+	inline void sortValues(std::vector<T>& vec)
+	{
+		const size_t n = vec.size();
+		if constexpr (std::is_same<T, double>::value)
+		{
+			if (n >= 512)
+			{
+				const int BITS = 11;
+				const int PASSES = 6;
+				const size_t BUCKETS = size_t(1) << BITS;
+				// 把 double 的位模式变换成可按无符号整数比较的键：负数全部取反，正数翻转符号位
+				std::vector<uint64_t> keys(n), tmp(n);
+				std::vector<size_t> hist(BUCKETS * PASSES, 0);
+				for (size_t i = 0; i < n; ++i)
+				{
+					uint64_t u;
+					std::memcpy(&u, &vec[i], sizeof(u));
+					u = (u >> 63) ? ~u : (u | (uint64_t(1) << 63));
+					keys[i] = u;
+					for (int p = 0; p < PASSES; ++p)
+					{
+						++hist[p * BUCKETS + ((u >> (p * BITS)) & (BUCKETS - 1))];
+					}
+				}
+				for (int p = 0; p < PASSES; ++p)
+				{
+					size_t* h = &hist[p * BUCKETS];
+					// 所有键在这一位段上相同，跳过
+					if (h[(keys[0] >> (p * BITS)) & (BUCKETS - 1)] == n)
+					{
+						continue;
+					}
+					size_t offset = 0;
+					for (size_t b = 0; b < BUCKETS; ++b)
+					{
+						size_t c = h[b];
+						h[b] = offset;
+						offset += c;
+					}
+					for (size_t i = 0; i < n; ++i)
+					{
+						uint64_t u = keys[i];
+						tmp[h[(u >> (p * BITS)) & (BUCKETS - 1)]++] = u;
+					}
+					keys.swap(tmp);
+				}
+				for (size_t i = 0; i < n; ++i)
+				{
+					uint64_t u = keys[i];
+					u = (u >> 63) ? (u & ~(uint64_t(1) << 63)) : ~u;
+					std::memcpy(&vec[i], &u, sizeof(u));
+				}
+				return;
+			}
+		}
+		std::sort(vec.begin(), vec.end());
+	}
+
+	/**
+	 * Descriptive statistics of one vector, as produced by summarize().
+	 */
+	struct Summary
+	{
+		size_t count = 0;
+		double mean = 0.0;
+		double sampleStd = 0.0;
+		double populationStd = 0.0;
+		double min = 0.0;
+		double q25 = 0.0;
+		double q50 = 0.0;
+		double q75 = 0.0;
+		double max = 0.0;
+		double skewness = 0.0;
+		double kurtosis = 0.0;
+		double mode = 0.0;
+	};
+
+	/**
+	 * Computes all descriptive statistics of a vector at once.
+	 *
+	 * The moments (mean, variance, skewness, kurtosis) come from a single Welford pass, and
+	 * min, max, the quartiles and the mode are read from one sort of the same buffer. The
+	 * quartiles use the same floor index p * (n - 1) as percentile(). When several values
+	 * share the highest frequency, the smallest of them is returned as the mode.
+	 *
+	 * @tparam T The type of elements in the vector.
+	 * @param work The values to describe. The vector is sorted in place, so pass a scratch copy.
+	 * @return The summary statistics.
+	 * @throws std::invalid_argument If the vector is empty, or has fewer than 4 elements
+	 *         (skewness and kurtosis are undefined, as in skewness() and kurtosis()).
+	 */
+	template <typename T>
+	inline Summary summarize(std::vector<T>& work)
+	{
+		checkVector(work);
+		const size_t n = work.size();
+		if (n < 3)
+		{
+			throw std::invalid_argument("Skewness is undefined for vector of size less than 3");
+		}
+		if (n < 4)
+		{
+			throw std::invalid_argument("Kurtosis is undefined for vector of size less than 4");
+		}
+
+		// Welford / Terriberry 的一遍式高阶矩更新
+		double mean = 0.0, M2 = 0.0, M3 = 0.0, M4 = 0.0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			double k = static_cast<double>(i + 1);
+			double delta = static_cast<double>(work[i]) - mean;
+			double deltaK = delta / k;
+			double deltaK2 = deltaK * deltaK;
+			double term = delta * deltaK * (k - 1);
+			mean += deltaK;
+			M4 += term * deltaK2 * (k * k - 3 * k + 3) + 6 * deltaK2 * M2 - 4 * deltaK * M3;
+			M3 += term * deltaK * (k - 2) - 3 * deltaK * M2;
+			M2 += term;
+		}
+
+		Summary s;
+		s.count = n;
+		s.mean = mean;
+		double popVar = M2 / n;
+		s.populationStd = std::sqrt(popVar);
+		s.sampleStd = std::sqrt(M2 / (n - 1));
+		s.skewness = (M3 / n) / (popVar * s.populationStd);
+		s.kurtosis = (M4 / n) / (popVar * popVar) - 3;
+
+		sortValues(work);
+		s.min = static_cast<double>(work.front());
+		s.max = static_cast<double>(work.back());
+		s.q25 = static_cast<double>(work[static_cast<size_t>(0.25 * (n - 1))]);
+		s.q50 = static_cast<double>(work[static_cast<size_t>(0.50 * (n - 1))]);
+		s.q75 = static_cast<double>(work[static_cast<size_t>(0.75 * (n - 1))]);
+
+		// 排序后相同的值相邻，最长的一段即众数
+		size_t best = 0, bestLen = 0;
+		for (size_t i = 0; i < n;)
+		{
+			size_t j = i + 1;
+			while (j < n && work[j] == work[i])
+			{
+				++j;
+			}
+			if (j - i > bestLen)
+			{
+				bestLen = j - i;
+				best = i;
+			}
+			i = j;
+		}
+		s.mode = static_cast<double>(work[best]);
+		return s;
+	}
+
+	/**
+	 * Calculates the covariance between two vectors.
+	 *
+	 * @tparam T The type of elements in the vectors.
+	 * @param vec1 The first vector.
+	 * @param vec2 The second vector.
+	 * @param isSample Indicates whether to calculate sample covariance (true) or population covariance (false).
+	 * @return The covariance.
+	 */
+	template <typename T>
+	inline double covariance(const std::vector<T>& vec1, const std::vector<T>& vec2, bool isSample = false)
+	{
+		if (vec1.size() != vec2.size())
+		{
+			throw std::invalid_argument("Vectors must be of the same size");
+		}
+		checkVector(vec1);
+		checkVector(vec2);
+		double mean1 = mean(vec1);
+		double mean2 = mean(vec2);
+		double cov = 0.0;
+		for (size_t i = 0; i < vec1.size(); ++i)
+		{
+			cov += (vec1[i] - mean1) * (vec2[i] - mean2);
+		}
+		return isSample ? cov / (vec1.size() - 1) : cov / vec1.size();
+	}
+
+	/**
+	 * Calculates the correlation coefficient between two vectors.
+	 *
+	 * @tparam T The type of elements in the vectors.
+	 * @param vec1 The first vector.
+	 * @param vec2 The second vector.
+	 * @return The correlation coefficient.
+	 */
+	template <typename T>
+	inline double correlation(const std::vector<T>& vec1, const std::vector<T>& vec2)
+	{
+		return covariance(vec1, vec2) / (std(vec1) * std(vec2));
+	}
+
+	/*
+	p 值内核
+	*/
+
+	namespace detail
+	{
+		// 1 − exp(l) 的对数，l ≤ 0；按 l 的大小选 expm1 或 log1p，避免相消
+		inline double log1mExp(double l)
+		{
+			return l > -M_LN2 ? std::log(-std::expm1(l)) : std::log1p(-std::exp(l));
+		}
+
+		// lgamma(y + r) - lgamma(r)；y 为较小的整数时直接累加对数，避免 r 很大时的相消误差
+		inline double lgammaRatio(double y, double r)
+		{
+			if (y == 0)
+			{
+				return 0.0;
+			}
+			if (y < 16 && y == std::floor(y))
+			{
+				double s = 0, prod = 1;
+				int k = 0;
+				for (int i = 0; i < static_cast<int>(y); ++i)
+				{
+					prod *= r + i;
+					if (++k == 8)
+					{
+						s += std::log(prod);
+						prod = 1;
+						k = 0;
+					}
+				}
+				return s + std::log(prod);
+			}
+			// Stirling 级数之差：(y + r − ½)·log1p(y / r) + y·log r − y + S(y + r) − S(r)，r 先上移到 10 以上
+			double num = 1, den = 1;
+			while (r < 10)
+			{
+				num *= r;
+				den *= y + r;
+				r += 1;
+			}
+			double shift = std::log(num / den);
+			auto S = [](double x) {
+				double x2 = 1.0 / (x * x);
+				return (1.0 / 12 - x2 * (1.0 / 360 - x2 * (1.0 / 1260 - x2 / 1680))) / x;
+			};
+			return (y + r - 0.5) * std::log1p(y / r) + y * std::log(r) - y + S(y + r) - S(r) + shift;
+		}
+
+		// log Γ(x)，x > 0：先用乘积上移到 10 以上，再用 Stirling 级数（截断误差 < 1e-15）。
+		// 不用 std::lgamma，它会写全局变量 signgam，多线程调用有数据竞争
+		inline double logGamma(double x)
+		{
+			double prod = 1;
+			while (x < 10)
+			{
+				prod *= x;
+				x += 1;
+			}
+			double x2 = 1.0 / (x * x);
+			double series = (1.0 / 12 - x2 * (1.0 / 360 - x2 * (1.0 / 1260 - x2 * (1.0 / 1680 - x2 * (1.0 / 1188 - x2 * (691.0 / 360360)))))) / x;
+			// 0.5·log(2π)
+			return (x - 0.5) * std::log(x) - x + 0.91893853320467274178 + series - std::log(prod);
+		}
+
+		// log B(a, b)；较大的参数用 lgammaRatio 处理，避免两个大 lgamma 相减
+		inline double logBeta(double a, double b)
+		{
+			if (a > b)
+			{
+				std::swap(a, b);
+			}
+			return logGamma(a) - lgammaRatio(a, b);
+		}
+
+		// 改进 Lentz 算法中防止除零的下限
+		const double lentzTiny = 1e-300;
+		// 连分式与级数的最大迭代次数
+		const int specialMaxIter = 100000;
+
+		// I_x(a, b) 的连分式部分（Lentz 算法），在 x < (a + 1) / (a + b + 2) 时收敛快
+		inline double betaContinuedFraction(double x, double a, double b)
+		{
+			const double eps = 1e-16;
+			double qab = a + b, qap = a + 1, qam = a - 1;
+			double c = 1, d = 1 - qab * x / qap;
+			if (std::abs(d) < lentzTiny)
+			{
+				d = lentzTiny;
+			}
+			d = 1 / d;
+			double h = d;
+			for (int m = 1; m <= specialMaxIter; ++m)
+			{
+				double m2 = 2.0 * m;
+				// 偶数项
+				double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+				d = 1 + aa * d;
+				c = 1 + aa / c;
+				if (std::abs(d) < lentzTiny)
+				{
+					d = lentzTiny;
+				}
+				if (std::abs(c) < lentzTiny)
+				{
+					c = lentzTiny;
+				}
+				d = 1 / d;
+				h *= d * c;
+				// 奇数项
+				aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+				d = 1 + aa * d;
+				c = 1 + aa / c;
+				if (std::abs(d) < lentzTiny)
+				{
+					d = lentzTiny;
+				}
+				if (std::abs(c) < lentzTiny)
+				{
+					c = lentzTiny;
+				}
+				d = 1 / d;
+				double del = d * c;
+				h *= del;
+				if (std::abs(del - 1) < eps)
+				{
+					break;
+				}
+			}
+			return h;
+		}
+
+		// log I_x(a, b)（正则化不完全 beta）；upper 为 true 时返回 log(1 − I_x(a, b))。
+		// y = 1 − x 由调用方直接算出，x 接近 1 时不损失精度。整个计算都在对数空间进行，
+		// 前置因子 x^a·y^b / (a·B(a, b)) 不会下溢
+		inline double logIncompleteBeta(double x, double y, double a, double b, bool upper)
+		{
+			if (x <= 0)
+			{
+				return upper ? 0.0 : -std::numeric_limits<double>::infinity();
+			}
+			if (y <= 0)
+			{
+				return upper ? -std::numeric_limits<double>::infinity() : 0.0;
+			}
+			// 连分式只在分布的左侧收敛快，右侧用 I_x(a, b) = 1 − I_y(b, a)
+			if (x > (a + 1) / (a + b + 2))
+			{
+				std::swap(x, y);
+				std::swap(a, b);
+				upper = !upper;
+			}
+			// x、y 中较大的那个用另一个的 log1p 求对数，参数很大时 a·log x 的误差也不会放大
+			double logX = x < 0.5 ? std::log(x) : std::log1p(-y);
+			double logY = y < 0.5 ? std::log(y) : std::log1p(-x);
+			double l = a * logX + b * logY - std::log(a) - logBeta(a, b)
+				+ std::log(betaContinuedFraction(x, a, b));
+			l = std::min(l, 0.0);
+			return upper ? log1mExp(l) : l;
+		}
+
+		// log Q(a, x)（上侧正则化不完全 gamma）；x < a + 1 时用级数求 P 再取补，否则用连分式直接求 Q
+		inline double logIncompleteGammaQ(double a, double x)
+		{
+			if (x <= 0)
+			{
+				return 0.0;
+			}
+			double front = a * std::log(x) - x - logGamma(a);
+			if (x < a + 1)
+			{
+				double ap = a, del = 1.0 / a, sum = del;
+				for (int n = 0; n < specialMaxIter; ++n)
+				{
+					ap += 1;
+					del *= x / ap;
+					sum += del;
+					if (del < sum * 1e-17)
+					{
+						break;
+					}
+				}
+				return log1mExp(std::min(front + std::log(sum), 0.0));
+			}
+			double b = x + 1 - a, c = 1 / lentzTiny, d = 1 / b, h = d;
+			for (int i = 1; i <= specialMaxIter; ++i)
+			{
+				double an = -i * (i - a);
+				b += 2;
+				d = an * d + b;
+				c = b + an / c;
+				if (std::abs(d) < lentzTiny)
+				{
+					d = lentzTiny;
+				}
+				if (std::abs(c) < lentzTiny)
+				{
+					c = lentzTiny;
+				}
+				d = 1 / d;
+				double del = d * c;
+				h *= del;
+				if (std::abs(del - 1) < 1e-16)
+				{
+					break;
+				}
+			}
+			return std::min(front + std::log(h), 0.0);
+		}
+
+		// 对数空间的 P(Z > z)。erfc 在 z ≈ 37.5 之后下溢，此后用 Mills 比的渐近级数
+		inline double normalLogSf(double z)
+		{
+			if (z < 37)
+			{
+				return std::log(0.5 * std::erfc(z * M_SQRT1_2));
+			}
+			double r = 1 / (z * z);
+			double s = 1 - r * (1 - 3 * r * (1 - 5 * r * (1 - 7 * r * (1 - 9 * r * (1 - 11 * r)))));
+			return -0.5 * z * z - std::log(z) - 0.91893853320467274178 + std::log(s);
+		}
+
+		// 批量计算：kernel(i) 返回第 i 个元素的对数 p 值，logP 为 false 时再取指数
+		template <typename Kernel>
+		inline void pValueBatch(double* out, size_t n, bool logP, Kernel&& kernel)
+		{
+			parallelFor(0, n, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i)
+				{
+					out[i] = kernel(i);
+				}
+				if (!logP)
+				{
+					for (size_t i = lo; i < hi; ++i)
+					{
+						out[i] = std::exp(out[i]);
+					}
+				}
+			}, 1024);
+		}
+	}
+
+	/**
+	 * Two-sided p-value of a standard normal statistic, P(|Z| >= |z|).
+	 *
+	 * The tail is evaluated in log space, so with logP the result stays exact far beyond
+	 * the smallest representable double (|z| in the thousands is fine).
+	 *
+	 * @param z The statistic.
+	 * @param logP Whether to return the natural log of the p-value.
+	 * @return The p-value (or its log); NaN if z is NaN.
+	 */
+	inline double normalPValue(double z, bool logP = false)
+	{
+		if (std::isnan(z))
+		{
+			return z;
+		}
+		double l = M_LN2 + detail::normalLogSf(std::abs(z));
+		return logP ? l : std::exp(l);
+	}
+
+	/**
+	 * Two-sided p-value of a Student t statistic, P(|T| >= |t|) with df degrees of freedom.
+	 *
+	 * Uses P = I_x(df / 2, 1 / 2) with x = df / (df + t^2), evaluated by a continued fraction
+	 * in log space. For very large df (including infinity) the statistic is mapped to the normal
+	 * scale by t (1 - 1 / (4 df)) / sqrt(1 + t^2 / (2 df)) whenever that is accurate to ~1e-11.
+	 *
+	 * @param t The statistic.
+	 * @param df The degrees of freedom (need not be an integer).
+	 * @param logP Whether to return the natural log of the p-value.
+	 * @return The p-value (or its log); NaN if t is NaN or df is not positive.
+	 */
+	inline double tPValue(double t, double df, bool logP = false)
+	{
+		if (std::isnan(t) || !(df > 0))
+		{
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		double at = std::abs(t);
+		double l;
+		// 自由度很大时连分式的舍入误差随 df 增长，改用正态近似；其相对误差约为 0.05·(t³ / df)²，
+		// 只在它小于 1e-11 时使用
+		if (std::isinf(df) || (df > 1e5 && at * at * at < 1e-5 * df))
+		{
+			double v = 1 / (4 * df);
+			l = M_LN2 + detail::normalLogSf(at * (1 - v) / std::sqrt(1 + at * at * 2 * v));
+		}
+		else
+		{
+			// x = df / (df + t²)，y = t² / (df + t²)；t² / df 溢出时只保留 x^a 的首项
+			double r = at / df * at;
+			if (std::isinf(r))
+			{
+				double a = df / 2;
+				l = std::isinf(at) ? -std::numeric_limits<double>::infinity()
+					: a * (std::log(df) - 2 * std::log(at)) - std::log(a) - detail::logBeta(a, 0.5);
+			}
+			else
+			{
+				l = detail::logIncompleteBeta(1 / (1 + r), r / (1 + r), df / 2, 0.5, false);
+			}
+		}
+		return logP ? l : std::exp(l);
+	}
+
+	/**
+	 * Upper-tail p-value of a chi-squared statistic, P(X >= x) with df degrees of freedom.
+	 *
+	 * @param x The statistic.
+	 * @param df The degrees of freedom.
+	 * @param logP Whether to return the natural log of the p-value.
+	 * @return The p-value (or its log); NaN if x is NaN or df is not positive.
+	 */
+	inline double chiSquaredPValue(double x, double df, bool logP = false)
+	{
+		if (std::isnan(x) || !(df > 0))
+		{
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		double l = std::isinf(x) ? -std::numeric_limits<double>::infinity() : detail::logIncompleteGammaQ(df / 2, x / 2);
+		return logP ? l : std::exp(l);
+	}
+
+	/**
+	 * Upper-tail p-value of an F statistic, P(F >= f) with (df1, df2) degrees of freedom.
+	 *
+	 * Uses P = I_x(df2 / 2, df1 / 2) with x = df2 / (df2 + df1 f); an infinite df2 refers
+	 * df1 f to a chi-squared distribution with df1 degrees of freedom.
+	 *
+	 * @param f The statistic.
+	 * @param df1 The numerator degrees of freedom.
+	 * @param df2 The denominator degrees of freedom (may be infinite).
+	 * @param logP Whether to return the natural log of the p-value.
+	 * @return The p-value (or its log); NaN if f is NaN or a df is not positive.
+	 */
+	inline double fPValue(double f, double df1, double df2, bool logP = false)
+	{
+		if (std::isnan(f) || !(df1 > 0) || !(df2 > 0) || std::isinf(df1))
+		{
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		if (std::isinf(df2))
+		{
+			return chiSquaredPValue(df1 * f, df1, logP);
+		}
+		double l;
+		if (!(f > 0))
+		{
+			l = 0.0;
+		}
+		else
+		{
+			// x = df2 / (df2 + df1·f)，y = df1·f / (df2 + df1·f)
+			double r = df1 / df2 * f;
+			if (std::isinf(r))
+			{
+				double a = df2 / 2;
+				l = std::isinf(f) ? -std::numeric_limits<double>::infinity()
+					: a * (std::log(df2) - std::log(df1) - std::log(f)) - std::log(a) - detail::logBeta(a, df1 / 2);
+			}
+			else
+			{
+				l = detail::logIncompleteBeta(1 / (1 + r), r / (1 + r), df2 / 2, df1 / 2, false);
+			}
+		}
+		return logP ? l : std::exp(l);
+	}
+
+	/**
+	 * Two-sided normal p-values of n statistics, computed in parallel (see normalPValue).
+	 *
+	 * @param z The statistics.
+	 * @param out The output; may alias z.
+	 * @param n The number of statistics.
+	 * @param logP Whether to write natural-log p-values.
+	 */
+	inline void normalPValues(const double* z, double* out, size_t n, bool logP = false)
+	{
+		detail::pValueBatch(out, n, logP, [z](size_t i) { return normalPValue(z[i], true); });
+	}
+
+	/**
+	 * Two-sided Student t p-values of n statistics sharing one df, computed in parallel (see tPValue).
+	 *
+	 * @param t The statistics.
+	 * @param df The degrees of freedom.
+	 * @param out The output; may alias t.
+	 * @param n The number of statistics.
+	 * @param logP Whether to write natural-log p-values.
+	 */
+	inline void tPValues(const double* t, double df, double* out, size_t n, bool logP = false)
+	{
+		detail::pValueBatch(out, n, logP, [t, df](size_t i) { return tPValue(t[i], df, true); });
+	}
+
+	/**
+	 * Two-sided Student t p-values of n statistics with per-statistic df (e.g. Welch tests).
+	 *
+	 * @param t The statistics.
+	 * @param df The degrees of freedom of each statistic.
+	 * @param out The output; may alias t or df.
+	 * @param n The number of statistics.
+	 * @param logP Whether to write natural-log p-values.
+	 */
+	inline void tPValues(const double* t, const double* df, double* out, size_t n, bool logP = false)
+	{
+		detail::pValueBatch(out, n, logP, [t, df](size_t i) { return tPValue(t[i], df[i], true); });
+	}
+
+	/**
+	 * Upper-tail chi-squared p-values of n statistics sharing one df, computed in parallel.
+	 *
+	 * @param x The statistics.
+	 * @param df The degrees of freedom.
+	 * @param out The output; may alias x.
+	 * @param n The number of statistics.
+	 * @param logP Whether to write natural-log p-values.
+	 */
+	inline void chiSquaredPValues(const double* x, double df, double* out, size_t n, bool logP = false)
+	{
+		detail::pValueBatch(out, n, logP, [x, df](size_t i) { return chiSquaredPValue(x[i], df, true); });
+	}
+
+	/**
+	 * Upper-tail F p-values of n statistics sharing (df1, df2), computed in parallel.
+	 *
+	 * @param f The statistics.
+	 * @param df1 The numerator degrees of freedom.
+	 * @param df2 The denominator degrees of freedom (may be infinite).
+	 * @param out The output; may alias f.
+	 * @param n The number of statistics.
+	 * @param logP Whether to write natural-log p-values.
+	 */
+	inline void fPValues(const double* f, double df1, double df2, double* out, size_t n, bool logP = false)
+	{
+		detail::pValueBatch(out, n, logP, [f, df1, df2](size_t i) { return fPValue(f[i], df1, df2, true); });
+	}
+
+	/*
+	第二次扩展
+	t-test
+	*/
+	struct t_testResult
+	{
+		double t;
+		double p_value;
+		double log2_fc;
+	};
+
+	/**
+	 * Performs a two-sample t-test on two vectors.
+	 *
+	 * @tparam T The type of elements in the vectors.
+	 * @param vec1 The first vector.
+	 * @param vec2 The second vector.
+	 * @return A t_testResult object containing the t-statistic, p-value, and log2 fold change.
+	 */
+	template <typename T>
+	inline t_testResult t_test(const std::vector<T>& vec1, const std::vector<T>& vec2, bool log2_data = true)
+	{
+		// 计算t统计量
+		double m1 = mean(vec1);
+		double m2 = mean(vec2);
+		double s1 = var(vec1, true) / vec1.size();
+		double s2 = var(vec2, true) / vec2.size();
+
+		// 计算log2 fold change
+		double log2_fc = 0;
+		if (log2_data)
+			// 数据已经经过了log2处理，所以直接相减即可
+			log2_fc = m1 - m2;
+		else
+			log2_fc = std::log2(m1 / m2);
+
+		// 计算t值和自由度
+		double t = (m1 - m2) / std::sqrt(s1 + s2);
+		double df = std::pow(s1 + s2, 2) / (std::pow(s1, 2) / (vec1.size() - 1) + std::pow(s2, 2) / (vec2.size() - 1));
+
+		double p = tPValue(t, df);
+
+		return { t, p, log2_fc };
+	}
+
+	/**
+	 * Performs Welch two-sample t-tests on every row of a matrix at once.
+	 *
+	 * Computes the same statistics as t_test, but each row is read exactly once: the group
+	 * sums and sums of squares are accumulated around the first value of each group (a shifted
+	 * one-pass variance), so no per-row copies or split vectors are made. Rows are processed in
+	 * parallel and the Student-t tail probability is evaluated inside the worker threads.
+	 * Rows whose pooled variance is zero, or groups with fewer than 2 samples, get a NaN p-value
+	 * instead of throwing.
+	 *
+	 * @tparam Rows A random-access container of rows; rows[i][j] is feature i in sample j.
+	 * @param rows The data, one row per feature.
+	 * @param group The group label (0 or 1) of each sample.
+	 * @param log2_data Whether the data is already on the log2 scale (see t_test).
+	 * @return One t_testResult per row; the first group is group 0.
+	 * @throws std::invalid_argument If a group label is not 0 or 1.
+	 */
+	template <typename Rows>
+	inline std::vector<t_testResult> t_testBatch(const Rows& rows, const std::vector<int>& group, bool log2_data = true)
+	{
+		// 分组下标只算一次，各行共用
+		std::vector<size_t> idx1, idx2;
+		for (size_t j = 0; j < group.size(); ++j)
+		{
+			if (group[j] == 0)
+				idx1.push_back(j);
+			else if (group[j] == 1)
+				idx2.push_back(j);
+			else
+				throw std::invalid_argument("groupmust be 0 or 1.");
+		}
+
+		size_t G = rows.size();
+		std::vector<t_testResult> result(G);
+		double n1 = static_cast<double>(idx1.size());
+		double n2 = static_cast<double>(idx2.size());
+
+		// 平移后的一遍求和：返回均值与样本方差 / n
+		auto moments = [](const auto& x, const std::vector<size_t>& idx, double& m, double& s) {
+			size_t n = idx.size();
+			if (n == 0)
+			{
+				m = std::numeric_limits<double>::quiet_NaN();
+				s = m;
+				return;
+			}
+			double shift = x[idx[0]];
+			double sum = 0, sumSq = 0;
+			for (size_t k = 1; k < n; ++k)
+			{
+				double d = x[idx[k]] - shift;
+				sum += d;
+				sumSq += d * d;
+			}
+			m = shift + sum / n;
+			s = n > 1 ? std::max(sumSq - sum * sum / n, 0.0) / ((n - 1.0) * n) : std::numeric_limits<double>::quiet_NaN();
+		};
+
+		parallelFor(0, G, [&](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; ++i)
+			{
+				const auto& x = rows[i];
+				double m1, s1, m2, s2;
+				moments(x, idx1, m1, s1);
+				moments(x, idx2, m2, s2);
+
+				double log2_fc = log2_data ? m1 - m2 : std::log2(m1 / m2);
+				double se2 = s1 + s2;
+				double t = (m1 - m2) / std::sqrt(se2);
+				double df = se2 * se2 / (s1 * s1 / (n1 - 1) + s2 * s2 / (n2 - 1));
+
+				result[i] = { t, tPValue(t, df), log2_fc };
+			}
+		}, 256);
+		return result;
+	}
+
+	/**
+	 * Options of permutationTTest.
+	 */
+	struct PermutationOptions
+	{
+		// 置换次数上限 B
+		size_t permutations = 10000;
+		// 随机种子；同一种子得到的结果与线程数无关
+		uint64_t seed = 20240101;
+		// 提前停止：某基因的超越次数达到该值后不再参与置换（Besag-Clifford），0 表示关闭
+		size_t stopAfter = 20;
+		// 每轮置换的次数，每轮结束后检查一次提前停止
+		size_t roundSize = 256;
+		// 是否计算 max-T 的族错误率校正 p 值（需要全部基因参与每一次置换，此时不做提前停止）
+		bool maxT = false;
+	};
+
+	/**
+	 * Result of permutationTTest, one entry per row.
+	 */
+	struct PermutationResult
+	{
+		std::vector<double> log2_fc;
+		std::vector<double> t;
+		std::vector<double> p_value;
+		// max-T 单步校正后的 p 值；未开启 maxT 时为空
+		std::vector<double> maxT_p_value;
+		// 每个基因实际使用的置换次数
+		std::vector<size_t> permutations;
+	};
+
+	namespace detail
+	{
+		// splitmix64：由种子和置换序号得到互不相关的随机流种子
+		inline uint64_t splitmix64(uint64_t x)
+		{
+			x += 0x9e3779b97f4a7c15ULL;
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			return x ^ (x >> 31);
+		}
+
+		// s[k] += d[k]，q[k] += d[k]^2；按 4 个一组展开，便于编译器生成 SIMD 指令
+		inline void accumulateSquares(const double* d, double* s, double* q, size_t n)
+		{
+			size_t k = 0;
+			for (; k + 4 <= n; k += 4)
+			{
+				double d0 = d[k], d1 = d[k + 1], d2 = d[k + 2], d3 = d[k + 3];
+				s[k] += d0;
+				s[k + 1] += d1;
+				s[k + 2] += d2;
+				s[k + 3] += d3;
+				q[k] += d0 * d0;
+				q[k + 1] += d1 * d1;
+				q[k + 2] += d2 * d2;
+				q[k + 3] += d3 * d3;
+			}
+			for (; k < n; ++k)
+			{
+				s[k] += d[k];
+				q[k] += d[k] * d[k];
+			}
+		}
+
+		// 由子集 A（大小 nA）的平移和、平方和以及整行的平移和、平方和算出 Welch |t|
+		inline double welchAbsT(double sA, double qA, double S, double Q, double nA, double nB)
+		{
+			double sB = S - sA;
+			double qB = Q - qA;
+			double vA = (qA - sA * sA / nA) / ((nA - 1) * nA);
+			double vB = (qB - sB * sB / nB) / ((nB - 1) * nB);
+			return std::abs(sA / nA - sB / nB) / std::sqrt(std::max(vA, 0.0) + std::max(vB, 0.0));
+		}
+	}
+
+	/**
+	 * Computes permutation p-values of the Welch t statistic for every row of a matrix.
+	 *
+	 * The group labels are shuffled B times and the statistic is recomputed for all genes; the
+	 * p-value of a gene is (b + 1) / (B + 1), where b counts the permutations whose |t| is at
+	 * least the observed |t|. The data is transposed once into a sample-major, row-shifted
+	 * buffer, so a permutation only sums the rows of the smaller group into per-gene
+	 * accumulators; genes are processed in cache-sized blocks and these inner loops are
+	 * contiguous over genes. Permutations are split across threads. Every permutation draws
+	 * its labels from its own RNG stream derived from the seed, so the result does not depend
+	 * on the number of threads.
+	 *
+	 * With stopAfter > 0, a gene whose exceedance count reaches stopAfter after a round is
+	 * dropped from later rounds and gets the Besag-Clifford estimate b / (permutations used).
+	 * With maxT, the single-step max-T adjusted p-value (Westfall-Young) is also returned; it
+	 * needs the statistic of every gene in every permutation, so early stopping is disabled.
+	 *
+	 * @tparam Rows A random-access container of rows; rows[i][j] is feature i in sample j.
+	 * @param rows The data, one row per feature.
+	 * @param group The group label (0 or 1) of each sample.
+	 * @param options The permutation settings.
+	 * @return The observed t statistics, permutation p-values and, optionally, max-T p-values.
+	 * @throws std::invalid_argument If a group label is not 0 or 1, a group has fewer than 2
+	 *         samples, or no permutations are requested.
+	 */
+	template <typename Rows>
+	inline PermutationResult permutationTTest(const Rows& rows, const std::vector<int>& group, const PermutationOptions& options = PermutationOptions())
+	{
+		size_t N = group.size();
+		size_t n0 = 0;
+		for (int g : group)
+		{
+			if (g != 0 && g != 1)
+				throw std::invalid_argument("groupmust be 0 or 1.");
+			n0 += (g == 0);
+		}
+		size_t n1 = N - n0;
+		if (n0 < 2 || n1 < 2)
+			throw std::invalid_argument("Each group must contain at least 2 samples.");
+		if (options.permutations == 0)
+			throw std::invalid_argument("The number of permutations must be positive.");
+
+		size_t G = rows.size();
+		PermutationResult res;
+		std::vector<t_testResult> observed = t_testBatch(rows, group);
+		res.log2_fc.resize(G);
+		res.t.resize(G);
+		res.p_value.assign(G, std::numeric_limits<double>::quiet_NaN());
+		res.permutations.assign(G, 0);
+		for (size_t i = 0; i < G; ++i)
+		{
+			res.log2_fc[i] = observed[i].log2_fc;
+			res.t[i] = observed[i].t;
+		}
+
+		// 只对较小的一组求和，另一组由整行总和相减得到
+		size_t nA = std::min(n0, n1);
+		double dA = static_cast<double>(nA), dB = static_cast<double>(N - nA);
+
+		// 参与置换的基因：观测统计量为 NaN 的基因不参与
+		std::vector<size_t> active;
+		std::vector<double> obs;
+		for (size_t i = 0; i < G; ++i)
+		{
+			if (!std::isnan(res.t[i]))
+			{
+				active.push_back(i);
+				// 留出一点余量，避免与观测标签等价的置换因舍入误差而漏计
+				obs.push_back(std::abs(res.t[i]) * (1 - 1e-12));
+			}
+		}
+
+		// 样本优先的平移数据：D[j * Ga + k] = x[active[k]][j] - x[active[k]][0]
+		size_t Ga0 = active.size();
+		std::vector<double> D(N * Ga0), S(Ga0, 0.0), Q(Ga0, 0.0);
+		std::vector<size_t> exceed(Ga0, 0);
+		parallelFor(0, Ga0, [&](size_t lo, size_t hi) {
+			for (size_t k = lo; k < hi; ++k)
+			{
+				const auto& x = rows[active[k]];
+				double shift = x[0];
+				for (size_t j = 0; j < N; ++j)
+				{
+					double d = x[j] - shift;
+					D[j * Ga0 + k] = d;
+					S[k] += d;
+					Q[k] += d * d;
+				}
+			}
+		}, 256);
+
+		bool stopEarly = options.stopAfter > 0 && !options.maxT;
+		size_t roundSize = std::max<size_t>(options.roundSize, 1);
+		std::vector<double> maxStat;
+		if (options.maxT)
+			maxStat.assign(options.permutations, 0.0);
+
+		const size_t block = 1024;
+		std::mutex mergeMutex;
+		size_t done = 0;
+		while (done < options.permutations && !active.empty())
+		{
+			size_t roundEnd = std::min(options.permutations, done + roundSize);
+			size_t Ga = active.size();
+
+			parallelFor(done, roundEnd, [&](size_t lo, size_t hi) {
+				size_t P = hi - lo;
+				// 先为本块的每次置换抽取子集 A 的样本下标
+				std::vector<uint32_t> sel(P * nA);
+				std::vector<uint32_t> perm(N);
+				for (size_t b = 0; b < P; ++b)
+				{
+					std::mt19937_64 rng(detail::splitmix64(options.seed ^ detail::splitmix64(lo + b)));
+					std::iota(perm.begin(), perm.end(), 0u);
+					for (size_t j = 0; j < nA; ++j)
+					{
+						std::uniform_int_distribution<size_t> pick(j, N - 1);
+						std::swap(perm[j], perm[pick(rng)]);
+					}
+					std::copy(perm.begin(), perm.begin() + nA, sel.begin() + b * nA);
+				}
+
+				std::vector<size_t> localExceed(Ga, 0);
+				std::vector<double> localMax(P, 0.0);
+				std::vector<double> sA(block), qA(block);
+				for (size_t g0 = 0; g0 < Ga; g0 += block)
+				{
+					size_t len = std::min(block, Ga - g0);
+					for (size_t b = 0; b < P; ++b)
+					{
+						std::fill(sA.begin(), sA.begin() + len, 0.0);
+						std::fill(qA.begin(), qA.begin() + len, 0.0);
+						const uint32_t* s = sel.data() + b * nA;
+						for (size_t a = 0; a < nA; ++a)
+						{
+							detail::accumulateSquares(D.data() + s[a] * Ga + g0, sA.data(), qA.data(), len);
+						}
+						double m = localMax[b];
+						for (size_t k = 0; k < len; ++k)
+						{
+							size_t g = g0 + k;
+							double t = detail::welchAbsT(sA[k], qA[k], S[g], Q[g], dA, dB);
+							localExceed[g] += (t >= obs[g]);
+							if (t > m)
+								m = t;
+						}
+						localMax[b] = m;
+					}
+				}
+
+				std::lock_guard<std::mutex> lock(mergeMutex);
+				for (size_t k = 0; k < Ga; ++k)
+					exceed[k] += localExceed[k];
+				if (options.maxT)
+					std::copy(localMax.begin(), localMax.end(), maxStat.begin() + lo);
+			}, 1);
+			done = roundEnd;
+
+			if (!stopEarly || done >= options.permutations)
+				continue;
+
+			// 提前停止：超越次数已经足够的基因直接给出 p 值并移出
+			std::vector<size_t> keep;
+			keep.reserve(Ga);
+			for (size_t k = 0; k < Ga; ++k)
+			{
+				if (exceed[k] >= options.stopAfter)
+				{
+					res.p_value[active[k]] = static_cast<double>(exceed[k]) / done;
+					res.permutations[active[k]] = done;
+				}
+				else
+					keep.push_back(k);
+			}
+			if (keep.size() == Ga)
+				continue;
+
+			// 原地压缩各列，目标位置总不超过源位置
+			size_t kept = keep.size();
+			for (size_t j = 0; j < N; ++j)
+			{
+				const double* src = D.data() + j * Ga;
+				double* dst = D.data() + j * kept;
+				for (size_t c = 0; c < kept; ++c)
+					dst[c] = src[keep[c]];
+			}
+			D.resize(N * kept);
+			for (size_t c = 0; c < kept; ++c)
+			{
+				size_t k = keep[c];
+				active[c] = active[k];
+				obs[c] = obs[k];
+				exceed[c] = exceed[k];
+				S[c] = S[k];
+				Q[c] = Q[k];
+			}
+			active.resize(kept);
+			obs.resize(kept);
+			exceed.resize(kept);
+			S.resize(kept);
+			Q.resize(kept);
+		}
+
+		for (size_t k = 0; k < active.size(); ++k)
+		{
+			res.p_value[active[k]] = (exceed[k] + 1.0) / (done + 1.0);
+			res.permutations[active[k]] = done;
+		}
+
+		if (options.maxT)
+		{
+			// 单步 max-T：p_i = (#{b : max_g |t_b,g| >= |t_i|} + 1) / (B + 1)
+			std::vector<double> sortedMax = maxStat;
+			std::sort(sortedMax.begin(), sortedMax.end());
+			res.maxT_p_value.assign(G, std::numeric_limits<double>::quiet_NaN());
+			for (size_t i = 0; i < G; ++i)
+			{
+				if (std::isnan(res.t[i]))
+					continue;
+				double o = std::abs(res.t[i]) * (1 - 1e-12);
+				size_t count = sortedMax.end() - std::lower_bound(sortedMax.begin(), sortedMax.end(), o);
+				res.maxT_p_value[i] = (count + 1.0) / (options.permutations + 1.0);
+			}
+		}
+		return res;
+	}
+
+	/*
+	多重检验校正
+	*/
+
+	/**
+	 * Multiple-testing correction methods of pAdjust.
+	 */
+	enum class PAdjustMethod
+	{
+		Bonferroni,
+		Holm,
+		// Benjamini-Hochberg
+		BH,
+		// Benjamini-Yekutieli
+		BY,
+		// Storey q-value，pi0 由 estimatePi0 估计
+		Storey
+	};
+
+	namespace detail
+	{
+		// 长度大于该值时用多线程排序
+		const size_t parallelSortThreshold = 1 << 16;
+
+		// 排序记录：可按无符号整数比较的键（double 位模式变换，同 sortValues）和原下标
+		struct SortRecord
+		{
+			uint64_t key;
+			uint32_t idx;
+		};
+
+		inline bool operator<(const SortRecord& a, const SortRecord& b)
+		{
+			return a.key < b.key || (a.key == b.key && a.idx < b.idx);
+		}
+
+		// 稳定的 LSD 基数排序（6 趟 × 11 位），tmp 为同样长度的缓冲区
+		inline void radixSortRecords(SortRecord* a, SortRecord* tmp, size_t n)
+		{
+			const int BITS = 11;
+			const int PASSES = 6;
+			const size_t BUCKETS = size_t(1) << BITS;
+			if (n < 2)
+				return;
+			std::vector<size_t> hist(BUCKETS * PASSES, 0);
+			for (size_t i = 0; i < n; ++i)
+				for (int p = 0; p < PASSES; ++p)
+					++hist[p * BUCKETS + ((a[i].key >> (p * BITS)) & (BUCKETS - 1))];
+			SortRecord* src = a;
+			SortRecord* dst = tmp;
+			for (int p = 0; p < PASSES; ++p)
+			{
+				size_t* h = &hist[p * BUCKETS];
+				// 所有键在这一位段上相同，跳过
+				if (h[(src[0].key >> (p * BITS)) & (BUCKETS - 1)] == n)
+					continue;
+				size_t offset = 0;
+				for (size_t b = 0; b < BUCKETS; ++b)
+				{
+					size_t c = h[b];
+					h[b] = offset;
+					offset += c;
+				}
+				for (size_t i = 0; i < n; ++i)
+					dst[h[(src[i].key >> (p * BITS)) & (BUCKETS - 1)]++] = src[i];
+				std::swap(src, dst);
+			}
+			if (src != a)
+				std::copy(src, src + n, a);
+		}
+
+		/**
+		 * Sorts the indices of the non-NaN p-values by ascending p-value (ties by index).
+		 *
+		 * Only 32-bit indices are returned. Internally each index is paired with the bit pattern
+		 * of its p-value and sorted with a stable LSD radix sort, so every value is read once and
+		 * the passes stream through memory. Large inputs are radix-sorted in parallel blocks that
+		 * are then merged pairwise, also in parallel. The order is total, so the result does not
+		 * depend on the number of threads.
+		 */
+		template <typename P>
+		inline std::vector<uint32_t> argsortPValues(const P& p)
+		{
+			size_t n = p.size();
+			if (n > std::numeric_limits<uint32_t>::max())
+				throw std::invalid_argument("Too many p-values.");
+			std::vector<SortRecord> rec;
+			rec.reserve(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				double v = p[i];
+				if (std::isnan(v))
+					continue;
+				uint64_t u;
+				std::memcpy(&u, &v, sizeof(u));
+				u = (u >> 63) ? ~u : (u | (uint64_t(1) << 63));
+				rec.push_back({ u, static_cast<uint32_t>(i) });
+			}
+
+			size_t m = rec.size();
+			std::vector<SortRecord> buf(m);
+			size_t blocks = std::min(threadCount(), m / (parallelSortThreshold / 4) + 1);
+			if (m < parallelSortThreshold || blocks < 2)
+				radixSortRecords(rec.data(), buf.data(), m);
+			else
+			{
+				std::vector<size_t> bounds(blocks + 1);
+				for (size_t b = 0; b <= blocks; ++b)
+					bounds[b] = m * b / blocks;
+				parallelFor(0, blocks, [&](size_t lo, size_t hi) {
+					for (size_t b = lo; b < hi; ++b)
+						radixSortRecords(rec.data() + bounds[b], buf.data() + bounds[b], bounds[b + 1] - bounds[b]);
+				});
+				while (bounds.size() > 2)
+				{
+					size_t runs = bounds.size() - 1;
+					std::vector<size_t> next;
+					next.reserve(runs / 2 + 2);
+					for (size_t r = 0; r < runs; r += 2)
+						next.push_back(bounds[r]);
+					next.push_back(m);
+					parallelFor(0, (runs + 1) / 2, [&](size_t lo, size_t hi) {
+						for (size_t k = lo; k < hi; ++k)
+						{
+							size_t a = bounds[2 * k];
+							size_t mid = bounds[std::min(2 * k + 1, runs)];
+							size_t e = bounds[std::min(2 * k + 2, runs)];
+							std::merge(rec.begin() + a, rec.begin() + mid, rec.begin() + mid, rec.begin() + e, buf.begin() + a);
+						}
+					});
+					rec.swap(buf);
+					bounds.swap(next);
+				}
+			}
+
+			std::vector<uint32_t> idx(m);
+			for (size_t k = 0; k < m; ++k)
+				idx[k] = rec[k].idx;
+			return idx;
+		}
+
+		// 在升序下标 order 上计算 Storey 的 pi0（qvalue 包的 "bootstrap" 方法，用闭式均方误差选择 lambda）
+		template <typename P>
+		inline double estimatePi0Sorted(const P& p, const std::vector<uint32_t>& order)
+		{
+			size_t m = order.size();
+			if (m == 0)
+				return 1.0;
+			const size_t L = 19;
+			double lambda[L], pi0[L], W[L];
+			for (size_t k = 0; k < L; ++k)
+			{
+				lambda[k] = 0.05 * (k + 1);
+				// p >= lambda 的个数：order 中第一个 p >= lambda 的位置
+				size_t lo = 0, hi = m;
+				while (lo < hi)
+				{
+					size_t mid = (lo + hi) / 2;
+					if (p[order[mid]] < lambda[k])
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+				W[k] = static_cast<double>(m - lo);
+				pi0[k] = W[k] / (m * (1 - lambda[k]));
+			}
+			std::vector<double> sorted(pi0, pi0 + L);
+			double minPi0 = quantile(sorted, 0.1);
+			double best = std::numeric_limits<double>::infinity(), result = 1.0;
+			for (size_t k = 0; k < L; ++k)
+			{
+				double mse = W[k] / (double(m) * m * (1 - lambda[k]) * (1 - lambda[k])) * (1 - W[k] / m)
+					+ (pi0[k] - minPi0) * (pi0[k] - minPi0);
+				if (mse < best)
+				{
+					best = mse;
+					result = pi0[k];
+				}
+			}
+			return std::min(result, 1.0);
+		}
+	}
+
+	/**
+	 * Estimates the proportion of true null hypotheses (Storey's pi0).
+	 *
+	 * pi0(lambda) = #{p >= lambda} / (m (1 - lambda)) is evaluated on lambda = 0.05, ..., 0.95 and
+	 * the lambda with the smallest estimated mean squared error against the 10% quantile of the
+	 * pi0 curve is chosen, as in the "bootstrap" method of the qvalue package. NaN p-values are
+	 * ignored.
+	 *
+	 * @tparam P A random-access container of p-values (operator[] and size()).
+	 * @param p The p-values.
+	 * @return The estimated pi0, at most 1.
+	 */
+	template <typename P>
+	inline double estimatePi0(const P& p)
+	{
+		return detail::estimatePi0Sorted(p, detail::argsortPValues(p));
+	}
+
+	/**
+	 * Adjusts p-values for multiple testing and writes the result to out.
+	 *
+	 * NaN p-values are skipped: they do not count towards the number of tests and their output
+	 * is NaN. p and out may be the same object, so a column can be adjusted in place; every
+	 * p-value is read before its own output slot is written. Both only need operator[] and
+	 * size(), so strided views such as BCmatrix columns work without copying.
+	 *
+	 * @tparam P A random-access container of p-values.
+	 * @tparam Out A random-access container with assignable elements and the same size.
+	 * @param p The p-values.
+	 * @param out The adjusted p-values.
+	 * @param method The correction method.
+	 * @throws std::invalid_argument If the sizes differ.
+	 */
+	template <typename P, typename Out>
+	inline void pAdjust(const P& p, Out&& out, PAdjustMethod method = PAdjustMethod::BH)
+	{
+		size_t n = p.size();
+		if (static_cast<size_t>(out.size()) != n)
+			throw std::invalid_argument("Output size does not match the number of p-values.");
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+
+		if (method == PAdjustMethod::Bonferroni)
+		{
+			size_t m = 0;
+			for (size_t i = 0; i < n; ++i)
+				m += !std::isnan(static_cast<double>(p[i]));
+			for (size_t i = 0; i < n; ++i)
+			{
+				double v = p[i];
+				out[i] = std::isnan(v) ? nan : std::min(1.0, v * m);
+			}
+			return;
+		}
+
+		std::vector<uint32_t> order = detail::argsortPValues(p);
+		size_t m = order.size();
+		// NaN 的输出先置为 NaN（此时读不到它们的 p 值也无妨）
+		if (m < n)
+		{
+			std::vector<uint8_t> seen(n, 0);
+			for (uint32_t i : order)
+				seen[i] = 1;
+			for (size_t i = 0; i < n; ++i)
+				if (!seen[i])
+					out[i] = nan;
+		}
+		if (m == 0)
+			return;
+
+		if (method == PAdjustMethod::Holm)
+		{
+			double run = 0;
+			for (size_t k = 0; k < m; ++k)
+			{
+				uint32_t i = order[k];
+				run = std::max(run, std::min(1.0, (m - k) * static_cast<double>(p[i])));
+				out[i] = run;
+			}
+			return;
+		}
+
+		// BH、BY、Storey：从最大的 p 值往前取累积最小值
+		double scale = 1.0;
+		if (method == PAdjustMethod::BY)
+		{
+			scale = 0;
+			for (size_t k = 1; k <= m; ++k)
+				scale += 1.0 / k;
+		}
+		else if (method == PAdjustMethod::Storey)
+			scale = detail::estimatePi0Sorted(p, order);
+
+		double run = 1.0;
+		for (size_t k = m; k-- > 0;)
+		{
+			uint32_t i = order[k];
+			run = std::min(run, scale * static_cast<double>(p[i]) * m / (k + 1));
+			out[i] = run;
+		}
+	}
+
+	/**
+	 * Adjusts p-values for multiple testing in place.
+	 *
+	 * @tparam P A random-access container with assignable elements.
+	 * @param p The p-values, overwritten by the adjusted values.
+	 * @param method The correction method.
+	 */
+	template <typename P>
+	inline void pAdjustInPlace(P&& p, PAdjustMethod method = PAdjustMethod::BH)
+	{
+		pAdjust(p, p, method);
+	}
+
+	/**
+	 * Returns adjusted p-values (see pAdjust).
+	 *
+	 * @param p The p-values.
+	 * @param method The correction method.
+	 * @return The adjusted p-values.
+	 */
+	inline std::vector<double> pAdjust(std::vector<double> p, PAdjustMethod method = PAdjustMethod::BH)
+	{
+		pAdjustInPlace(p, method);
+		return p;
+	}
+
+	/**
+	 * Adjusts the false discovery rate (FDR) of a set of p-values using the Benjamini-Hochberg method.
+	 *
+	 * @param p_values A vector of p-values to be adjusted.
+	 * @return A vector of adjusted p-values.
+	 */
+	inline std::vector<double> adjust_fdr(std::vector<double> p_values)
+	{
+		pAdjustInPlace(p_values, PAdjustMethod::BH);
+		return p_values;
+	}
+
+	/*
+	线性模型
+	多分组、带协变量的差异表达（limma 风格）
+	*/
+
+	/**
+	 * Returns the distinct group labels in ascending order.
+	 *
+	 * @param group The group label of each sample.
+	 * @return The sorted distinct labels.
+	 */
+	inline std::vector<int> groupLevels(const std::vector<int>& group)
+	{
+		std::vector<int> levels(group.begin(), group.end());
+		std::sort(levels.begin(), levels.end());
+		levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+		return levels;
+	}
+
+	/**
+	 * Builds a treatment-coded design matrix.
+	 *
+	 * The columns are an intercept, one indicator per group level except the smallest one (the
+	 * reference level), and then the covariates in the given order. Coefficient 1 + k is
+	 * therefore the difference between level groupLevels(group)[k + 1] and the reference level.
+	 *
+	 * @param group The group label of each sample; any integers are allowed.
+	 * @param covariates Extra per-sample columns; each must have one value per sample.
+	 * @return The design matrix, one row per sample.
+	 * @throws std::invalid_argument If the group is empty or a covariate has the wrong length.
+	 */
+	inline std::vector<std::vector<double>> designMatrix(const std::vector<int>& group, const std::vector<std::vector<double>>& covariates = {})
+	{
+		if (group.empty())
+			throw std::invalid_argument("Group is empty.");
+		std::vector<int> levels = groupLevels(group);
+		size_t n = group.size();
+		size_t p = levels.size() + covariates.size();
+		std::vector<std::vector<double>> X(n, std::vector<double>(p, 0.0));
+		for (size_t i = 0; i < n; ++i)
+		{
+			X[i][0] = 1.0;
+			size_t k = std::lower_bound(levels.begin(), levels.end(), group[i]) - levels.begin();
+			if (k > 0)
+				X[i][k] = 1.0;
+		}
+		for (size_t c = 0; c < covariates.size(); ++c)
+		{
+			if (covariates[c].size() != n)
+				throw std::invalid_argument("Covariate size does not match the number of samples.");
+			for (size_t i = 0; i < n; ++i)
+				X[i][levels.size() + c] = covariates[c][i];
+		}
+		return X;
+	}
+
+	/**
+	 * Per-gene least-squares fit of a LinearModel, optionally moderated by eBayes().
+	 */
+	struct LinearModelFit
+	{
+		size_t genes = 0;
+		size_t coefficients = 0;
+		// 残差自由度 n - p
+		double dfResidual = 0;
+		// 系数，genes x coefficients 按行存放
+		std::vector<double> coef;
+		// 残差方差 s^2
+		std::vector<double> sigma2;
+		// (X^T X)^{-1}，coefficients x coefficients 按行存放
+		std::vector<double> unscaledCov;
+
+		// eBayes 之后填写：先验自由度（可能为无穷大）、先验方差和后验方差
+		bool moderated = false;
+		double df0 = 0;
+		double s0sq = 0;
+		std::vector<double> s2post;
+	};
+
+	/**
+	 * Ordinary least squares for many genes that share one design matrix.
+	 *
+	 * The design is factored once with Householder QR (X = QR with a thin Q). fit() then treats
+	 * the genes in blocks: Q^T y for a block of rows is one small matrix product, the
+	 * coefficients follow from R^{-1}, and the residuals are formed explicitly rather than
+	 * through ||y||^2 - ||Q^T y||^2, so genes with a large mean do not lose precision. Blocks
+	 * run in parallel.
+	 */
+	class LinearModel
+	{
+	public:
+		/**
+		 * Factors the design matrix.
+		 *
+		 * @param design The design matrix, one row per sample.
+		 * @throws std::invalid_argument If the design is empty, ragged, has no residual degrees
+		 *         of freedom, or is rank deficient.
+		 */
+		explicit LinearModel(const std::vector<std::vector<double>>& design)
+		{
+			n = design.size();
+			p = n == 0 ? 0 : design[0].size();
+			if (n == 0 || p == 0)
+				throw std::invalid_argument("Design matrix is empty.");
+			if (n <= p)
+				throw std::invalid_argument("Design matrix needs more samples than coefficients.");
+
+			// A 按列存放，便于 Householder 变换
+			std::vector<double> A(n * p);
+			double scale = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (design[i].size() != p)
+					throw std::invalid_argument("Design matrix rows have different lengths.");
+				for (size_t j = 0; j < p; ++j)
+				{
+					A[j * n + i] = design[i][j];
+					scale = std::max(scale, std::abs(design[i][j]));
+				}
+			}
+
+			std::vector<double> V(n * p, 0.0);
+			R.assign(p * p, 0.0);
+			for (size_t k = 0; k < p; ++k)
+			{
+				double* a = A.data() + k * n;
+				double nrm = 0;
+				for (size_t i = k; i < n; ++i)
+					nrm += a[i] * a[i];
+				nrm = std::sqrt(nrm);
+				if (nrm <= 1e-10 * scale * std::sqrt(static_cast<double>(n)))
+					throw std::invalid_argument("Design matrix is rank deficient.");
+
+				double alpha = a[k] > 0 ? -nrm : nrm;
+				double* v = V.data() + k * n;
+				for (size_t i = k; i < n; ++i)
+					v[i] = a[i];
+				v[k] -= alpha;
+				double vn = 0;
+				for (size_t i = k; i < n; ++i)
+					vn += v[i] * v[i];
+				vn = std::sqrt(vn);
+				for (size_t i = k; i < n; ++i)
+					v[i] /= vn;
+
+				// 对剩余列施加 H = I - 2 v v^T
+				for (size_t j = k; j < p; ++j)
+				{
+					double* c = A.data() + j * n;
+					double d = 0;
+					for (size_t i = k; i < n; ++i)
+						d += v[i] * c[i];
+					for (size_t i = k; i < n; ++i)
+						c[i] -= 2 * d * v[i];
+				}
+				for (size_t j = k; j < p; ++j)
+					R[k * p + j] = A[j * n + k];
+			}
+
+			// 薄 Q = H_1 ... H_p [I_p; 0]，按行存放（n x p）
+			Q.assign(n * p, 0.0);
+			std::vector<double> col(n);
+			for (size_t j = 0; j < p; ++j)
+			{
+				std::fill(col.begin(), col.end(), 0.0);
+				col[j] = 1.0;
+				for (size_t k = p; k-- > 0;)
+				{
+					const double* v = V.data() + k * n;
+					double d = 0;
+					for (size_t i = k; i < n; ++i)
+						d += v[i] * col[i];
+					for (size_t i = k; i < n; ++i)
+						col[i] -= 2 * d * v[i];
+				}
+				for (size_t i = 0; i < n; ++i)
+					Q[i * p + j] = col[i];
+			}
+
+			// R^{-1}（上三角）与 (X^T X)^{-1} = R^{-1} R^{-T}
+			Rinv.assign(p * p, 0.0);
+			for (size_t j = 0; j < p; ++j)
+			{
+				Rinv[j * p + j] = 1.0 / R[j * p + j];
+				for (size_t i = j; i-- > 0;)
+				{
+					double s = 0;
+					for (size_t k = i + 1; k <= j; ++k)
+						s += R[i * p + k] * Rinv[k * p + j];
+					Rinv[i * p + j] = -s / R[i * p + i];
+				}
+			}
+			cov.assign(p * p, 0.0);
+			for (size_t i = 0; i < p; ++i)
+				for (size_t j = 0; j < p; ++j)
+				{
+					double s = 0;
+					for (size_t k = std::max(i, j); k < p; ++k)
+						s += Rinv[i * p + k] * Rinv[j * p + k];
+					cov[i * p + j] = s;
+				}
+		}
+
+		size_t samples() const { return n; }
+		size_t coefficients() const { return p; }
+
+		/**
+		 * Computes the least-squares coefficients of a single response.
+		 *
+		 * @param y The response, one value per design row.
+		 * @param beta Output: the p coefficients.
+		 */
+		void solve(const double* y, double* beta) const
+		{
+			std::vector<double> z(p, 0.0);
+			for (size_t j = 0; j < n; ++j)
+				for (size_t k = 0; k < p; ++k)
+					z[k] += y[j] * Q[j * p + k];
+			for (size_t i = 0; i < p; ++i)
+			{
+				double s = 0;
+				for (size_t k = i; k < p; ++k)
+					s += Rinv[i * p + k] * z[k];
+				beta[i] = s;
+			}
+		}
+
+		/**
+		 * Fits every row of a matrix against the design.
+		 *
+		 * @tparam Rows A random-access container of rows; rows[i][j] is gene i in sample j.
+		 * @param rows The data, one row per gene and one column per design row.
+		 * @return The coefficients and residual variances of all genes.
+		 * @throws std::invalid_argument If a row length does not match the design.
+		 */
+		template <typename Rows>
+		LinearModelFit fit(const Rows& rows) const
+		{
+			LinearModelFit res;
+			size_t G = rows.size();
+			res.genes = G;
+			res.coefficients = p;
+			res.dfResidual = static_cast<double>(n - p);
+			res.coef.assign(G * p, 0.0);
+			res.sigma2.assign(G, 0.0);
+			res.unscaledCov = cov;
+
+			const size_t block = 64;
+			parallelFor(0, G, [&](size_t lo, size_t hi) {
+				std::vector<double> Y(block * n), QtY(block * p);
+				for (size_t b0 = lo; b0 < hi; b0 += block)
+				{
+					size_t len = std::min(block, hi - b0);
+					for (size_t g = 0; g < len; ++g)
+					{
+						const auto& y = rows[b0 + g];
+						if (static_cast<size_t>(y.size()) != n)
+							throw std::invalid_argument("Row size does not match the design matrix.");
+						for (size_t j = 0; j < n; ++j)
+							Y[g * n + j] = y[j];
+					}
+
+					// QtY = Y Q（len x n 乘 n x p）
+					std::fill(QtY.begin(), QtY.begin() + len * p, 0.0);
+					for (size_t g = 0; g < len; ++g)
+					{
+						const double* y = Y.data() + g * n;
+						double* z = QtY.data() + g * p;
+						for (size_t j = 0; j < n; ++j)
+						{
+							const double* q = Q.data() + j * p;
+							for (size_t k = 0; k < p; ++k)
+								z[k] += y[j] * q[k];
+						}
+					}
+
+					for (size_t g = 0; g < len; ++g)
+					{
+						const double* y = Y.data() + g * n;
+						const double* z = QtY.data() + g * p;
+						// 系数 = R^{-1} Q^T y
+						double* beta = res.coef.data() + (b0 + g) * p;
+						for (size_t i = 0; i < p; ++i)
+						{
+							double s = 0;
+							for (size_t k = i; k < p; ++k)
+								s += Rinv[i * p + k] * z[k];
+							beta[i] = s;
+						}
+						// 残差 = y - Q Q^T y
+						double rss = 0;
+						for (size_t j = 0; j < n; ++j)
+						{
+							const double* q = Q.data() + j * p;
+							double fitted = 0;
+							for (size_t k = 0; k < p; ++k)
+								fitted += q[k] * z[k];
+							double r = y[j] - fitted;
+							rss += r * r;
+						}
+						res.sigma2[b0 + g] = rss / res.dfResidual;
+					}
+				}
+			}, block);
+			return res;
+		}
+
+	private:
+		size_t n = 0;
+		size_t p = 0;
+		// 薄 Q（n x p）、R、R^{-1} 和 (X^T X)^{-1}，均按行存放
+		std::vector<double> Q;
+		std::vector<double> R;
+		std::vector<double> Rinv;
+		std::vector<double> cov;
+	};
+
+	namespace detail
+	{
+		// trigamma 的反函数，Newton 迭代（Smyth 2004 附录）
+		inline double trigammaInverse(double x)
+		{
+			if (x > 1e7)
+				return 1.0 / std::sqrt(x);
+			if (x < 1e-6)
+				return 1.0 / x;
+			double y = 0.5 + 1.0 / x;
+			for (int iter = 0; iter < 50; ++iter)
+			{
+				double tri = boost::math::trigamma(y);
+				double dif = tri * (1 - tri / x) / boost::math::polygamma(2, y);
+				y += dif;
+				if (-dif / y < 1e-8)
+					break;
+			}
+			return y;
+		}
+
+		// 原地 Cholesky 分解（q x q，按行存放，结果写在下三角）；矩阵不正定时返回 false
+		inline bool choleskyFactor(double* A, size_t q)
+		{
+			for (size_t j = 0; j < q; ++j)
+			{
+				double d = A[j * q + j];
+				for (size_t k = 0; k < j; ++k)
+					d -= A[j * q + k] * A[j * q + k];
+				if (!(d > 1e-14 * std::max(1.0, std::abs(A[j * q + j]))))
+					return false;
+				d = std::sqrt(d);
+				A[j * q + j] = d;
+				for (size_t i = j + 1; i < q; ++i)
+				{
+					double s = A[i * q + j];
+					for (size_t k = 0; k < j; ++k)
+						s -= A[i * q + k] * A[j * q + k];
+					A[i * q + j] = s / d;
+				}
+			}
+			return true;
+		}
+
+		// 由 choleskyFactor 的结果 L 求 (L L^T)^{-1}，写入 inv
+		inline void choleskyInverse(const double* A, size_t q, double* inv)
+		{
+			std::vector<double> Linv(q * q, 0.0);
+			for (size_t j = 0; j < q; ++j)
+			{
+				Linv[j * q + j] = 1.0 / A[j * q + j];
+				for (size_t i = j + 1; i < q; ++i)
+				{
+					double s = 0;
+					for (size_t k = j; k < i; ++k)
+						s += A[i * q + k] * Linv[k * q + j];
+					Linv[i * q + j] = -s / A[i * q + i];
+				}
+			}
+			for (size_t i = 0; i < q; ++i)
+				for (size_t j = 0; j < q; ++j)
+				{
+					double s = 0;
+					for (size_t k = std::max(i, j); k < q; ++k)
+						s += Linv[k * q + i] * Linv[k * q + j];
+					inv[i * q + j] = s;
+				}
+		}
+
+		// Cholesky 分解求对称正定矩阵（q x q，按行存放）的逆
+		inline std::vector<double> symmetricInverse(std::vector<double> A, size_t q)
+		{
+			if (!choleskyFactor(A.data(), q))
+				throw std::invalid_argument("Contrasts are linearly dependent.");
+			std::vector<double> inv(q * q, 0.0);
+			choleskyInverse(A.data(), q, inv.data());
+			return inv;
+		}
+	}
+
+	/**
+	 * Empirical-Bayes moderation of the residual variances (limma eBayes).
+	 *
+	 * Fits a scaled inverse chi-squared prior to the sample variances by moments of
+	 * log(s^2) (Smyth 2004) and replaces every s^2 by the posterior
+	 * (df0 * s0^2 + d * s^2) / (df0 + d). When the observed spread of log(s^2) is no larger than
+	 * sampling noise, df0 is infinite and every gene gets s0^2. Genes with zero or non-finite
+	 * variance do not take part in the prior fit.
+	 *
+	 * @param fit The fit to moderate; df0, s0sq and s2post are filled in.
+	 * @throws std::invalid_argument If fewer than 2 genes have a positive variance.
+	 */
+	inline void eBayes(LinearModelFit& fit)
+	{
+		double d = fit.dfResidual;
+		double shift = boost::math::digamma(d / 2) - std::log(d / 2);
+		std::vector<double> e;
+		e.reserve(fit.genes);
+		for (double s2 : fit.sigma2)
+			if (s2 > 1e-300 && std::isfinite(s2))
+				e.push_back(std::log(s2) - shift);
+		if (e.size() < 2)
+			throw std::invalid_argument("eBayes needs at least 2 genes with positive variance.");
+
+		double emean = mean(e);
+		double evar = sampleVar(e) - boost::math::trigamma(d / 2);
+		if (evar > 0)
+		{
+			fit.df0 = 2 * detail::trigammaInverse(evar);
+			fit.s0sq = std::exp(emean + boost::math::digamma(fit.df0 / 2) - std::log(fit.df0 / 2));
+		}
+		else
+		{
+			fit.df0 = std::numeric_limits<double>::infinity();
+			fit.s0sq = std::exp(emean);
+		}
+
+		fit.s2post.resize(fit.genes);
+		for (size_t i = 0; i < fit.genes; ++i)
+		{
+			if (std::isinf(fit.df0))
+				fit.s2post[i] = fit.s0sq;
+			else
+				fit.s2post[i] = (fit.df0 * fit.s0sq + d * fit.sigma2[i]) / (fit.df0 + d);
+		}
+		fit.moderated = true;
+	}
+
+	/**
+	 * Result of contrastTest, one entry per gene.
+	 */
+	struct ContrastResult
+	{
+		std::vector<double> estimate;
+		std::vector<double> t;
+		std::vector<double> p_value;
+		// 检验使用的自由度（eBayes 之后为 df0 + d，可能为无穷大）
+		double df = 0;
+	};
+
+	/**
+	 * Tests one linear combination c^T beta of the coefficients for every gene.
+	 *
+	 * Uses the posterior variances when the fit has been moderated by eBayes(), and the
+	 * residual variances otherwise. With infinite degrees of freedom the t statistic is
+	 * referred to the standard normal distribution.
+	 *
+	 * @param fit The model fit.
+	 * @param contrast The contrast weights, one per coefficient.
+	 * @return The estimates, t statistics and two-sided p-values.
+	 * @throws std::invalid_argument If the contrast length does not match the fit.
+	 */
+	inline ContrastResult contrastTest(const LinearModelFit& fit, const std::vector<double>& contrast)
+	{
+		size_t p = fit.coefficients;
+		if (contrast.size() != p)
+			throw std::invalid_argument("Contrast size does not match the number of coefficients.");
+
+		double v = 0;
+		for (size_t i = 0; i < p; ++i)
+			for (size_t j = 0; j < p; ++j)
+				v += contrast[i] * fit.unscaledCov[i * p + j] * contrast[j];
+
+		ContrastResult res;
+		res.df = fit.moderated ? fit.df0 + fit.dfResidual : fit.dfResidual;
+		res.estimate.resize(fit.genes);
+		res.t.resize(fit.genes);
+		res.p_value.resize(fit.genes);
+		const std::vector<double>& s2 = fit.moderated ? fit.s2post : fit.sigma2;
+
+		parallelFor(0, fit.genes, [&](size_t lo, size_t hi) {
+			for (size_t g = lo; g < hi; ++g)
+			{
+				const double* beta = fit.coef.data() + g * p;
+				double est = 0;
+				for (size_t i = 0; i < p; ++i)
+					est += contrast[i] * beta[i];
+				double t = est / std::sqrt(s2[g] * v);
+				res.estimate[g] = est;
+				res.t[g] = t;
+				res.p_value[g] = tPValue(t, res.df);
+			}
+		}, 256);
+		return res;
+	}
+
+	/**
+	 * Result of fTest, one entry per gene.
+	 */
+	struct FTestResult
+	{
+		std::vector<double> F;
+		std::vector<double> p_value;
+		double df1 = 0;
+		double df2 = 0;
+	};
+
+	/**
+	 * Jointly tests several contrasts C beta = 0 for every gene (e.g. all group effects,
+	 * which is a one-way ANOVA when the design only has groups).
+	 *
+	 * F = (C beta)^T (C V C^T)^{-1} (C beta) / (q s^2), with V = (X^T X)^{-1} and q contrasts.
+	 * Moderated fits use the posterior variances and df0 + d denominator degrees of freedom;
+	 * with infinite df2, q F is referred to a chi-squared distribution with q degrees of freedom.
+	 *
+	 * @param fit The model fit.
+	 * @param contrasts The contrasts, one row per contrast with one weight per coefficient.
+	 * @return The F statistics and p-values.
+	 * @throws std::invalid_argument If no contrasts are given, a contrast has the wrong length,
+	 *         or the contrasts are linearly dependent.
+	 */
+	inline FTestResult fTest(const LinearModelFit& fit, const std::vector<std::vector<double>>& contrasts)
+	{
+		size_t p = fit.coefficients;
+		size_t q = contrasts.size();
+		if (q == 0)
+			throw std::invalid_argument("No contrasts given.");
+		for (const auto& c : contrasts)
+			if (c.size() != p)
+				throw std::invalid_argument("Contrast size does not match the number of coefficients.");
+
+		// M = (C V C^T)^{-1}
+		std::vector<double> CVC(q * q, 0.0);
+		for (size_t a = 0; a < q; ++a)
+			for (size_t b = 0; b < q; ++b)
+			{
+				double s = 0;
+				for (size_t i = 0; i < p; ++i)
+					for (size_t j = 0; j < p; ++j)
+						s += contrasts[a][i] * fit.unscaledCov[i * p + j] * contrasts[b][j];
+				CVC[a * q + b] = s;
+			}
+		std::vector<double> M = detail::symmetricInverse(CVC, q);
+
+		FTestResult res;
+		res.df1 = static_cast<double>(q);
+		res.df2 = fit.moderated ? fit.df0 + fit.dfResidual : fit.dfResidual;
+		res.F.resize(fit.genes);
+		res.p_value.resize(fit.genes);
+		const std::vector<double>& s2 = fit.moderated ? fit.s2post : fit.sigma2;
+
+		parallelFor(0, fit.genes, [&](size_t lo, size_t hi) {
+			std::vector<double> cb(q);
+			for (size_t g = lo; g < hi; ++g)
+			{
+				const double* beta = fit.coef.data() + g * p;
+				for (size_t a = 0; a < q; ++a)
+				{
+					double s = 0;
+					for (size_t i = 0; i < p; ++i)
+						s += contrasts[a][i] * beta[i];
+					cb[a] = s;
+				}
+				double quad = 0;
+				for (size_t a = 0; a < q; ++a)
+					for (size_t b = 0; b < q; ++b)
+						quad += cb[a] * M[a * q + b] * cb[b];
+				double F = quad / (res.df1 * s2[g]);
+				res.F[g] = F;
+				res.p_value[g] = fPValue(F, res.df1, res.df2);
+			}
+		}, 256);
+		return res;
+	}
+
+	/*
+	第三次扩展
+	线性代数 + PCA + Kmeans
+	*/
+
+	/**
+	 * A dense row-major matrix stored in one contiguous buffer.
+	 *
+	 * Element (i, j) lives at data[i * cols + j]. This is the layout used by gemm and by the
+	 * PCA, LLE and eigen routines; fromRows and toRows convert from and to nested vectors.
+	 */
+	struct DenseMatrix
+	{
+		size_t rows = 0;
+		size_t cols = 0;
+		std::vector<double> data;
+
+		DenseMatrix() = default;
+
+		DenseMatrix(size_t rows, size_t cols, double value = 0.0)
+			: rows(rows), cols(cols), data(rows * cols, value)
+		{
+		}
+
+		double& operator()(size_t i, size_t j)
+		{
+			return data[i * cols + j];
+		}
+
+		double operator()(size_t i, size_t j) const
+		{
+			return data[i * cols + j];
+		}
+
+		double* row(size_t i)
+		{
+			return data.data() + i * cols;
+		}
+
+		const double* row(size_t i) const
+		{
+			return data.data() + i * cols;
+		}
+
+		/**
+		 * Copies a nested-vector matrix into a DenseMatrix.
+		 *
+		 * @param A The matrix, one inner vector per row.
+		 * @return The same matrix in row-major storage.
+		 * @throws std::invalid_argument If the rows have different lengths.
+		 */
+		static DenseMatrix fromRows(const std::vector<std::vector<double>>& A)
+		{
+			DenseMatrix M(A.size(), A.empty() ? 0 : A[0].size());
+			for (size_t i = 0; i < M.rows; ++i)
+			{
+				if (A[i].size() != M.cols)
+				{
+					throw std::invalid_argument("All rows must have the same length.");
+				}
+				std::copy(A[i].begin(), A[i].end(), M.row(i));
+			}
+			return M;
+		}
+
+		/**
+		 * Copies the matrix into nested vectors, one inner vector per row.
+		 */
+		std::vector<std::vector<double>> toRows() const
+		{
+			std::vector<std::vector<double>> A(rows);
+			for (size_t i = 0; i < rows; ++i)
+			{
+				A[i].assign(row(i), row(i) + cols);
+			}
+			return A;
+		}
+	};
+
+	namespace detail
+	{
+		// 寄存器分块：微内核一次算 C 的 MR×NR 子块，累加器常驻寄存器
+		const size_t gemmMR = 4;
+		const size_t gemmNR = 8;
+		// 缓存分块：A 的 MC×KC 块留在 L2，B 的 KC×NC 条带留在 L3
+		const size_t gemmMC = 96;
+		const size_t gemmKC = 256;
+		const size_t gemmNC = 4096;
+		// 每个并行任务负责的 C 列宽（NR 的整数倍）
+		const size_t gemmTileN = 128;
+		// m·n·k 小于该值时直接三重循环，打包的开销不划算
+		const size_t gemmSmall = 48 * 48 * 48;
+
+		// 把 op(A) 的 [i0, i0 + mc) × [p0, p0 + kc) 块按 MR 行一组打包：每组内按 p 连续存放 MR 个元素，不足补 0
+		inline void packA(const double* A, size_t lda, bool trans, size_t i0, size_t p0, size_t mc, size_t kc, double* buf)
+		{
+			for (size_t ir = 0; ir < mc; ir += gemmMR)
+			{
+				size_t mr = std::min(gemmMR, mc - ir);
+				for (size_t p = 0; p < kc; ++p)
+				{
+					for (size_t i = 0; i < gemmMR; ++i)
+					{
+						double v = 0.0;
+						if (i < mr)
+						{
+							size_t r = i0 + ir + i, c = p0 + p;
+							v = trans ? A[c * lda + r] : A[r * lda + c];
+						}
+						*buf++ = v;
+					}
+				}
+			}
+		}
+
+		// 把 op(B) 的 [p0, p0 + kc) × [j0, j0 + nc) 条带按 NR 列一组打包：每组内按 p 连续存放 NR 个元素，不足补 0
+		inline void packB(const double* B, size_t ldb, bool trans, size_t p0, size_t j0, size_t kc, size_t nc, double* buf)
+		{
+			for (size_t jr = 0; jr < nc; jr += gemmNR)
+			{
+				size_t nr = std::min(gemmNR, nc - jr);
+				for (size_t p = 0; p < kc; ++p)
+				{
+					size_t r = p0 + p;
+					if (!trans && nr == gemmNR)
+					{
+						const double* src = B + r * ldb + j0 + jr;
+						std::copy(src, src + gemmNR, buf);
+						buf += gemmNR;
+						continue;
+					}
+					for (size_t j = 0; j < gemmNR; ++j)
+					{
+						double v = 0.0;
+						if (j < nr)
+						{
+							size_t c = j0 + jr + j;
+							v = trans ? B[c * ldb + r] : B[r * ldb + c];
+						}
+						*buf++ = v;
+					}
+				}
+			}
+		}
+
+		// 微内核：C[mr×nr] += alpha · (打包后的 A 组) · (打包后的 B 组)。累加器是定长数组，编译器会把内层展开成 SIMD
+		inline void gemmMicroKernel(size_t kc, const double* a, const double* b, double alpha, double* C, size_t ldc, size_t mr, size_t nr)
+		{
+			double acc[gemmMR][gemmNR] = {};
+			for (size_t p = 0; p < kc; ++p)
+			{
+				const double* bp = b + p * gemmNR;
+				const double* ap = a + p * gemmMR;
+				for (size_t i = 0; i < gemmMR; ++i)
+				{
+					double ai = ap[i];
+					for (size_t j = 0; j < gemmNR; ++j)
+					{
+						acc[i][j] += ai * bp[j];
+					}
+				}
+			}
+			for (size_t i = 0; i < mr; ++i)
+			{
+				double* c = C + i * ldc;
+				for (size_t j = 0; j < nr; ++j)
+				{
+					c[j] += alpha * acc[i][j];
+				}
+			}
+		}
+	}
+
+	/**
+	 * General matrix multiply on row-major buffers: C = alpha op(A) op(B) + beta C.
+	 *
+	 * op(A) is m x k and op(B) is k x n, where op(X) is X or its transpose. lda, ldb and ldc are
+	 * the row strides of the matrices as stored (so a transposed A is stored k x m with stride lda).
+	 * The product is cache-blocked (GotoBLAS style): B strips and A blocks are packed into
+	 * contiguous panels, a register-tiled 4 x 8 micro-kernel does the arithmetic, and the tiles of
+	 * C are spread over parallelFor. Defining BC_USE_BLAS at build time forwards the call to
+	 * cblas_dgemm instead. When beta is 0, C is not read, so it may hold garbage or NaN.
+	 *
+	 * @param transA Whether to use the transpose of A.
+	 * @param transB Whether to use the transpose of B.
+	 * @param m The number of rows of op(A) and C.
+	 * @param n The number of columns of op(B) and C.
+	 * @param k The number of columns of op(A) and rows of op(B).
+	 * @param alpha The scale of the product.
+	 * @param A The first matrix.
+	 * @param lda The row stride of A.
+	 * @param B The second matrix.
+	 * @param ldb The row stride of B.
+	 * @param beta The scale of the existing C.
+	 * @param C The output matrix; must not overlap A or B.
+	 * @param ldc The row stride of C.
+	 */
+	inline void gemm(bool transA, bool transB, size_t m, size_t n, size_t k, double alpha,
+		const double* A, size_t lda, const double* B, size_t ldb, double beta, double* C, size_t ldc)
+	{
+		if (m == 0 || n == 0)
+		{
+			return;
+		}
+#ifdef BC_USE_BLAS
+		// k = 0 时 BLAS 会拒绝 lda = 0，交给下面的 beta 缩放处理
+		if (k > 0)
+		{
+			cblas_dgemm(CblasRowMajor, transA ? CblasTrans : CblasNoTrans, transB ? CblasTrans : CblasNoTrans,
+				static_cast<int>(m), static_cast<int>(n), static_cast<int>(k), alpha, A, static_cast<int>(lda),
+				B, static_cast<int>(ldb), beta, C, static_cast<int>(ldc));
+			return;
+		}
+#endif
+		// 先把 C 乘上 beta，之后只做累加
+		for (size_t i = 0; i < m; ++i)
+		{
+			double* c = C + i * ldc;
+			if (beta == 0.0)
+			{
+				std::fill(c, c + n, 0.0);
+			}
+			else if (beta != 1.0)
+			{
+				for (size_t j = 0; j < n; ++j)
+				{
+					c[j] *= beta;
+				}
+			}
+		}
+		if (k == 0 || alpha == 0.0)
+		{
+			return;
+		}
+
+		if (m * n * k < detail::gemmSmall)
+		{
+			for (size_t i = 0; i < m; ++i)
+			{
+				double* c = C + i * ldc;
+				for (size_t p = 0; p < k; ++p)
+				{
+					double a = alpha * (transA ? A[p * lda + i] : A[i * lda + p]);
+					if (transB)
+					{
+						for (size_t j = 0; j < n; ++j)
+						{
+							c[j] += a * B[j * ldb + p];
+						}
+					}
+					else
+					{
+						const double* b = B + p * ldb;
+						for (size_t j = 0; j < n; ++j)
+						{
+							c[j] += a * b[j];
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		using namespace detail;
+		std::vector<double> packedB;
+		for (size_t jc = 0; jc < n; jc += gemmNC)
+		{
+			size_t nc = std::min(gemmNC, n - jc);
+			size_t ncPadded = (nc + gemmNR - 1) / gemmNR * gemmNR;
+			for (size_t pc = 0; pc < k; pc += gemmKC)
+			{
+				size_t kc = std::min(gemmKC, k - pc);
+				packedB.resize(ncPadded * kc);
+				packB(B, ldb, transB, pc, jc, kc, nc, packedB.data());
+
+				// 任务是 (A 行块, C 列块) 的网格，按行块优先编号，连续的任务共用同一块打包好的 A
+				size_t mBlocks = (m + gemmMC - 1) / gemmMC;
+				size_t nBlocks = (nc + gemmTileN - 1) / gemmTileN;
+				parallelFor(0, mBlocks * nBlocks, [&](size_t lo, size_t hi) {
+					std::vector<double> packedA(gemmMC * kc);
+					size_t packedIc = static_cast<size_t>(-1);
+					for (size_t t = lo; t < hi; ++t)
+					{
+						size_t ic = t / nBlocks * gemmMC;
+						size_t mc = std::min(gemmMC, m - ic);
+						if (ic != packedIc)
+						{
+							packA(A, lda, transA, ic, pc, mc, kc, packedA.data());
+							packedIc = ic;
+						}
+						size_t j0 = t % nBlocks * gemmTileN;
+						size_t j1 = std::min(nc, j0 + gemmTileN);
+						for (size_t jr = j0; jr < j1; jr += gemmNR)
+						{
+							size_t nr = std::min(gemmNR, nc - jr);
+							const double* b = packedB.data() + jr * kc;
+							for (size_t ir = 0; ir < mc; ir += gemmMR)
+							{
+								size_t mr = std::min(gemmMR, mc - ir);
+								gemmMicroKernel(kc, packedA.data() + ir * kc, b, alpha,
+									C + (ic + ir) * ldc + jc + jr, ldc, mr, nr);
+							}
+						}
+					}
+				}, 1);
+			}
+		}
+	}
+
+	/**
+	 * Returns op(A) op(B) for DenseMatrix operands (see gemm).
+	 *
+	 * @param A The first matrix.
+	 * @param B The second matrix.
+	 * @param transA Whether to use the transpose of A.
+	 * @param transB Whether to use the transpose of B.
+	 * @return The product.
+	 * @throws std::invalid_argument If the inner dimensions do not match.
+	 */
+	inline DenseMatrix multiply(const DenseMatrix& A, const DenseMatrix& B, bool transA = false, bool transB = false)
+	{
+		size_t m = transA ? A.cols : A.rows;
+		size_t k = transA ? A.rows : A.cols;
+		size_t kB = transB ? B.cols : B.rows;
+		size_t n = transB ? B.rows : B.cols;
+		if (k != kB)
+		{
+			throw std::invalid_argument("Matrix dimensions do not match for multiplication");
+		}
+		DenseMatrix C(m, n);
+		gemm(transA, transB, m, n, k, 1.0, A.data.data(), A.cols, B.data.data(), B.cols, 0.0, C.data.data(), C.cols);
+		return C;
+	}
+
+	/**
+	 * Returns the cross product A^T A (e.g. a scatter matrix when A holds centered samples in rows).
+	 *
+	 * @param A The matrix.
+	 * @return The symmetric cols x cols product.
+	 */
+	inline DenseMatrix crossprod(const DenseMatrix& A)
+	{
+		return multiply(A, A, true, false);
+	}
+
+	/**
+	 * Multiplies two matrices.
+	 *
+	 * This function performs matrix multiplication, computing the product of two matrices A and B.
+	 * The number of columns in matrix A must be equal to the number of rows in matrix B.
+	 * The operands are copied to DenseMatrix and multiplied by gemm.
+	 *
+	 * @param A The first matrix, represented as a 2D vector.
+	 * @param B The second matrix, represented as a 2D vector.
+	 * @return A new matrix that is the product of A and B, represented as a 2D vector.
+	 * @throws std::invalid_argument If the number of columns in A does not match the number of rows in B.
+	 */
+	inline std::vector<std::vector<double>> multiplyMatrix(const std::vector<std::vector<double>>& A, const std::vector<std::vector<double>>& B)
+	{
+		if (A.empty() || B.empty() || A[0].size() != B.size())
+		{
+			throw std::invalid_argument("Matrix dimensions do not match for multiplication");
+		}
+		return multiply(DenseMatrix::fromRows(A), DenseMatrix::fromRows(B)).toRows();
+	}
+
+	/**
+	 * Finds the position of the largest off-diagonal element in a square matrix.
+	 *
+	 * This function scans the upper triangular part of the matrix (excluding the diagonal)
+	 * and returns the indices of the element with the largest absolute value.
+	 *
+	 * @param mat The square matrix represented as a 2D vector.
+	 * @return A pair of integers representing the indices (row, column) of the largest off-diagonal element.
+	 *         The row index is less than the column index, as the function only considers the upper triangle.
+	 * @throws std::invalid_argument If the matrix is not square (i.e., number of rows is not equal to the number of columns).
+	 */
+	inline std::pair<int, int> findMaxOffDiagonal(const std::vector<std::vector<double>>& mat)
+	{
+		int n = mat.size();
+		double max_val = 0.0;
+		std::pair<int, int> max_pos = { 0, 1 };
+		for (int i = 0; i < n; ++i)
+		{
+			for (int j = i + 1; j < n; ++j)
+			{
+				double abs_val = fabs(mat[i][j]);
+				if (abs_val > max_val)
+				{
+					max_val = abs_val;
+					max_pos = { i, j };
+				}
+			}
+		}
+		return max_pos;
+	}
+
+	/**
+	 * Performs QR decomposition of a matrix.
+	 *
+	 * This function decomposes a matrix A into an orthogonal matrix Q and an upper triangular matrix R
+	 * such that A = QR. The decomposition is done using the Gram-Schmidt process.
+	 *
+	 * @param A The matrix to decompose, represented as a 2D vector.
+	 * @return A pair of matrices Q and R, represented as 2D vectors.
+	 * @throws std::invalid_argument If the matrix A is not square or has incompatible dimensions.
+	 */
+	inline std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> qrDecomposition(std::vector<std::vector<double>> A)
+	{
+		size_t rows = A.size();
+		size_t cols = A[0].size();
+		std::vector<std::vector<double>> Q(rows, std::vector<double>(cols, 0.0));
+		std::vector<std::vector<double>> R(rows, std::vector<double>(cols, 0.0));
+
+		for (size_t i = 0; i < rows; ++i)
+		{
+			Q[i][i] = 1.0;
+		}
+
+		for (size_t j = 0; j < cols; ++j)
+		{
+			double norm = 0.0;
+			for (size_t i = 0; i < rows; ++i)
+			{
+				norm += A[i][j] * A[i][j];
+			}
+			R[j][j] = sqrt(norm);
+
+			std::vector<double> q_col(rows);
+			for (size_t i = 0; i < rows; ++i)
+			{
+				q_col[i] = A[i][j] / R[j][j];
+			}
+
+			for (size_t k = j + 1; k < cols; ++k)
+			{
+				double dot_prod = 0.0;
+				for (size_t i = 0; i < rows; ++i)
+				{
+					dot_prod += q_col[i] * A[i][k];
+				}
+				R[j][k] = dot_prod;
+				for (size_t i = 0; i < rows; ++i)
+				{
+					A[i][k] -= q_col[i] * dot_prod;
+				}
+			}
+
+			for (size_t i = 0; i < rows; ++i)
+			{
+				Q[i][j] = q_col[i];
+			}
+		}
+
+		return { Q, R };
+	}
+
+	/**
+	 * Which eigenpairs symmetricEigen computes.
+	 */
+	enum class EigenRange
+	{
+		// 全部特征对，按特征值升序
+		All,
+		// 最大的 k 个，按特征值降序
+		Largest,
+		// 最小的 k 个，按特征值升序
+		Smallest
+	};
+
+	/**
+	 * Result of symmetricEigen.
+	 */
+	struct SymmetricEigen
+	{
+		std::vector<double> values;
+		// 第 j 列是 values[j] 对应的单位特征向量（n × values.size()）；不求特征向量时为空
+		DenseMatrix vectors;
+	};
+
+	namespace detail
+	{
+		// 生成 Householder 反射 (I − τ v vᵀ) x = β e₁（同 LAPACK dlarfg），v 就地写回 x（v₀ = 1），返回 τ
+		inline double householderVector(double* x, size_t m, double& beta)
+		{
+			double xnorm = 0;
+			for (size_t r = 1; r < m; ++r)
+			{
+				xnorm += x[r] * x[r];
+			}
+			xnorm = std::sqrt(xnorm);
+			double alpha = x[0];
+			x[0] = 1;
+			if (xnorm == 0)
+			{
+				beta = alpha;
+				return 0.0;
+			}
+			beta = alpha >= 0 ? -std::hypot(alpha, xnorm) : std::hypot(alpha, xnorm);
+			double scale = 1 / (alpha - beta);
+			for (size_t r = 1; r < m; ++r)
+			{
+				x[r] *= scale;
+			}
+			return (beta - alpha) / beta;
+		}
+
+		// 对上三角存储的对称块按行做并行遍历：第 r 行有 m − r 个元素，按面积均分成若干任务。
+		// fn(r0, r1, y) 处理 [r0, r1) 行，y 是该线程私有的长度为 m 的累加缓冲区，结束后加到 out 上
+		template <typename Fn>
+		inline void upperTriangleRows(size_t m, std::vector<double>& out, Fn&& fn)
+		{
+			std::fill(out.begin(), out.begin() + m, 0.0);
+			size_t tasks = std::min(m, 4 * threadCount());
+			// 第 s 个任务的起始行：它之前的行恰好占 s / tasks 的面积
+			auto start = [m, tasks](size_t s) {
+				return s >= tasks ? m : static_cast<size_t>(m - m * std::sqrt(1.0 - static_cast<double>(s) / tasks));
+			};
+			std::mutex lock;
+			parallelFor(0, tasks, [&](size_t lo, size_t hi) {
+				std::vector<double> y(m, 0.0);
+				for (size_t t = lo; t < hi; ++t)
+				{
+					fn(start(t), start(t + 1), y.data());
+				}
+				std::lock_guard<std::mutex> guard(lock);
+				for (size_t r = 0; r < m; ++r)
+				{
+					out[r] += y[r];
+				}
+			}, std::max<size_t>(1, tasks * 2048 / (m * m + 1)));
+		}
+
+		// Householder 三对角化（对称矩阵，只读写上三角，就地进行）：A = Q T Qᵀ，Q = H₀ H₁ … H_{n−3}。
+		// 第 i 步把第 i 行 i+1 之后的部分约化为 β e₁，反射向量 v（v₀ = 1）写回该行 i+1 之后的位置，系数为 tau[i]。
+		// 右下角的秩 2 更新 S ← S − v wᵀ − w vᵀ 与下一步需要的对称矩阵-向量乘 τ' S v' 在同一遍扫描中完成，
+		// 每一步只读写一次上三角。结束后 d 是 T 的对角线，e[i] = T(i, i+1)，e[n−1] = 0
+		inline void tridiagonalize(DenseMatrix& A, std::vector<double>& d, std::vector<double>& e, std::vector<double>& tau)
+		{
+			size_t n = A.rows;
+			d.assign(n, 0.0);
+			e.assign(n, 0.0);
+			tau.assign(n, 0.0);
+			if (n >= 3)
+			{
+				// 第 0 步的反射和 p = τ S v 单独计算
+				std::vector<double> p(n), w(n);
+				double beta;
+				tau[0] = householderVector(A.row(0) + 1, n - 1, beta);
+				e[0] = beta;
+				{
+					const double* v = A.row(0) + 1;
+					upperTriangleRows(n - 1, p, [&](size_t r0, size_t r1, double* y) {
+						for (size_t r = r0; r < r1; ++r)
+						{
+							const double* s = A.row(1 + r) + 1;
+							double acc = s[r] * v[r];
+							for (size_t c = r + 1; c < n - 1; ++c)
+							{
+								acc += s[c] * v[c];
+								y[c] += s[c] * v[r];
+							}
+							y[r] += acc;
+						}
+					});
+				}
+				for (size_t i = 0; i + 2 < n; ++i)
+				{
+					d[i] = A(i, i);
+					size_t m = n - i - 1;
+					size_t s0 = i + 1;
+					const double* v = A.row(i) + s0;
+					double t = tau[i];
+
+					// w = p − (τ/2)(pᵀv) v，其中 p = τ S v
+					double K = 0;
+					for (size_t r = 0; r < m; ++r)
+					{
+						w[r] = t * p[r];
+						K += w[r] * v[r];
+					}
+					K *= 0.5 * t;
+					for (size_t r = 0; r < m; ++r)
+					{
+						w[r] -= K * v[r];
+					}
+
+					// 先更新 S 的第一行，由它生成下一步的反射
+					double* first = A.row(s0) + s0;
+					for (size_t c = 0; c < m; ++c)
+					{
+						first[c] -= v[0] * w[c] + w[0] * v[c];
+					}
+					bool next = i + 3 < n;
+					const double* vn = nullptr;
+					if (next)
+					{
+						tau[i + 1] = householderVector(first + 1, m - 1, beta);
+						e[i + 1] = beta;
+						vn = first + 1;
+					}
+
+					// 更新其余各行，同时累加下一步的 S' v'（S' 为去掉第一行、第一列后的块）
+					upperTriangleRows(m - 1, p, [&](size_t r0, size_t r1, double* y) {
+						for (size_t r = r0; r < r1; ++r)
+						{
+							double* s = A.row(s0 + 1 + r) + s0 + 1;
+							const double* vs = v + 1;
+							const double* ws = w.data() + 1;
+							double vr = vs[r], wr = ws[r];
+							if (!next)
+							{
+								for (size_t c = r; c < m - 1; ++c)
+								{
+									s[c] -= vr * ws[c] + wr * vs[c];
+								}
+								continue;
+							}
+							double vnr = vn[r];
+							double sc = s[r] - (vr * ws[r] + wr * vs[r]);
+							s[r] = sc;
+							double acc = sc * vnr;
+							for (size_t c = r + 1; c < m - 1; ++c)
+							{
+								sc = s[c] - (vr * ws[c] + wr * vs[c]);
+								s[c] = sc;
+								acc += sc * vn[c];
+								y[c] += sc * vnr;
+							}
+							y[r] += acc;
+						}
+					});
+				}
+			}
+			if (n >= 2)
+			{
+				d[n - 2] = A(n - 2, n - 2);
+				e[n - 2] = A(n - 2, n - 1);
+			}
+			if (n >= 1)
+			{
+				d[n - 1] = A(n - 1, n - 1);
+			}
+		}
+
+		// 把 Q 作用到 Z 的每一行上（行是三对角基下的向量）：z ← H₀ H₁ … H_{n−3} z。
+		// 反射按 32 个一块写成紧凑 WY 形式 H_j … H_{j+nb−1} = I − V T Vᵀ（同 LAPACK dlarft），
+		// 每块用两次 gemm 作用到全部向量上，从最后一块开始
+		inline void applyTridiagonalQ(const DenseMatrix& A, const std::vector<double>& tau, DenseMatrix& Z)
+		{
+			size_t n = A.rows;
+			size_t k = Z.rows;
+			if (n < 3 || k == 0)
+			{
+				return;
+			}
+			const size_t nb = 32;
+			size_t reflectors = n - 2;
+			size_t blocks = (reflectors + nb - 1) / nb;
+			std::vector<double> V, T(nb * nb), X, Y;
+			for (size_t b = blocks; b-- > 0;)
+			{
+				size_t j0 = b * nb;
+				size_t bs = std::min(nb, reflectors - j0);
+				size_t L = n - j0 - 1;
+
+				// V 的第 q 行是反射 j0 + q 的向量，前 q 个位置补 0
+				V.assign(bs * L, 0.0);
+				for (size_t q = 0; q < bs; ++q)
+				{
+					const double* v = A.row(j0 + q) + j0 + q + 1;
+					std::copy(v, v + (L - q), V.data() + q * L + q);
+				}
+				// T 为上三角：T(j, j) = τ_j，T(0:j, j) = −τ_j T(0:j, 0:j) V(0:j) v_j
+				std::fill(T.begin(), T.end(), 0.0);
+				for (size_t j = 0; j < bs; ++j)
+				{
+					double tj = tau[j0 + j];
+					T[j * nb + j] = tj;
+					if (tj == 0)
+					{
+						continue;
+					}
+					const double* vj = V.data() + j * L;
+					std::vector<double> dots(j);
+					for (size_t q = 0; q < j; ++q)
+					{
+						const double* vq = V.data() + q * L;
+						double s = 0;
+						for (size_t r = j; r < L; ++r)
+						{
+							s += vq[r] * vj[r];
+						}
+						dots[q] = -tj * s;
+					}
+					for (size_t q = 0; q < j; ++q)
+					{
+						double s = 0;
+						for (size_t p = q; p < j; ++p)
+						{
+							s += T[q * nb + p] * dots[p];
+						}
+						T[q * nb + j] = s;
+					}
+				}
+
+				// 以行向量表示：Z ← Z − (Z Vᵀ) Tᵀ V，只涉及第 j0 + 1 列之后的部分
+				double* Zs = Z.data.data() + j0 + 1;
+				X.assign(k * bs, 0.0);
+				Y.assign(k * bs, 0.0);
+				gemm(false, true, k, bs, L, 1.0, Zs, n, V.data(), L, 0.0, X.data(), bs);
+				for (size_t r = 0; r < k; ++r)
+				{
+					for (size_t q = 0; q < bs; ++q)
+					{
+						double s = 0;
+						for (size_t p = q; p < bs; ++p)
+						{
+							s += X[r * bs + p] * T[q * nb + p];
+						}
+						Y[r * bs + q] = s;
+					}
+				}
+				gemm(false, false, k, L, bs, -1.0, Y.data(), bs, V.data(), L, 1.0, Zs, n);
+			}
+		}
+
+		// 隐式 QL（Wilkinson 位移）求对称三对角矩阵的全部特征值，结果写回 d（无序）。
+		// W 非空时，每一轮的 Givens 旋转同时作用到 W 的相邻两行上（W 的行即特征向量），按列分块并行
+		inline void tridiagonalQL(std::vector<double>& d, std::vector<double>& e, DenseMatrix* W)
+		{
+			size_t n = d.size();
+			// 按范数判断分裂（同 EISPACK tql2）：只比较相邻对角元时，零特征值簇里的次对角元永远不够小
+			double tnorm = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				tnorm = std::max(tnorm, std::abs(d[i]) + std::abs(e[i]));
+			}
+			const double tol = std::numeric_limits<double>::epsilon() * tnorm;
+			std::vector<double> rotC(n), rotS(n);
+			for (size_t l = 0; l < n; ++l)
+			{
+				int iter = 0;
+				size_t m;
+				do
+				{
+					for (m = l; m + 1 < n; ++m)
+					{
+						if (std::abs(e[m]) <= tol)
+						{
+							break;
+						}
+					}
+					if (m == l)
+					{
+						break;
+					}
+					if (++iter > 60)
+					{
+						throw std::runtime_error("symmetricEigen: QL iteration did not converge");
+					}
+					double g = (d[l + 1] - d[l]) / (2 * e[l]);
+					double r = std::hypot(g, 1.0);
+					g = d[m] - d[l] + e[l] / (g + (g >= 0 ? r : -r));
+					double s = 1, c = 1, p = 0;
+					size_t count = 0;
+					bool split = false;
+					for (size_t i = m; i-- > l;)
+					{
+						double f = s * e[i], b = c * e[i];
+						r = std::hypot(f, g);
+						e[i + 1] = r;
+						if (r == 0)
+						{
+							// 提前分裂，本轮到此为止
+							d[i + 1] -= p;
+							e[m] = 0;
+							split = true;
+							break;
+						}
+						s = f / r;
+						c = g / r;
+						g = d[i + 1] - p;
+						r = (d[i] - g) * s + 2 * c * b;
+						p = s * r;
+						d[i + 1] = g + p;
+						g = c * r - b;
+						rotC[count] = c;
+						rotS[count] = s;
+						++count;
+					}
+					if (W && count > 0)
+					{
+						size_t cols = W->cols;
+						parallelFor(0, cols, [&](size_t lo, size_t hi) {
+							for (size_t t = 0; t < count; ++t)
+							{
+								size_t i = m - 1 - t;
+								double* wi = W->row(i);
+								double* wj = W->row(i + 1);
+								double ct = rotC[t], st = rotS[t];
+								for (size_t k = lo; k < hi; ++k)
+								{
+									double f = wj[k];
+									wj[k] = st * wi[k] + ct * f;
+									wi[k] = ct * wi[k] - st * f;
+								}
+							}
+						}, std::max<size_t>(64, 65536 / (count + 1)));
+					}
+					if (split)
+					{
+						continue;
+					}
+					d[l] -= p;
+					e[l] = g;
+					e[m] = 0;
+				} while (m != l);
+			}
+		}
+
+		// 反迭代求三对角矩阵 (d, e) 在给定特征值处的特征向量，结果写入 Z 的各行。
+		// lambda 须按升序排列；相距不超过 1e-3‖T‖ 的特征值视为一簇，簇内向量相互正交化（同 LAPACK dstein）
+		inline void tridiagonalInverseIteration(const std::vector<double>& d, const std::vector<double>& e,
+			std::vector<double> lambda, DenseMatrix& Z)
+		{
+			size_t n = d.size();
+			size_t k = lambda.size();
+			const double eps = std::numeric_limits<double>::epsilon();
+			double tnorm = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				tnorm = std::max(tnorm, std::abs(d[i]) + std::abs(e[i]) + (i > 0 ? std::abs(e[i - 1]) : 0.0));
+			}
+			if (tnorm == 0)
+			{
+				tnorm = 1;
+			}
+			double pivotFloor = eps * tnorm;
+			double clusterTol = 1e-3 * tnorm;
+			double perturb = 10 * eps * tnorm;
+
+			// T − λI 的部分选主元 LU：U 每行至多两个上对角元，L 由乘子和行交换标记表示
+			std::vector<double> u0(n), u1(n), u2(n), mult(n);
+			std::vector<char> swapped(n);
+			size_t clusterStart = 0;
+			for (size_t j = 0; j < k; ++j)
+			{
+				if (j > 0 && lambda[j] - lambda[j - 1] > clusterTol)
+				{
+					clusterStart = j;
+				}
+				else if (j > 0 && lambda[j] - lambda[j - 1] < perturb)
+				{
+					// 过近的特征值稍作分开，避免分解完全相同
+					lambda[j] = lambda[j - 1] + perturb;
+				}
+
+				double a = d[0] - lambda[j], b = n > 1 ? e[0] : 0.0;
+				for (size_t i = 0; i + 1 < n; ++i)
+				{
+					double sub = e[i], nd = d[i + 1] - lambda[j], ns = i + 2 < n ? e[i + 1] : 0.0;
+					if (std::abs(sub) > std::abs(a))
+					{
+						swapped[i] = 1;
+						u0[i] = sub;
+						u1[i] = nd;
+						u2[i] = ns;
+						mult[i] = a / sub;
+						a = b - mult[i] * nd;
+						b = -mult[i] * ns;
+					}
+					else
+					{
+						swapped[i] = 0;
+						if (std::abs(a) < pivotFloor)
+						{
+							a = a < 0 ? -pivotFloor : pivotFloor;
+						}
+						u0[i] = a;
+						u1[i] = b;
+						u2[i] = 0;
+						mult[i] = sub / a;
+						a = nd - mult[i] * b;
+						b = ns;
+					}
+				}
+				if (std::abs(a) < pivotFloor)
+				{
+					a = a < 0 ? -pivotFloor : pivotFloor;
+				}
+				u0[n - 1] = a;
+				u1[n - 1] = u2[n - 1] = 0;
+
+				// 起始向量取确定的伪随机数，结果可复现
+				double* x = Z.row(j);
+				for (size_t i = 0; i < n; ++i)
+				{
+					x[i] = static_cast<double>(splitmix64(j * n + i) >> 11) * 0x1.0p-53 - 0.5;
+				}
+				for (int iter = 0; iter < 3; ++iter)
+				{
+					for (size_t i = 0; i + 1 < n; ++i)
+					{
+						if (swapped[i])
+						{
+							std::swap(x[i], x[i + 1]);
+						}
+						x[i + 1] -= mult[i] * x[i];
+					}
+					for (size_t i = n; i-- > 0;)
+					{
+						double s = x[i];
+						if (i + 1 < n)
+						{
+							s -= u1[i] * x[i + 1];
+						}
+						if (i + 2 < n)
+						{
+							s -= u2[i] * x[i + 2];
+						}
+						x[i] = s / u0[i];
+					}
+					// 簇内正交化（修正 Gram-Schmidt）后归一化
+					for (size_t q = clusterStart; q < j; ++q)
+					{
+						const double* y = Z.row(q);
+						double dot = 0;
+						for (size_t i = 0; i < n; ++i)
+						{
+							dot += x[i] * y[i];
+						}
+						for (size_t i = 0; i < n; ++i)
+						{
+							x[i] -= dot * y[i];
+						}
+					}
+					double nrm = 0;
+					for (size_t i = 0; i < n; ++i)
+					{
+						nrm += x[i] * x[i];
+					}
+					nrm = std::sqrt(nrm);
+					for (size_t i = 0; i < n; ++i)
+					{
+						x[i] /= nrm;
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Computes eigenvalues and (optionally) eigenvectors of a real symmetric matrix.
+	 *
+	 * The matrix is reduced to tridiagonal form by Householder reflections, and the eigenvalues
+	 * of the tridiagonal matrix are found by implicit QL with Wilkinson shifts. For all
+	 * eigenpairs, or when more than a quarter of them is requested, the QL rotations are
+	 * accumulated into the eigenvectors. Otherwise only the selected eigenvectors are computed
+	 * by inverse iteration, which is O(n^2 k) after the O(n^3) reduction. Either way the
+	 * vectors are mapped back through the Householder reflections. Both triangles of A are
+	 * read, so the input must be symmetric.
+	 *
+	 * @param A The symmetric matrix (taken by value, used as workspace).
+	 * @param range Which eigenpairs to return.
+	 * @param k The number of eigenpairs for Largest and Smallest (clamped to n); ignored for All.
+	 * @param computeVectors Whether to compute eigenvectors.
+	 * @return The eigenvalues (ascending, or descending for Largest) and the eigenvectors as columns.
+	 * @throws std::invalid_argument If A is not square.
+	 * @throws std::runtime_error If the QL iteration fails to converge (non-finite input).
+	 */
+	inline SymmetricEigen symmetricEigen(DenseMatrix A, EigenRange range = EigenRange::All, size_t k = 0, bool computeVectors = true)
+	{
+		if (A.rows != A.cols)
+		{
+			throw std::invalid_argument("symmetricEigen: the matrix must be square.");
+		}
+		size_t n = A.rows;
+		k = range == EigenRange::All ? n : std::min(k, n);
+
+		std::vector<double> d, e, tau;
+		detail::tridiagonalize(A, d, e, tau);
+
+		SymmetricEigen res;
+		bool accumulate = computeVectors && 4 * k > n;
+		DenseMatrix W;
+		std::vector<double> values = d, off = e;
+		if (accumulate)
+		{
+			W = DenseMatrix(n, n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				W(i, i) = 1.0;
+			}
+		}
+		detail::tridiagonalQL(values, off, accumulate ? &W : nullptr);
+
+		// 选出需要的特征值下标，All/Smallest 升序，Largest 降序
+		std::vector<size_t> order(n);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+		if (range == EigenRange::Largest)
+		{
+			std::reverse(order.begin(), order.end());
+		}
+		order.resize(k);
+		res.values.resize(k);
+		for (size_t j = 0; j < k; ++j)
+		{
+			res.values[j] = values[order[j]];
+		}
+		if (!computeVectors)
+		{
+			return res;
+		}
+
+		DenseMatrix Z(k, n);
+		if (accumulate)
+		{
+			for (size_t j = 0; j < k; ++j)
+			{
+				std::copy(W.row(order[j]), W.row(order[j]) + n, Z.row(j));
+			}
+		}
+		else
+		{
+			// 反迭代要求特征值升序；Largest 时倒序求解，再倒回来
+			std::vector<double> lambda(res.values);
+			if (range == EigenRange::Largest)
+			{
+				std::reverse(lambda.begin(), lambda.end());
+			}
+			detail::tridiagonalInverseIteration(d, e, lambda, Z);
+			if (range == EigenRange::Largest)
+			{
+				for (size_t j = 0; j < k / 2; ++j)
+				{
+					std::swap_ranges(Z.row(j), Z.row(j) + n, Z.row(k - 1 - j));
+				}
+			}
+		}
+		detail::applyTridiagonalQ(A, tau, Z);
+
+		res.vectors = DenseMatrix(n, k);
+		for (size_t j = 0; j < k; ++j)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				res.vectors(i, j) = Z(j, i);
+			}
+		}
+		return res;
+	}
+
+	/**
+	 * Computes the eigenvalues and eigenvectors of a matrix using QR iteration.
+	 *
+	 * Symmetric matrices (the covariance and LLE matrices this is used on) are handed to
+	 * symmetricEigen; the eigenvalues are then returned in descending order and A is overwritten
+	 * with the diagonal matrix of eigenvalues. Other matrices fall back to unshifted QR iteration,
+	 * which stops once no diagonal element changes by more than tol between iterations; the
+	 * columns of the accumulated Q are then Schur vectors rather than eigenvectors.
+	 *
+	 * @param A The matrix to compute eigenvalues and eigenvectors for, represented as a 2D vector.
+	 * @param max_iter The maximum number of iterations to perform in the QR algorithm.
+	 * @param tol The tolerance value to check for convergence. If the change in eigenvalues is less than this, the algorithm stops.
+	 * @return A pair of the eigenvalues (as a vector) and the eigenvectors (as the columns of a 2D vector).
+	 * @throws std::invalid_argument If the matrix A is not square or has incompatible dimensions.
+	 */
+	inline std::pair<std::vector<double>, std::vector<std::vector<double>>> eigenvalues_and_eigenvectors(std::vector<std::vector<double>>& A, int max_iter = 1000, double tol = 1e-6)
+	{
+		size_t n = A.size();
+		DenseMatrix M = DenseMatrix::fromRows(A);
+		if (M.cols != n)
+		{
+			throw std::invalid_argument("Matrix must be square.");
+		}
+
+		bool symmetric = true;
+		for (size_t i = 0; i < n && symmetric; ++i)
+		{
+			for (size_t j = 0; j < i; ++j)
+			{
+				if (std::abs(M(i, j) - M(j, i)) > 1e-12 * (std::abs(M(i, j)) + std::abs(M(j, i))))
+				{
+					symmetric = false;
+					break;
+				}
+			}
+		}
+		if (symmetric)
+		{
+			SymmetricEigen eig = symmetricEigen(std::move(M), EigenRange::Largest, n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				std::fill(A[i].begin(), A[i].end(), 0.0);
+				A[i][i] = eig.values[i];
+			}
+			return { eig.values, eig.vectors.toRows() };
+		}
+
+		std::vector<double> eigenvals(n);
+		std::vector<std::vector<double>> eigenvectors(n, std::vector<double>(n, 0.0));
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			eigenvectors[i][i] = 1.0;
+			eigenvals[i] = A[i][i];
+		}
+
+		for (int iter = 0; iter < max_iter; ++iter)
+		{
+			std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> result = qrDecomposition(A);
+			std::vector<std::vector<double>> Q = result.first;
+			std::vector<std::vector<double>> R = result.second;
+
+			A = multiplyMatrix(R, Q);
+
+			// 与上一轮的对角线比较
+			bool converged = true;
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (fabs(A[i][i] - eigenvals[i]) > tol)
+				{
+					converged = false;
+				}
+				eigenvals[i] = A[i][i];
+			}
+
+			// A_k = (Q₀ Q₁ … Q_k)ᵀ A₀ (Q₀ Q₁ … Q_k)，所以 Q 要乘在右边
+			eigenvectors = multiplyMatrix(eigenvectors, Q);
+
+			if (converged)
+				break;
+		}
+
+		return { eigenvals, eigenvectors };
+	}
+
+	/**
+	 * Options of randomizedPCA.
+	 */
+	struct RandomizedPCAOptions
+	{
+		// 过采样列数 p：草图宽度为 k + p
+		size_t oversampling = 10;
+		// 幂迭代次数 q：奇异值衰减越慢需要越多
+		size_t powerIterations = 2;
+		// 是否把每列除以其（总体）标准差，与 performPCA 一致
+		bool standardize = true;
+		// 随机测试矩阵的种子
+		uint64_t seed = 20240101;
+	};
+
+	/**
+	 * Result of randomizedPCA.
+	 */
+	struct PCAResult
+	{
+		// 样本在主成分上的得分（n × k）
+		DenseMatrix scores;
+		// 第 j 列是第 j 个主成分的单位方向（特征数 × k）
+		DenseMatrix loadings;
+		// 每个主成分解释的方差（除以 n − 1），降序
+		std::vector<double> explained_variance;
+		// 占（标准化后）总方差的比例
+		std::vector<double> explained_variance_ratio;
+		// 中心化用的列均值与标准化用的列尺度（不标准化时全为 1）
+		std::vector<double> means;
+		std::vector<double> scales;
+	};
+
+	namespace detail
+	{
+		// 特征数超过该值时 performPCA 改用随机化 SVD，不再形成特征数 × 特征数的协方差矩阵
+		constexpr size_t pcaExactMaxFeatures = 1024;
+
+		// 逐列均值、尺度与中心化后的平方和；尺度为总体标准差，常数列记为 1
+		inline void columnMoments(const DenseMatrix& X, bool standardize, std::vector<double>& means, std::vector<double>& scales, std::vector<double>& sumsq)
+		{
+			size_t n = X.rows, p = X.cols;
+			means.assign(p, 0.0);
+			scales.assign(p, 1.0);
+			sumsq.assign(p, 0.0);
+			// 每个任务负责一段列，逐行读取该段的连续元素
+			parallelFor(0, p, [&](size_t lo, size_t hi) {
+				for (size_t i = 0; i < n; ++i)
+				{
+					const double* x = X.row(i);
+					for (size_t j = lo; j < hi; ++j)
+					{
+						means[j] += x[j];
+					}
+				}
+				for (size_t j = lo; j < hi; ++j)
+				{
+					means[j] /= n;
+				}
+				for (size_t i = 0; i < n; ++i)
+				{
+					const double* x = X.row(i);
+					for (size_t j = lo; j < hi; ++j)
+					{
+						double d = x[j] - means[j];
+						sumsq[j] += d * d;
+					}
+				}
+				if (standardize)
+				{
+					for (size_t j = lo; j < hi; ++j)
+					{
+						double sd = std::sqrt(sumsq[j] / n);
+						if (sd > 0)
+						{
+							scales[j] = sd;
+						}
+					}
+				}
+			}, 256);
+		}
+
+		// Y = A M，其中 A = (X − 1 μᵀ) diag(1/σ) 不显式形成：A M = X (M/σ) − 1 (μᵀ M/σ)
+		inline DenseMatrix centeredProduct(const DenseMatrix& X, const std::vector<double>& means, const std::vector<double>& scales, const DenseMatrix& M)
+		{
+			DenseMatrix Ms(M.rows, M.cols);
+			std::vector<double> shift(M.cols, 0.0);
+			for (size_t j = 0; j < M.rows; ++j)
+			{
+				for (size_t c = 0; c < M.cols; ++c)
+				{
+					Ms(j, c) = M(j, c) / scales[j];
+					shift[c] += means[j] * Ms(j, c);
+				}
+			}
+			DenseMatrix Y = multiply(X, Ms);
+			for (size_t i = 0; i < Y.rows; ++i)
+			{
+				for (size_t c = 0; c < Y.cols; ++c)
+				{
+					Y(i, c) -= shift[c];
+				}
+			}
+			return Y;
+		}
+
+		// Z = Aᵀ Q = diag(1/σ) (Xᵀ Q − μ (1ᵀ Q))
+		inline DenseMatrix centeredTransposeProduct(const DenseMatrix& X, const std::vector<double>& means, const std::vector<double>& scales, const DenseMatrix& Q)
+		{
+			std::vector<double> colSum(Q.cols, 0.0);
+			for (size_t i = 0; i < Q.rows; ++i)
+			{
+				for (size_t c = 0; c < Q.cols; ++c)
+				{
+					colSum[c] += Q(i, c);
+				}
+			}
+			DenseMatrix Z = multiply(X, Q, true);
+			for (size_t j = 0; j < Z.rows; ++j)
+			{
+				for (size_t c = 0; c < Z.cols; ++c)
+				{
+					Z(j, c) = (Z(j, c) - means[j] * colSum[c]) / scales[j];
+				}
+			}
+			return Z;
+		}
+
+		// 用 Householder QR 把 Y（m × l，m ≥ l）的列就地替换为薄 Q；即使 Y 秩亏，Q 的列也是单位正交的
+		inline void orthonormalizeColumns(DenseMatrix& Y)
+		{
+			size_t m = Y.rows, l = Y.cols;
+			// 按列存放，反射向量连续
+			std::vector<double> V(l * m);
+			for (size_t i = 0; i < m; ++i)
+			{
+				for (size_t j = 0; j < l; ++j)
+				{
+					V[j * m + i] = Y(i, j);
+				}
+			}
+			std::vector<double> tau(l);
+			for (size_t j = 0; j < l; ++j)
+			{
+				double* v = V.data() + j * m + j;
+				double beta;
+				tau[j] = householderVector(v, m - j, beta);
+				for (size_t c = j + 1; c < l; ++c)
+				{
+					double* x = V.data() + c * m + j;
+					double s = 0;
+					for (size_t r = 0; r < m - j; ++r)
+					{
+						s += v[r] * x[r];
+					}
+					s *= tau[j];
+					for (size_t r = 0; r < m - j; ++r)
+					{
+						x[r] -= s * v[r];
+					}
+				}
+			}
+
+			// Q e_c = H_0 ⋯ H_c e_c（c 之后的反射不作用于 e_c）
+			std::vector<double> col(m);
+			for (size_t c = 0; c < l; ++c)
+			{
+				std::fill(col.begin(), col.end(), 0.0);
+				col[c] = 1;
+				for (size_t j = c + 1; j-- > 0;)
+				{
+					const double* v = V.data() + j * m + j;
+					double* x = col.data() + j;
+					double s = 0;
+					for (size_t r = 0; r < m - j; ++r)
+					{
+						s += v[r] * x[r];
+					}
+					s *= tau[j];
+					for (size_t r = 0; r < m - j; ++r)
+					{
+						x[r] -= s * v[r];
+					}
+				}
+				for (size_t i = 0; i < m; ++i)
+				{
+					Y(i, c) = col[i];
+				}
+			}
+		}
+	}
+
+	/**
+	 * Performs PCA with a randomized truncated SVD (Halko, Martinsson and Tropp).
+	 *
+	 * The centered (and optionally standardized) matrix A is never formed: every product with A
+	 * is a gemm on X followed by a rank-one mean correction. A random p x (k + oversampling)
+	 * sketch of the range of A is refined by power iterations, re-orthonormalized after every
+	 * product, and the small projected problem is solved exactly. Cost is a few passes over X
+	 * plus O((n + p) (k + oversampling)^2) work, instead of forming and diagonalizing the p x p
+	 * covariance matrix. Component signs are fixed so that the largest loading of each
+	 * component is positive.
+	 *
+	 * @param X The data, one sample per row.
+	 * @param k The number of components.
+	 * @param options Sketch size, power iterations, standardization and seed.
+	 * @return Scores, loadings, explained variance and the column means and scales used.
+	 * @throws std::invalid_argument If k is 0 or exceeds min(samples, features).
+	 */
+	inline PCAResult randomizedPCA(const DenseMatrix& X, size_t k, const RandomizedPCAOptions& options = RandomizedPCAOptions())
+	{
+		size_t n = X.rows, p = X.cols;
+		if (k == 0 || k > std::min(n, p))
+		{
+			throw std::invalid_argument("The number of components must be between 1 and min(samples, features).");
+		}
+		size_t l = std::min(k + options.oversampling, std::min(n, p));
+
+		PCAResult res;
+		std::vector<double> sumsq;
+		detail::columnMoments(X, options.standardize, res.means, res.scales, sumsq);
+		double total = 0;
+		for (size_t j = 0; j < p; ++j)
+		{
+			total += sumsq[j] / (res.scales[j] * res.scales[j]);
+		}
+
+		// 随机测试矩阵 Ω（p × l），元素在 [−0.5, 0.5) 上均匀分布
+		DenseMatrix omega(p, l);
+		for (size_t i = 0; i < omega.data.size(); ++i)
+		{
+			omega.data[i] = static_cast<double>(detail::splitmix64(options.seed ^ detail::splitmix64(i)) >> 11) * 0x1.0p-53 - 0.5;
+		}
+
+		// 值域草图 Q ≈ range((A Aᵀ)^q A Ω)，每次乘法后重新正交化以免被最大奇异值淹没
+		DenseMatrix Q = detail::centeredProduct(X, res.means, res.scales, omega);
+		detail::orthonormalizeColumns(Q);
+		for (size_t it = 0; it < options.powerIterations; ++it)
+		{
+			DenseMatrix Z = detail::centeredTransposeProduct(X, res.means, res.scales, Q);
+			detail::orthonormalizeColumns(Z);
+			Q = detail::centeredProduct(X, res.means, res.scales, Z);
+			detail::orthonormalizeColumns(Q);
+		}
+
+		// B = Qᵀ A（l × p），以转置 Bᵀ = Aᵀ Q 存放；B Bᵀ = U Σ² Uᵀ 给出 B 的奇异值分解
+		DenseMatrix Bt = detail::centeredTransposeProduct(X, res.means, res.scales, Q);
+		SymmetricEigen eig = symmetricEigen(crossprod(Bt), EigenRange::Largest, k);
+
+		// 右奇异向量 V = Bᵀ U Σ⁻¹ 为载荷，得分 A V = Q U Σ
+		DenseMatrix U = eig.vectors;
+		std::vector<double> sigma(k);
+		for (size_t c = 0; c < k; ++c)
+		{
+			sigma[c] = std::sqrt(std::max(eig.values[c], 0.0));
+		}
+		res.loadings = multiply(Bt, U);
+		for (size_t c = 0; c < k; ++c)
+		{
+			// 零奇异值没有确定的方向，载荷置零
+			double inv = sigma[c] > 0 ? 1 / sigma[c] : 0.0;
+			size_t arg = 0;
+			for (size_t j = 0; j < p; ++j)
+			{
+				res.loadings(j, c) *= inv;
+				if (std::abs(res.loadings(j, c)) > std::abs(res.loadings(arg, c)))
+				{
+					arg = j;
+				}
+			}
+			double sign = res.loadings(arg, c) < 0 ? -1.0 : 1.0;
+			for (size_t j = 0; j < p; ++j)
+			{
+				res.loadings(j, c) *= sign;
+			}
+			for (size_t r = 0; r < l; ++r)
+			{
+				U(r, c) *= sign * sigma[c];
+			}
+		}
+		res.scores = multiply(Q, U);
+
+		res.explained_variance.resize(k);
+		res.explained_variance_ratio.resize(k);
+		for (size_t c = 0; c < k; ++c)
+		{
+			res.explained_variance[c] = sigma[c] * sigma[c] / (n > 1 ? n - 1 : 1);
+			res.explained_variance_ratio[c] = total > 0 ? sigma[c] * sigma[c] / total : 0.0;
+		}
+		return res;
+	}
+
+	/**
+	 * A fitted PCA projection: column means and scales, loadings and explained variance.
+	 *
+	 * fit chooses the solver by width: up to detail::pcaExactMaxFeatures features the
+	 * covariance matrix is diagonalized exactly, wider data goes through randomizedPCA.
+	 * A model built from a PCAResult (e.g. from streamingPCA) projects the same way. save and
+	 * load use a small binary file so that a reference projection can be applied to new
+	 * batches without refitting.
+	 */
+	class PCAModel
+	{
+	public:
+		PCAModel() = default;
+
+		/**
+		 * @param components The number of components fit keeps.
+		 * @param standardize Whether fit divides each feature by its standard deviation.
+		 */
+		explicit PCAModel(size_t components, bool standardize = true)
+			: k(components), standardize(standardize)
+		{
+		}
+
+		/**
+		 * Wraps the result of randomizedPCA or streamingPCA.
+		 */
+		explicit PCAModel(const PCAResult& result)
+			: k(result.loadings.cols), standardize(false), mean(result.means), scale(result.scales), loading(result.loadings),
+			  variance(result.explained_variance), ratio(result.explained_variance_ratio)
+		{
+			for (double s : scale)
+			{
+				standardize = standardize || s != 1.0;
+			}
+		}
+
+		/**
+		 * Fits the model to a dataset.
+		 *
+		 * @param X The data, one sample per row.
+		 * @throws std::invalid_argument If the number of components is 0 or exceeds the number
+		 *         of features.
+		 */
+		void fit(const DenseMatrix& X)
+		{
+			size_t n = X.rows, p = X.cols;
+			if (n == 0)
+			{
+				throw std::invalid_argument("PCAModel: the data is empty.");
+			}
+			if (k == 0 || k > p)
+			{
+				throw std::invalid_argument("The number of components must be between 1 and the number of features.");
+			}
+			if (p > detail::pcaExactMaxFeatures && k <= n)
+			{
+				RandomizedPCAOptions options;
+				options.standardize = standardize;
+				PCAResult res = randomizedPCA(X, k, options);
+				mean = std::move(res.means);
+				scale = std::move(res.scales);
+				loading = std::move(res.loadings);
+				variance = std::move(res.explained_variance);
+				ratio = std::move(res.explained_variance_ratio);
+				return;
+			}
+
+			// 标准化后按行主序放进一块连续内存
+			std::vector<double> sumsq;
+			detail::columnMoments(X, standardize, mean, scale, sumsq);
+			DenseMatrix Z(n, p);
+			parallelFor(0, n, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i)
+				{
+					for (size_t j = 0; j < p; ++j)
+					{
+						Z(i, j) = (X(i, j) - mean[j]) / scale[j];
+					}
+				}
+			}, 64);
+
+			// 协方差矩阵 ZᵀZ / (n − 1)，只求最大的 k 个特征对
+			DenseMatrix cov = crossprod(Z);
+			double total = 0;
+			for (size_t j = 0; j < p; ++j)
+			{
+				total += cov(j, j);
+			}
+			double denom = n > 1 ? static_cast<double>(n - 1) : 1.0;
+			for (double& v : cov.data)
+			{
+				v /= denom;
+			}
+			total /= denom;
+			SymmetricEigen eig = symmetricEigen(std::move(cov), EigenRange::Largest, k);
+			loading = std::move(eig.vectors);
+			variance = std::move(eig.values);
+			ratio.resize(k);
+			for (size_t c = 0; c < k; ++c)
+			{
+				ratio[c] = total > 0 ? variance[c] / total : 0.0;
+				// 与 randomizedPCA 一致：最大载荷为正
+				size_t arg = 0;
+				for (size_t j = 0; j < p; ++j)
+				{
+					if (std::abs(loading(j, c)) > std::abs(loading(arg, c)))
+					{
+						arg = j;
+					}
+				}
+				if (loading(arg, c) < 0)
+				{
+					for (size_t j = 0; j < p; ++j)
+					{
+						loading(j, c) = -loading(j, c);
+					}
+				}
+			}
+		}
+
+		/**
+		 * Projects samples onto the fitted components.
+		 *
+		 * @param X The samples, one per row, with the features the model was fitted on.
+		 * @return The scores (X.rows x components()).
+		 * @throws std::invalid_argument If the model is unfitted or the features do not match.
+		 */
+		DenseMatrix transform(const DenseMatrix& X) const
+		{
+			if (mean.empty() || X.cols != mean.size())
+			{
+				throw std::invalid_argument("PCAModel: the model is unfitted or the number of features does not match.");
+			}
+			return detail::centeredProduct(X, mean, scale, loading);
+		}
+
+		/**
+		 * Fits the model and returns the scores of the same data.
+		 */
+		DenseMatrix fit_transform(const DenseMatrix& X)
+		{
+			fit(X);
+			return transform(X);
+		}
+
+		size_t components() const { return loading.cols; }
+		size_t features() const { return mean.size(); }
+		const std::vector<double>& means() const { return mean; }
+		const std::vector<double>& scales() const { return scale; }
+		// 第 c 列是第 c 个主成分的单位方向（特征数 × 主成分数）
+		const DenseMatrix& loadings() const { return loading; }
+		const std::vector<double>& explainedVariance() const { return variance; }
+		const std::vector<double>& explainedVarianceRatio() const { return ratio; }
+
+		/**
+		 * Writes the fitted model to a binary file (doubles in native byte order, as in .bcm files).
+		 *
+		 * @param filename The output path.
+		 * @throws std::runtime_error If the model is unfitted or the file cannot be written.
+		 */
+		void save(const std::string& filename) const
+		{
+			if (mean.empty())
+			{
+				throw std::runtime_error("PCAModel: cannot save an unfitted model.");
+			}
+			std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+			if (!out.is_open())
+			{
+				throw std::runtime_error("Unable to open file for writing: " + filename);
+			}
+			// 文件头：魔数、版本、特征数、主成分数；随后依次为均值、尺度、解释方差、解释方差比例与载荷
+			uint64_t header[2] = { mean.size(), loading.cols };
+			out.write(modelMagic, sizeof(modelMagic));
+			out.write(reinterpret_cast<const char*>(&modelVersion), sizeof(modelVersion));
+			out.write(reinterpret_cast<const char*>(header), sizeof(header));
+			auto put = [&out](const std::vector<double>& v) {
+				out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(double));
+			};
+			put(mean);
+			put(scale);
+			put(variance);
+			put(ratio);
+			put(loading.data);
+			if (!out.good())
+			{
+				throw std::runtime_error("Failed to write file: " + filename);
+			}
+		}
+
+		/**
+		 * Reads a model written by save.
+		 *
+		 * @param filename The input path.
+		 * @return The model, ready for transform.
+		 * @throws std::runtime_error If the file cannot be read or is not a PCA model.
+		 */
+		static PCAModel load(const std::string& filename)
+		{
+			std::ifstream in(filename, std::ios::binary);
+			if (!in.is_open())
+			{
+				throw std::runtime_error("Unable to open file: " + filename);
+			}
+			char magic[sizeof(modelMagic)];
+			uint32_t version = 0;
+			uint64_t header[2] = { 0, 0 };
+			in.read(magic, sizeof(magic));
+			in.read(reinterpret_cast<char*>(&version), sizeof(version));
+			in.read(reinterpret_cast<char*>(header), sizeof(header));
+			if (!in.good() || std::memcmp(magic, modelMagic, sizeof(magic)) != 0 || version != modelVersion
+				|| header[0] == 0 || header[1] == 0 || header[1] > header[0])
+			{
+				throw std::runtime_error("Not a PCA model file: " + filename);
+			}
+
+			size_t p = static_cast<size_t>(header[0]), k = static_cast<size_t>(header[1]);
+			PCAModel model(k);
+			auto get = [&in](std::vector<double>& v, size_t size) {
+				v.resize(size);
+				in.read(reinterpret_cast<char*>(v.data()), size * sizeof(double));
+			};
+			get(model.mean, p);
+			get(model.scale, p);
+			get(model.variance, k);
+			get(model.ratio, k);
+			model.loading = DenseMatrix(p, k);
+			get(model.loading.data, p * k);
+			if (!in.good())
+			{
+				throw std::runtime_error("Truncated PCA model file: " + filename);
+			}
+			model.standardize = false;
+			for (double s : model.scale)
+			{
+				model.standardize = model.standardize || s != 1.0;
+			}
+			return model;
+		}
+
+	private:
+		static constexpr char modelMagic[8] = { 'B', 'C', 'P', 'C', 'A', 'M', 'D', 'L' };
+		static constexpr uint32_t modelVersion = 1;
+
+		size_t k = 0;
+		bool standardize = true;
+		std::vector<double> mean;
+		std::vector<double> scale;
+		DenseMatrix loading;
+		std::vector<double> variance;
+		std::vector<double> ratio;
+	};
+
+	/**
+	 * Performs Principal Component Analysis (PCA) on a dataset.
+	 *
+	 * This function standardizes the input data, computes the covariance matrix, and performs
+	 * eigenvalue decomposition to find the principal components. The data is then projected onto
+	 * the first 'num_components' principal components. It is PCAModel::fit_transform on a copy of
+	 * the data; keep a PCAModel instead to reuse the loadings or project new samples.
+	 *
+	 * @param data The dataset to perform PCA on, represented as a 2D vector. Rows are samples and columns are features.
+	 * @param num_components The number of principal components to retain after dimensionality reduction.
+	 * @return A new matrix with the projected data, with the shape (n, num_components), where n is the number of samples.
+	 * @throws std::invalid_argument If the number of components is larger than the number of features.
+	 */
+	inline std::vector<std::vector<double>> performPCA(const std::vector<std::vector<double>>& data, int num_components)
+	{
+		if (data.empty() || num_components < 1)
+		{
+			throw std::invalid_argument("The number of components must be between 1 and the number of features.");
+		}
+		PCAModel model(static_cast<size_t>(num_components));
+		return model.fit_transform(DenseMatrix::fromRows(data)).toRows();
+	}
+
+	/**
+	 * Incremental PCA over row blocks (Ross et al. 2008, as in scikit-learn's IncrementalPCA).
+	 *
+	 * Each partialFit call merges one block of samples into the running column means and a rank-k
+	 * basis: the SVD of [diag(σ) V; block − block mean; mean correction] replaces the previous
+	 * factorization, so only the block and the k x features basis are held in memory. Columns
+	 * are divided by fixed scales (e.g. standard deviations from an earlier pass) before the
+	 * update; the means are kept in the original units.
+	 */
+	class IncrementalPCA
+	{
+	public:
+		/**
+		 * @param components The number of components to keep.
+		 * @param scales Per-feature divisors applied to every block; empty means no scaling.
+		 * @throws std::invalid_argument If components is 0.
+		 */
+		explicit IncrementalPCA(size_t components, std::vector<double> scales = {})
+			: k(components), scale(std::move(scales))
+		{
+			if (k == 0)
+			{
+				throw std::invalid_argument("IncrementalPCA needs at least one component.");
+			}
+		}
+
+		/**
+		 * Merges a block of samples into the model.
+		 *
+		 * @param block The samples, one per row.
+		 * @throws std::invalid_argument If the number of features differs from earlier blocks or
+		 *         from the scales.
+		 */
+		void partialFit(const DenseMatrix& block)
+		{
+			size_t m = block.rows;
+			if (m == 0)
+			{
+				return;
+			}
+			if (n == 0)
+			{
+				p = block.cols;
+				mean.assign(p, 0.0);
+				sumsq.assign(p, 0.0);
+				if (scale.empty())
+				{
+					scale.assign(p, 1.0);
+				}
+			}
+			if (block.cols != p || scale.size() != p)
+			{
+				throw std::invalid_argument("IncrementalPCA: the number of features does not match.");
+			}
+
+			std::vector<double> blockMean, blockScale, blockSumsq;
+			detail::columnMoments(block, false, blockMean, blockScale, blockSumsq);
+			size_t total = n + m;
+
+			// 待分解的矩阵：旧的 Σ V、中心化后的新块、均值修正行
+			size_t kc = sigma.size();
+			size_t r = kc + m + (n > 0 ? 1 : 0);
+			DenseMatrix M(r, p);
+			for (size_t c = 0; c < kc; ++c)
+			{
+				for (size_t j = 0; j < p; ++j)
+				{
+					M(c, j) = sigma[c] * basis(c, j);
+				}
+			}
+			parallelFor(0, m, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i)
+				{
+					const double* x = block.row(i);
+					double* y = M.row(kc + i);
+					for (size_t j = 0; j < p; ++j)
+					{
+						y[j] = (x[j] - blockMean[j]) / scale[j];
+					}
+				}
+			}, 64);
+			double w = std::sqrt(static_cast<double>(n) * m / total);
+			for (size_t j = 0; j < p; ++j)
+			{
+				double delta = blockMean[j] - mean[j];
+				if (n > 0)
+				{
+					M(r - 1, j) = w * delta / scale[j];
+				}
+				mean[j] += delta * m / total;
+				sumsq[j] += blockSumsq[j] + delta * delta * n * m / total;
+			}
+			n = total;
+
+			// M 的前 k 个右奇异向量：M Mᵀ = U Σ² Uᵀ，V = Σ⁻¹ Uᵀ M
+			SymmetricEigen eig = symmetricEigen(multiply(M, M, false, true), EigenRange::Largest, std::min(k, r));
+			basis = multiply(eig.vectors, M, true, false);
+			sigma.resize(eig.values.size());
+			for (size_t c = 0; c < sigma.size(); ++c)
+			{
+				sigma[c] = std::sqrt(std::max(eig.values[c], 0.0));
+				double inv = sigma[c] > 0 ? 1 / sigma[c] : 0.0;
+				double* v = basis.row(c);
+				size_t arg = 0;
+				for (size_t j = 0; j < p; ++j)
+				{
+					v[j] *= inv;
+					if (std::abs(v[j]) > std::abs(v[arg]))
+					{
+						arg = j;
+					}
+				}
+				// 固定符号（最大载荷为正），否则相邻两块之间主成分可能翻转
+				if (v[arg] < 0)
+				{
+					for (size_t j = 0; j < p; ++j)
+					{
+						v[j] = -v[j];
+					}
+				}
+			}
+		}
+
+		/**
+		 * Projects a block of samples onto the current components.
+		 *
+		 * @param block The samples, one per row, with the same features as the fitted blocks.
+		 * @return The scores (block.rows x components()).
+		 * @throws std::invalid_argument If the model is unfitted or the features do not match.
+		 */
+		DenseMatrix transform(const DenseMatrix& block) const
+		{
+			if (n == 0 || block.cols != p)
+			{
+				throw std::invalid_argument("IncrementalPCA: the model is unfitted or the number of features does not match.");
+			}
+			return detail::centeredProduct(block, mean, scale, loadings());
+		}
+
+		size_t samples() const { return n; }
+		size_t components() const { return sigma.size(); }
+		const std::vector<double>& means() const { return mean; }
+		const std::vector<double>& scales() const { return scale; }
+
+		/**
+		 * @return The unit principal directions as columns (features x components()).
+		 */
+		DenseMatrix loadings() const
+		{
+			DenseMatrix L(p, sigma.size());
+			for (size_t c = 0; c < sigma.size(); ++c)
+			{
+				for (size_t j = 0; j < p; ++j)
+				{
+					L(j, c) = basis(c, j);
+				}
+			}
+			return L;
+		}
+
+		/**
+		 * @return The variance along each component (divided by n - 1), descending.
+		 */
+		std::vector<double> explainedVariance() const
+		{
+			std::vector<double> res(sigma.size());
+			for (size_t c = 0; c < sigma.size(); ++c)
+			{
+				res[c] = sigma[c] * sigma[c] / (n > 1 ? n - 1 : 1);
+			}
+			return res;
+		}
+
+		/**
+		 * @return The share of the total (scaled) variance explained by each component.
+		 */
+		std::vector<double> explainedVarianceRatio() const
+		{
+			double total = 0;
+			for (size_t j = 0; j < p; ++j)
+			{
+				total += sumsq[j] / (scale[j] * scale[j]);
+			}
+			std::vector<double> res(sigma.size());
+			for (size_t c = 0; c < sigma.size(); ++c)
+			{
+				res[c] = total > 0 ? sigma[c] * sigma[c] / total : 0.0;
+			}
+			return res;
+		}
+
+	private:
+		size_t k;
+		size_t n = 0;
+		size_t p = 0;
+		// 原始单位下的列均值、中心化平方和，以及每列的除数
+		std::vector<double> mean;
+		std::vector<double> sumsq;
+		std::vector<double> scale;
+		// 第 c 行是第 c 个主成分的单位方向，sigma[c] 是对应的奇异值
+		DenseMatrix basis;
+		std::vector<double> sigma;
+	};
+
+	/**
+	 * Runs PCA on row blocks supplied by a reader, without holding the whole matrix.
+	 *
+	 * The data is read in up to three passes: column standard deviations (when standardizing,
+	 * merged block by block), IncrementalPCA::partialFit, and the projection of every block.
+	 * Apart from the returned scores, memory is bounded by blockRows x features plus the
+	 * components x features basis. Standardization matches performPCA (population standard
+	 * deviation; constant columns are left unscaled).
+	 *
+	 * @param rows The number of samples.
+	 * @param cols The number of features.
+	 * @param k The number of components.
+	 * @param read Callback read(first, count, out) that writes rows [first, first + count) into
+	 *        out, row-major (count x cols).
+	 * @param blockRows The number of rows per block (raised to k if smaller).
+	 * @param standardize Whether to divide each feature by its standard deviation.
+	 * @param project Whether to run the projection pass; when false the scores are left empty.
+	 * @return Scores, loadings, explained variance, means and scales.
+	 * @throws std::invalid_argument If k is 0 or exceeds min(rows, cols).
+	 */
+	template <typename ReadRows>
+	inline PCAResult streamingPCA(size_t rows, size_t cols, size_t k, ReadRows&& read, size_t blockRows = 512, bool standardize = true, bool project = true)
+	{
+		if (k == 0 || k > std::min(rows, cols))
+		{
+			throw std::invalid_argument("The number of components must be between 1 and min(samples, features).");
+		}
+		blockRows = std::max(blockRows, k);
+		DenseMatrix block;
+		auto load = [&](size_t first) {
+			size_t count = std::min(blockRows, rows - first);
+			block.rows = count;
+			block.cols = cols;
+			block.data.resize(count * cols);
+			read(first, count, block.data.data());
+		};
+
+		// 第一遍：逐块合并列均值与平方和（Chan 等人的合并公式）得到标准差
+		std::vector<double> scales;
+		if (standardize)
+		{
+			std::vector<double> mean(cols, 0.0), sumsq(cols, 0.0), bm, bs, bss;
+			size_t seen = 0;
+			for (size_t first = 0; first < rows; first += blockRows)
+			{
+				load(first);
+				detail::columnMoments(block, false, bm, bs, bss);
+				size_t total = seen + block.rows;
+				for (size_t j = 0; j < cols; ++j)
+				{
+					double delta = bm[j] - mean[j];
+					mean[j] += delta * block.rows / total;
+					sumsq[j] += bss[j] + delta * delta * seen * block.rows / total;
+				}
+				seen = total;
+			}
+			scales.assign(cols, 1.0);
+			for (size_t j = 0; j < cols; ++j)
+			{
+				double sd = std::sqrt(sumsq[j] / rows);
+				if (sd > 0)
+				{
+					scales[j] = sd;
+				}
+			}
+		}
+
+		// 第二遍：增量拟合
+		IncrementalPCA ipca(k, std::move(scales));
+		for (size_t first = 0; first < rows; first += blockRows)
+		{
+			load(first);
+			ipca.partialFit(block);
+		}
+
+		// 第三遍：投影
+		PCAResult res;
+		if (project)
+		{
+			res.scores = DenseMatrix(rows, ipca.components());
+		}
+		for (size_t first = 0; project && first < rows; first += blockRows)
+		{
+			load(first);
+			DenseMatrix s = ipca.transform(block);
+			std::copy(s.data.begin(), s.data.end(), res.scores.row(first));
+		}
+		res.loadings = ipca.loadings();
+		res.explained_variance = ipca.explainedVariance();
+		res.explained_variance_ratio = ipca.explainedVarianceRatio();
+		res.means = ipca.means();
+		res.scales = ipca.scales();
+		return res;
+	}
+
+	/**
+	 * Computes the Euclidean distance between two vectors.
+	 *
+	 * The Euclidean distance between two vectors `a` and `b` is calculated as the square root of the sum of the squared differences
+	 * between corresponding elements in the vectors:
+	 *
+	 *     distance = sqrt( Σ (a[i] - b[i])^2 )
+	 *
+	 * This distance measure is commonly used to quantify the similarity or dissimilarity between two data points in Euclidean space.
+	 *
+	 * @param a The first vector, represented as a 1D vector of `double` values.
+	 * @param b The second vector, represented as a 1D vector of `double` values.
+	 *
+	 * @return The Euclidean distance between the two vectors, as a `double` value.
+	 *
+	 * @throws std::invalid_argument If the vectors `a` and `b` have different sizes.
+	 */
+	inline double euclideanDistance(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			sum += (a[i] - b[i]) * (a[i] - b[i]);
+		}
+		return sqrt(sum);
+	}
+
+	/**
+	 * Performs K-means clustering algorithm on a dataset.
+	 *
+	 * The K-means algorithm divides the data into K clusters by iteratively assigning data points
+	 * to the nearest cluster center and then updating the cluster centers based on the mean of the points
+	 * assigned to each cluster. The process continues until the cluster centers no longer change or a maximum
+	 * number of iterations is reached.
+	 *
+	 * @param data A 2D vector representing the dataset, where each row is a data point and each column is a feature.
+	 * @param k The number of clusters to divide the data into.
+	 * @param max_iter The maximum number of iterations for the algorithm to run. Defaults to 1000 iterations.
+	 *
+	 * @return A vector of integers where each element corresponds to the cluster label assigned to the respective data point.
+	 *         The size of the vector is equal to the number of data points (n).
+	 *
+	 * @throws std::invalid_argument If the number of clusters (k) is less than 1.
+	 * @throws std::invalid_argument If the dataset is empty or not well-formed (e.g., inconsistent row lengths).
+	 */
+	inline std::vector<int> kMeans(const std::vector<std::vector<double>>& data, int k, int max_iter = 1000)
+	{
+		size_t n = data.size();
+		size_t m = data[0].size();
+
+		// 初始化簇中心
+		std::vector<std::vector<double>> centroids(k, std::vector<double>(m));
+		std::vector<int> labels(n, -1); // 存储每个数据点的簇标签
+
+		// 随机选择初始簇中心
+		srand(time(0));
+		std::vector<int> indices(n);
+		std::iota(indices.begin(), indices.end(), 0);
+		random_shuffle(indices.begin(), indices.end());
+
+		for (int i = 0; i < k; ++i)
+		{
+			centroids[i] = data[indices[i]]; // 新的簇中心
+		}
+
+		for (int iter = 0; iter < max_iter; ++iter)
+		{
+			bool changed = false;
+
+			// 分配每个点到最近的簇
+			for (size_t i = 0; i < n; ++i)
+			{
+				double min_dist = std::numeric_limits<double>::infinity();
+				int closest_centroid = -1;
+
+				for (int j = 0; j < k; ++j)
+				{
+					double dist = euclideanDistance(data[i], centroids[j]);
+					if (dist < min_dist)
+					{
+						min_dist = dist;
+						closest_centroid = j;
+					}
+				}
+
+				if (labels[i] != closest_centroid)
+				{
+					labels[i] = closest_centroid;
+					changed = true;
+				}
+			}
+
+			// 更新簇中心
+			std::vector<std::vector<double>> new_centroids(k, std::vector<double>(m, 0.0));
+			std::vector<int> count(k, 0); // 记录每个簇中点的数量
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				int cluster = labels[i];
+				for (size_t j = 0; j < m; ++j)
+				{
+					new_centroids[cluster][j] += data[i][j];
+				}
+				count[cluster]++;
+			}
+
+			for (int j = 0; j < k; ++j)
+			{
+				for (size_t i = 0; i < m; ++i)
+				{
+					new_centroids[j][i] /= count[j];
+				}
+			}
+
+			centroids = new_centroids;
+
+			// 如果没有簇中心变化，停止迭代
+			if (!changed)
+			{
+				break;
+			}
+		}
+
+		return labels;
+	}
+
+	/*
+	第四次扩展
+	层次聚类 + KDE图
+	*/
+
+	/**
+	 * @struct Linkage
+	 * @brief Represents a single merge event in hierarchical clustering.
+	 *
+	 * Each record contains indices of two clusters merged, the distance between
+	 * them at merge time, and the size (number of samples) of the new cluster.
+	 */
+	struct Linkage
+	{
+		int idx1, idx2;
+		double dist;
+		int size;
+	};
+
+	/**
+	 * @brief Compute pairwise Euclidean distance matrix.
+	 * @param data N*D matrix
+	 * @return N*N symmetric matrix of distances
+	 */
+	inline std::vector<std::vector<double>> computeDistanceMatrix(const std::vector<std::vector<double>>& data) {
+		int N = data.size();
+		std::vector<std::vector<double>> dist(N, std::vector<double>(N, 0.0));
+		for (int i = 0; i < N; ++i) {
+			for (int j = i + 1; j < N; ++j) {
+				double sum = 0;
+				for (size_t k = 0; k < data[i].size(); ++k) {
+					double d = data[i][k] - data[j][k];
+					sum += d * d;
+				}
+				dist[i][j] = dist[j][i] = std::sqrt(sum);
+			}
+		}
+		return dist;
+	}
+
+	/**
+	 * @brief Perform single-linkage hierarchical clustering.
+	 * @param distMat precomputed distance matrix
+	 * @return linkage matrix (size N-1) with merge records
+	 */
+	inline std::vector<Linkage> hierarchicalClustering(
+		std::vector<std::vector<double>> distMat
+	) {
+		int N = distMat.size();
+		// 初始：每个叶子自成一簇
+		std::map<int, std::vector<int>> clusters;
+		for (int i = 0; i < N; ++i) clusters[i] = { i };
+
+		std::vector<Linkage> Z;
+		Z.reserve(N - 1);
+		int nextId = N;
+
+		while (clusters.size() > 1) {
+			double best = std::numeric_limits<double>::infinity();
+			int a = -1, b = -1;
+			// 找到最近的簇对 (a, b)
+			for (auto it1 = clusters.begin(); it1 != clusters.end(); ++it1) {
+				for (auto it2 = std::next(it1); it2 != clusters.end(); ++it2) {
+					double dmin = std::numeric_limits<double>::infinity();
+					for (int i : it1->second)
+						for (int j : it2->second)
+							dmin = std::min(dmin, distMat[i][j]);
+					if (dmin < best) {
+						best = dmin;
+						a = it1->first;
+						b = it2->first;
+					}
+				}
+			}
+
+			auto merged = clusters[a];
+			merged.insert(merged.end(),
+				clusters[b].begin(),
+				clusters[b].end());
+
+			// 记录 linkage
+			Z.push_back({ a, b, best, (int)merged.size() });
+
+			clusters.erase(a);
+			clusters.erase(b);
+			clusters[nextId++] = std::move(merged);
+		}
+
+		return Z;
+	}
+
+	/**
+	 * @brief Gaussian kernel function
+	 * @param u normalized distance (x - xi) / bandwidth
+	 */
+	inline double gaussianKernel(double u) {
+		static const double inv_sqrt2pi = 1.0 / std::sqrt(2 * M_PI);
+		return inv_sqrt2pi * std::exp(-0.5 * u * u);
+	}
+
+	/**
+	 * @brief Compute KDE densities for given samples over a grid
+	 * @param data input sample vector
+	 * @param grid_x grid points at which to evaluate KDE
+	 * @param bandwidth kernel bandwidth
+	 * @return vector of density values
+	 */
+	inline std::vector<double> computeKDE(
+		const std::vector<double>& data,
+		const std::vector<double>& grid_x,
+		double bandwidth
+	) {
+		int n = data.size();
+		std::vector<double> densities(grid_x.size());
+		for (size_t i = 0; i < grid_x.size(); ++i) {
+			double x = grid_x[i];
+			double sum = 0.0;
+			for (double xi : data) {
+				sum += gaussianKernel((x - xi) / bandwidth);
+			}
+			densities[i] = sum / (n * bandwidth);
+		}
+		return densities;
+	}
+
+	/**
+	 * @brief Plot KDE using matplotlib-cpp
+	 * @param samples input data samples
+	 * @param bandwidth Gaussian kernel bandwidth
+	 * @param grid_n number of grid points (default 200)
+	 * @param width figure width in pixels (default 800)
+	 * @param height figure height in pixels (default 600)
+	 */
+
+	 /*
+	 第五次扩展
+	 t-SNE降维 LLE降维
+	 */
+
+	 /**
+	  * @brief 对单行距离平方向量使用二分搜索确定局部高维相似度分布。
+	  *
+	  * @param dist2_row 长度为 n 的距离平方向量。
+	  * @param target_perplexity 目标困惑度。
+	  * @param max_iter 最大二分搜索迭代次数。
+	  * @param tol 熵误差容限。
+	  * @return 长度为 n 的概率分布 P(i|j)。
+	  */
+	inline std::vector<double> binarySearchSigma(
+		const std::vector<double>& dist2_row,
+		double target_perplexity,
+		int max_iter = 50,
+		double tol = 1e-5
+	)
+	{
+		double beta_min = -INFINITY, beta_max = INFINITY;
+		double beta = 1.0;
+		size_t n = dist2_row.size();
+		std::vector<double> P(n);
+		for (int iter = 0; iter < max_iter; ++iter) {
+			double sumP = 0.0;
+			for (size_t j = 0; j < n; ++j) {
+				P[j] = std::exp(-dist2_row[j] * beta);
+				sumP += P[j];
+			}
+			double H = 0.0;
+			for (size_t j = 0; j < n; ++j) {
+				P[j] /= sumP;
+				if (P[j] > 1e-12) H -= P[j] * std::log(P[j]);
+			}
+			double perplexity = std::exp(H);
+			double diff = perplexity - target_perplexity;
+			if (std::fabs(diff) < tol) break;
+			if (diff > 0) {
+				beta_min = beta;
+				beta = (beta_max == INFINITY ? beta * 2 : 0.5 * (beta + beta_max));
+			}
+			else {
+				beta_max = beta;
+				beta = (beta_min == -INFINITY ? beta / 2 : 0.5 * (beta + beta_min));
+			}
+		}
+		return P;
+	}
+
+	/**
+	 * @brief 计算高维空间的对称化相似度矩阵 P。
+	 *
+	 * 对于每个样本 i，先调用 binarySearchSigma 获得 P(i|j)，
+	 * 然后对称化：P_{ij} = (P(i|j) + P(j|i)) / (2n)。
+	 *
+	 * @param dist2 n*n 的距离平方矩阵。
+	 * @param perplexity 困惑度。
+	 * @return n*n 的高维相似度矩阵 P。
+	 */
+	inline std::vector<std::vector<double>> computeHighDimAffinities(
+		const std::vector<std::vector<double>>& dist2,
+		double perplexity
+	) {
+		size_t n = dist2.size();
+		std::vector<std::vector<double>> P(n, std::vector<double>(n, 0.0));
+		for (size_t i = 0; i < n; ++i) {
+			auto Pi = binarySearchSigma(dist2[i], perplexity);
+			for (size_t j = 0; j < n; ++j) P[i][j] = Pi[j];
+		}
+		// 对称化并归一化
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = i + 1; j < n; ++j) {
+				double val = (P[i][j] + P[j][i]) / (2.0 * n);
+				P[i][j] = P[j][i] = val;
+			}
+		}
+		return P;
+	}
+
+	/**
+	 * @brief 计算低维空间的学生 t 分布相似度矩阵 Q。
+	 *
+	 * Q_{ij} = (1 + ||y_i - y_j||^2)^{-1}，然后整体除以总和。
+	 *
+	 * @param Y 低维坐标矩阵，大小 n*dim。
+	 * @return n*n 的相似度矩阵 Q。
+	 */
+	inline std::vector<std::vector<double>> computeLowDimAffinities(
+		const std::vector<std::vector<double>>& Y
+	) {
+		size_t n = Y.size();
+		std::vector<std::vector<double>> Q(n, std::vector<double>(n, 0.0));
+		double sum = 0.0;
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = i + 1; j < n; ++j) {
+				double dist2 = 0.0;
+				for (size_t d = 0; d < Y[i].size(); ++d) {
+					double diff = Y[i][d] - Y[j][d];
+					dist2 += diff * diff;
+				}
+				double inv = 1.0 / (1.0 + dist2);
+				Q[i][j] = Q[j][i] = inv;
+				sum += 2.0 * inv;
+			}
+			Q[i][i] = 0.0;
+		}
+		// 归一化
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < n; ++j)
+				Q[i][j] /= sum;
+		return Q;
+	}
+
+	/**
+	 * @brief 压缩行存储（CSR）的稀疏矩阵。
+	 *
+	 * 第 i 行的非零元为 col[rowPtr[i]] .. col[rowPtr[i + 1] - 1]，取值在 val 的相同位置，
+	 * 每行按列号升序排列。
+	 */
+	struct SparseMatrix {
+		size_t rows = 0;
+		size_t cols = 0;
+		std::vector<size_t> rowPtr;
+		std::vector<size_t> col;
+		std::vector<double> val;
+
+		size_t nonZeros() const { return val.size(); }
+	};
+
+	/**
+	 * @brief t-SNE 的参数。
+	 */
+	struct TSNEOptions {
+		// 目标维度
+		size_t dim = 2;
+		// 困惑度，每个样本只在 3 × perplexity 个近邻上计算 P
+		double perplexity = 30.0;
+		// 迭代次数
+		size_t maxIter = 1000;
+		// 学习率；不大于 0 时取 max(n / exaggeration, 200)
+		double learningRate = 200.0;
+		// Barnes-Hut 精度：格子边长 / 距离 < theta 时把整个格子当作一个点；0 表示精确计算斥力
+		double theta = 0.5;
+		// 早期夸大系数及其持续的迭代数，之后动量由 0.5 改为 0.8
+		double exaggeration = 12.0;
+		size_t exaggerationIter = 250;
+		// 初始坐标的随机种子
+		uint64_t seed = 20240101;
+	};
+
+	namespace detail {
+		// 精确 k 近邻（不含自身）：按行块用 gemm 求内积得到距离平方，每行用 nth_element 选出最近的 k 个并按距离排序。
+		// idx、dist2 均为 n × k 行优先
+		inline void bruteForceNeighbors(const DenseMatrix& X, size_t k, std::vector<size_t>& idx, std::vector<double>& dist2) {
+			size_t n = X.rows, d = X.cols;
+			idx.assign(n * k, 0);
+			dist2.assign(n * k, 0.0);
+			std::vector<double> norms(n, 0.0);
+			for (size_t i = 0; i < n; ++i) {
+				const double* x = X.row(i);
+				for (size_t c = 0; c < d; ++c) norms[i] += x[c] * x[c];
+			}
+			// 每块的内积矩阵控制在约 4M 个 double
+			size_t block = std::min(n, std::max<size_t>(1, (size_t(1) << 22) / n));
+			std::vector<double> dots(block * n);
+			for (size_t lo = 0; lo < n; lo += block) {
+				size_t rows = std::min(block, n - lo);
+				gemm(false, true, rows, n, d, 1.0, X.row(lo), d, X.data.data(), d, 0.0, dots.data(), n);
+				parallelFor(0, rows, [&](size_t a, size_t b) {
+					std::vector<std::pair<double, size_t>> cand(n - 1);
+					for (size_t r = a; r < b; ++r) {
+						size_t i = lo + r;
+						const double* dot = dots.data() + r * n;
+						size_t m = 0;
+						for (size_t j = 0; j < n; ++j) {
+							if (j == i) continue;
+							cand[m++] = { std::max(norms[i] + norms[j] - 2 * dot[j], 0.0), j };
+						}
+						std::nth_element(cand.begin(), cand.begin() + (k - 1), cand.end());
+						std::sort(cand.begin(), cand.begin() + k);
+						for (size_t t = 0; t < k; ++t) {
+							dist2[i * k + t] = cand[t].first;
+							idx[i * k + t] = cand[t].second;
+						}
+					}
+				}, 4);
+			}
+		}
+
+		// 欧氏距离的 vantage-point 树：每个结点取一个样本为中心，按到它的距离中位数把其余样本分成内外两半，
+		// 查询时用三角不等式剪枝
+		class VantagePointTree {
+		public:
+			explicit VantagePointTree(const DenseMatrix& X, uint64_t seed = 20240101) : X(X), items(X.rows), seed(seed) {
+				std::iota(items.begin(), items.end(), size_t(0));
+				nodes.reserve(X.rows);
+				root = build(0, X.rows);
+			}
+
+			// 查询点 q 的 k 个最近邻（跳过下标 exclude），按距离升序写入 idx 与 dist2（距离平方）。
+			// 不足 k 个时只写入找到的部分，返回找到的个数；visited 非空时累加计算过距离的结点数
+			size_t search(const double* q, size_t k, size_t exclude, size_t* idx, double* dist2, size_t* visited = nullptr) const {
+				std::vector<std::pair<double, size_t>> heap;
+				heap.reserve(k + 1);
+				double tau = INFINITY;
+				size_t count = 0;
+				visit(root, q, k, exclude, heap, tau, count);
+				if (visited) *visited += count;
+				std::sort_heap(heap.begin(), heap.end());
+				for (size_t t = 0; t < heap.size(); ++t) {
+					idx[t] = heap[t].second;
+					dist2[t] = heap[t].first * heap[t].first;
+				}
+				return heap.size();
+			}
+
+		private:
+			static constexpr size_t none = static_cast<size_t>(-1);
+
+			struct Node {
+				size_t index;
+				double radius;
+				size_t inside;
+				size_t outside;
+			};
+
+			const DenseMatrix& X;
+			std::vector<size_t> items;
+			std::vector<Node> nodes;
+			uint64_t seed;
+			size_t root = none;
+
+			double distance(const double* a, const double* b) const {
+				double s = 0;
+				for (size_t c = 0; c < X.cols; ++c) s += (a[c] - b[c]) * (a[c] - b[c]);
+				return std::sqrt(s);
+			}
+
+			size_t build(size_t lo, size_t hi) {
+				if (lo >= hi) return none;
+				size_t node = nodes.size();
+				nodes.push_back({ 0, 0.0, none, none });
+				// 随机选取中心，种子由区间决定，建树结果可复现
+				size_t pick = lo + splitmix64(seed ^ splitmix64(lo * 0x9e3779b97f4a7c15ULL + hi)) % (hi - lo);
+				std::swap(items[lo], items[pick]);
+				size_t center = items[lo];
+				nodes[node].index = center;
+				if (hi - lo > 1) {
+					size_t mid = (lo + 1 + hi) / 2;
+					const double* c = X.row(center);
+					std::nth_element(items.begin() + lo + 1, items.begin() + mid, items.begin() + hi, [&](size_t a, size_t b) {
+						return distance(c, X.row(a)) < distance(c, X.row(b));
+					});
+					nodes[node].radius = distance(c, X.row(items[mid]));
+					size_t inside = build(lo + 1, mid);
+					size_t outside = build(mid, hi);
+					nodes[node].inside = inside;
+					nodes[node].outside = outside;
+				}
+				return node;
+			}
+
+			void visit(size_t node, const double* q, size_t k, size_t exclude, std::vector<std::pair<double, size_t>>& heap, double& tau, size_t& count) const {
+				if (node == none) return;
+				const Node& nd = nodes[node];
+				double d = distance(q, X.row(nd.index));
+				++count;
+				if (nd.index != exclude && d < tau) {
+					heap.emplace_back(d, nd.index);
+					std::push_heap(heap.begin(), heap.end());
+					if (heap.size() > k) {
+						std::pop_heap(heap.begin(), heap.end());
+						heap.pop_back();
+					}
+					if (heap.size() == k) tau = heap.front().first;
+				}
+				if (d < nd.radius) {
+					if (d - tau <= nd.radius) visit(nd.inside, q, k, exclude, heap, tau, count);
+					if (d + tau >= nd.radius) visit(nd.outside, q, k, exclude, heap, tau, count);
+				}
+				else {
+					if (d + tau >= nd.radius) visit(nd.outside, q, k, exclude, heap, tau, count);
+					if (d - tau <= nd.radius) visit(nd.inside, q, k, exclude, heap, tau, count);
+				}
+			}
+		};
+
+		// k 近邻（不含自身），idx、dist2 为 n × k 行优先且每行按距离升序。先用 vantage-point 树；
+		// 若抽样查询显示剪枝失效（数据本征维数高，平均要算 vpMaxVisitedFraction 以上的点），改用 gemm 暴力搜索
+		constexpr double vpMaxVisitedFraction = 0.4;
+
+		inline void nearestNeighbors(const DenseMatrix& X, size_t k, std::vector<size_t>& idx, std::vector<double>& dist2) {
+			size_t n = X.rows;
+			VantagePointTree tree(X);
+			idx.assign(n * k, 0);
+			dist2.assign(n * k, 0.0);
+
+			size_t samples = std::min<size_t>(n, 64), step = n / samples, visited = 0;
+			for (size_t s = 0; s < samples; ++s) {
+				size_t i = s * step;
+				tree.search(X.row(i), k, i, &idx[i * k], &dist2[i * k], &visited);
+			}
+			if (visited > vpMaxVisitedFraction * samples * n) {
+				bruteForceNeighbors(X, k, idx, dist2);
+				return;
+			}
+			parallelFor(0, n, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					tree.search(X.row(i), k, i, &idx[i * k], &dist2[i * k]);
+				}
+			}, 64);
+		}
+
+		// 在一行按升序排列的 k 个距离平方上二分 β，使 P(j|i) ∝ exp(−β d_j) 的困惑度等于 perplexity，结果写入 p。
+		// 距离减去最近距离后再取指数（不改变归一化结果），熵用 H = log Σ + β Σ d p / Σ 计算，不会下溢
+		inline void calibrateRow(const double* d2, size_t k, double perplexity, double* p, double tol = 1e-5, int maxIter = 200) {
+			double target = std::log(perplexity);
+			double lo = 0, hi = INFINITY, beta = 1.0, sum = 1.0;
+			for (int iter = 0; iter < maxIter; ++iter) {
+				sum = 0;
+				double dsum = 0;
+				for (size_t t = 0; t < k; ++t) {
+					double d = d2[t] - d2[0];
+					p[t] = std::exp(-beta * d);
+					sum += p[t];
+					dsum += d * p[t];
+				}
+				double H = std::log(sum) + beta * dsum / sum;
+				if (std::fabs(H - target) < tol) break;
+				if (H > target) {
+					lo = beta;
+					beta = hi == INFINITY ? beta * 2 : 0.5 * (beta + hi);
+				}
+				else {
+					hi = beta;
+					beta = 0.5 * (lo + beta);
+				}
+			}
+			for (size_t t = 0; t < k; ++t) p[t] /= sum;
+		}
+
+		// 把每行 k 个近邻上的条件概率对称化为 P = (P_cond + P_condᵀ) / (2n)，结果按列号排序并合并重复项
+		inline SparseMatrix symmetrizeAffinities(size_t n, size_t k, const std::vector<size_t>& idx, const std::vector<double>& cond) {
+			std::vector<size_t> count(n + 1, 0);
+			for (size_t i = 0; i < n; ++i) {
+				count[i] += k;
+				for (size_t t = 0; t < k; ++t) ++count[idx[i * k + t]];
+			}
+			std::vector<size_t> start(n + 1, 0);
+			for (size_t i = 0; i < n; ++i) start[i + 1] = start[i] + count[i];
+			std::vector<std::pair<size_t, double>> entries(start[n]);
+			std::vector<size_t> fill(start.begin(), start.end() - 1);
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t t = 0; t < k; ++t) {
+					size_t j = idx[i * k + t];
+					double v = cond[i * k + t] / (2.0 * n);
+					entries[fill[i]++] = { j, v };
+					entries[fill[j]++] = { i, v };
+				}
+			}
+
+			// 每行排序并合并 (i, j) 与 (j, i) 的重复项
+			std::vector<size_t> unique(n, 0);
+			parallelFor(0, n, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					auto first = entries.begin() + start[i], last = entries.begin() + start[i + 1];
+					std::sort(first, last, [](const std::pair<size_t, double>& a, const std::pair<size_t, double>& b) {
+						return a.first < b.first;
+					});
+					size_t m = 0;
+					for (auto it = first; it != last; ++it) {
+						if (m > 0 && (first + (m - 1))->first == it->first) (first + (m - 1))->second += it->second;
+						else *(first + m++) = *it;
+					}
+					unique[i] = m;
+				}
+			}, 256);
+
+			SparseMatrix P;
+			P.rows = P.cols = n;
+			P.rowPtr.assign(n + 1, 0);
+			for (size_t i = 0; i < n; ++i) P.rowPtr[i + 1] = P.rowPtr[i] + unique[i];
+			P.col.resize(P.rowPtr[n]);
+			P.val.resize(P.rowPtr[n]);
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t t = 0; t < unique[i]; ++t) {
+					P.col[P.rowPtr[i] + t] = entries[start[i] + t].first;
+					P.val[P.rowPtr[i] + t] = entries[start[i] + t].second;
+				}
+			}
+			return P;
+		}
+
+		// Barnes-Hut 空间划分树（D = 1, 2, 3 时分别为二叉树、四叉树、八叉树），只用于 t-SNE 的斥力
+		template <size_t D>
+		class SpaceTree {
+		public:
+			explicit SpaceTree(const DenseMatrix& Y) : Y(Y), order(Y.rows), codes(Y.rows), scratch(Y.rows) {
+				std::iota(order.begin(), order.end(), size_t(0));
+				Node root{};
+				double half = 0;
+				for (size_t d = 0; d < D; ++d) {
+					double lo = INFINITY, hi = -INFINITY;
+					for (size_t i = 0; i < Y.rows; ++i) {
+						lo = std::min(lo, Y(i, d));
+						hi = std::max(hi, Y(i, d));
+					}
+					root.center[d] = 0.5 * (lo + hi);
+					half = std::max(half, 0.5 * (hi - lo));
+				}
+				root.half = half * (1 + 1e-5) + 1e-10;
+				nodes.reserve(2 * Y.rows + 1);
+				nodes.push_back(root);
+				build(0, 0, Y.rows, 0);
+			}
+
+			// 累加点 i 受到的斥力项 Σ w² (y_i − y_j) 到 force，Σ w 到 z，其中 w = 1 / (1 + |y_i − y_j|²)
+			void repulsion(size_t i, double theta2, double* force, double& z) const {
+				visit(0, i, Y.row(i), theta2, force, z);
+			}
+
+		private:
+			static constexpr size_t fanout = size_t(1) << D;
+			// 重合点会一直落进同一个子格，超过该深度后留在叶子里
+			static constexpr int maxDepth = 48;
+
+			struct Node {
+				double center[D];
+				double com[D];
+				double half;
+				size_t count;
+				size_t begin;
+				// 第一个子结点的下标，子结点连续存放；0 表示叶子
+				size_t child;
+			};
+
+			const DenseMatrix& Y;
+			std::vector<size_t> order;
+			std::vector<unsigned> codes;
+			std::vector<size_t> scratch;
+			std::vector<Node> nodes;
+
+			void build(size_t node, size_t begin, size_t end, int depth) {
+				Node nd = nodes[node];
+				nd.count = end - begin;
+				nd.begin = begin;
+				nd.child = 0;
+				for (size_t d = 0; d < D; ++d) nd.com[d] = 0;
+				for (size_t r = begin; r < end; ++r) {
+					const double* y = Y.row(order[r]);
+					for (size_t d = 0; d < D; ++d) nd.com[d] += y[d];
+				}
+				for (size_t d = 0; d < D; ++d) nd.com[d] /= std::max<size_t>(nd.count, 1);
+				nodes[node] = nd;
+				if (nd.count <= 1 || depth >= maxDepth) return;
+
+				// 按象限计数排序
+				size_t bucket[fanout + 1] = {};
+				for (size_t r = begin; r < end; ++r) {
+					const double* y = Y.row(order[r]);
+					unsigned code = 0;
+					for (size_t d = 0; d < D; ++d) {
+						if (y[d] >= nd.center[d]) code |= 1u << d;
+					}
+					codes[r] = code;
+					++bucket[code + 1];
+				}
+				for (size_t c = 0; c < fanout; ++c) bucket[c + 1] += bucket[c];
+				size_t pos[fanout];
+				for (size_t c = 0; c < fanout; ++c) pos[c] = begin + bucket[c];
+				for (size_t r = begin; r < end; ++r) scratch[pos[codes[r]]++] = order[r];
+				std::copy(scratch.begin() + begin, scratch.begin() + end, order.begin() + begin);
+
+				size_t first = nodes.size();
+				nodes[node].child = first;
+				nodes.resize(first + fanout);
+				for (size_t c = 0; c < fanout; ++c) {
+					Node& ch = nodes[first + c];
+					ch.half = 0.5 * nd.half;
+					for (size_t d = 0; d < D; ++d) {
+						ch.center[d] = nd.center[d] + ((c >> d) & 1 ? ch.half : -ch.half);
+					}
+					ch.count = 0;
+					ch.child = 0;
+				}
+				for (size_t c = 0; c < fanout; ++c) {
+					if (bucket[c + 1] > bucket[c]) build(first + c, begin + bucket[c], begin + bucket[c + 1], depth + 1);
+				}
+			}
+
+			void visit(size_t node, size_t i, const double* y, double theta2, double* force, double& z) const {
+				const Node& nd = nodes[node];
+				if (nd.count == 0) return;
+				double diff[D], d2 = 0;
+				for (size_t d = 0; d < D; ++d) {
+					diff[d] = y[d] - nd.com[d];
+					d2 += diff[d] * diff[d];
+				}
+				size_t m = nd.count;
+				if (nd.child == 0) {
+					// 叶子里可能有自身（与其它重合点放在一起）
+					for (size_t r = nd.begin; r < nd.begin + nd.count; ++r) {
+						if (order[r] == i) {
+							--m;
+							break;
+						}
+					}
+					if (m == 0) return;
+				}
+				else if (4 * nd.half * nd.half >= theta2 * d2) {
+					for (size_t c = 0; c < fanout; ++c) visit(nd.child + c, i, y, theta2, force, z);
+					return;
+				}
+				double w = 1.0 / (1.0 + d2);
+				z += m * w;
+				double mult = m * w * w;
+				for (size_t d = 0; d < D; ++d) force[d] += mult * diff[d];
+			}
+		};
+
+		// 斥力：rep 的第 i 行为 Σ_j w_ij² (y_i − y_j)，返回归一化常数 Z = Σ_{i≠j} w_ij
+		template <size_t D>
+		inline double barnesHutRepulsion(const DenseMatrix& Y, double theta, DenseMatrix& rep, std::vector<double>& z) {
+			SpaceTree<D> tree(Y);
+			parallelFor(0, Y.rows, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					double* f = rep.row(i);
+					std::fill(f, f + D, 0.0);
+					z[i] = 0;
+					tree.repulsion(i, theta * theta, f, z[i]);
+				}
+			}, 64);
+			// 按固定顺序求和，结果与线程数无关
+			return std::accumulate(z.begin(), z.end(), 0.0);
+		}
+
+		inline double exactRepulsion(const DenseMatrix& Y, DenseMatrix& rep, std::vector<double>& z) {
+			size_t n = Y.rows, D = Y.cols;
+			parallelFor(0, n, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					double* f = rep.row(i);
+					std::fill(f, f + D, 0.0);
+					z[i] = 0;
+					const double* yi = Y.row(i);
+					for (size_t j = 0; j < n; ++j) {
+						if (j == i) continue;
+						const double* yj = Y.row(j);
+						double d2 = 0;
+						for (size_t d = 0; d < D; ++d) d2 += (yi[d] - yj[d]) * (yi[d] - yj[d]);
+						double w = 1.0 / (1.0 + d2);
+						z[i] += w;
+						for (size_t d = 0; d < D; ++d) f[d] += w * w * (yi[d] - yj[d]);
+					}
+				}
+			}, 16);
+			return std::accumulate(z.begin(), z.end(), 0.0);
+		}
+
+		inline double tsneRepulsion(const DenseMatrix& Y, double theta, DenseMatrix& rep, std::vector<double>& z) {
+			if (theta > 0) {
+				switch (Y.cols) {
+				case 1: return barnesHutRepulsion<1>(Y, theta, rep, z);
+				case 2: return barnesHutRepulsion<2>(Y, theta, rep, z);
+				case 3: return barnesHutRepulsion<3>(Y, theta, rep, z);
+				default: break;
+				}
+			}
+			return exactRepulsion(Y, rep, z);
+		}
+	}
+
+	/**
+	 * @brief 由 k 近邻计算 t-SNE 的稀疏高维相似度矩阵 P。
+	 *
+	 * 每个样本只保留 min(n − 1, ⌊3 × perplexity⌋) 个最近邻（vantage-point 树，高本征维数时退回
+	 * gemm 暴力搜索），各行在这些距离上并行二分求条件概率，再对称化为
+	 * P_ij = (P(j|i) + P(i|j)) / (2n)。不形成任何 n × n 矩阵，内存为 O(n × perplexity)。
+	 *
+	 * @param X 原始数据，每行一个样本。
+	 * @param perplexity 困惑度。
+	 * @return n × n 的 CSR 稀疏矩阵，所有元素之和为 1。
+	 * @throws std::invalid_argument 如果样本少于 2 个或困惑度不为正。
+	 */
+	inline SparseMatrix computeSparseAffinities(const DenseMatrix& X, double perplexity) {
+		size_t n = X.rows;
+		if (n < 2 || !(perplexity > 0)) {
+			throw std::invalid_argument("t-SNE needs at least two samples and a positive perplexity.");
+		}
+		size_t k = std::min(n - 1, std::max<size_t>(1, static_cast<size_t>(3 * perplexity)));
+		std::vector<size_t> idx;
+		std::vector<double> dist2;
+		detail::nearestNeighbors(X, k, idx, dist2);
+
+		std::vector<double> cond(n * k);
+		parallelFor(0, n, [&](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; ++i) {
+				detail::calibrateRow(dist2.data() + i * k, k, perplexity, cond.data() + i * k);
+			}
+		}, 256);
+		return detail::symmetrizeAffinities(n, k, idx, cond);
+	}
+
+	/**
+	 * @brief Barnes-Hut t-SNE。
+	 *
+	 * 吸引力只在稀疏 P 的非零元上计算；斥力在 1 到 3 维时用 Barnes-Hut 树近似，每次迭代
+	 * O(n log n)，更高维或 theta 为 0 时精确计算（O(n²)，但不分配 n × n 矩阵）。优化采用
+	 * 早期夸大、动量和逐坐标自适应增益（gains），每次迭代后把嵌入平移到原点。力的计算按样本
+	 * 多线程进行，求和顺序固定，同一种子的结果与线程数无关。
+	 *
+	 * @param X 原始数据，每行一个样本。
+	 * @param options 目标维度、困惑度、迭代参数与种子。
+	 * @return n × dim 的嵌入坐标。
+	 * @throws std::invalid_argument 如果样本少于 2 个、维度为 0 或困惑度不为正。
+	 */
+	inline DenseMatrix tsne(const DenseMatrix& X, const TSNEOptions& options = TSNEOptions()) {
+		size_t n = X.rows, D = options.dim;
+		if (D == 0) {
+			throw std::invalid_argument("The t-SNE dimension must be positive.");
+		}
+		SparseMatrix P = computeSparseAffinities(X, options.perplexity);
+
+		DenseMatrix Y(n, D);
+		for (size_t i = 0; i < Y.data.size(); ++i) {
+			Y.data[i] = (static_cast<double>(detail::splitmix64(options.seed ^ detail::splitmix64(i)) >> 11) * 0x1.0p-53 - 0.5) * 1e-4;
+		}
+		DenseMatrix update(n, D), gains(n, D, 1.0), rep(n, D);
+		std::vector<double> z(n);
+		double lr = options.learningRate > 0 ? options.learningRate : std::max(n / options.exaggeration, 200.0);
+
+		for (size_t iter = 0; iter < options.maxIter; ++iter) {
+			bool early = iter < options.exaggerationIter;
+			double exaggeration = early ? options.exaggeration : 1.0;
+			double momentum = early ? 0.5 : 0.8;
+			double Z = detail::tsneRepulsion(Y, options.theta, rep, z);
+
+			// 梯度 4 (α Σ_j p_ij w_ij (y_i − y_j) − Σ_j w_ij² (y_i − y_j) / Z)，随后更新增益与坐标
+			parallelFor(0, n, [&](size_t lo, size_t hi) {
+				std::vector<double> attr(D);
+				for (size_t i = lo; i < hi; ++i) {
+					std::fill(attr.begin(), attr.end(), 0.0);
+					const double* yi = Y.row(i);
+					for (size_t e = P.rowPtr[i]; e < P.rowPtr[i + 1]; ++e) {
+						const double* yj = Y.row(P.col[e]);
+						double d2 = 0;
+						for (size_t d = 0; d < D; ++d) d2 += (yi[d] - yj[d]) * (yi[d] - yj[d]);
+						double mult = P.val[e] / (1.0 + d2);
+						for (size_t d = 0; d < D; ++d) attr[d] += mult * (yi[d] - yj[d]);
+					}
+					for (size_t d = 0; d < D; ++d) {
+						double grad = 4.0 * (exaggeration * attr[d] - rep(i, d) / Z);
+						double& g = gains(i, d);
+						double& u = update(i, d);
+						g = (grad > 0) != (u > 0) ? g + 0.2 : g * 0.8;
+						g = std::max(g, 0.01);
+						u = momentum * u - lr * g * grad;
+					}
+				}
+			}, 256);
+
+			std::vector<double> mean(D, 0.0);
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t d = 0; d < D; ++d) {
+					Y(i, d) += update(i, d);
+					mean[d] += Y(i, d);
+				}
+			}
+			for (size_t i = 0; i < n; ++i) {
+				for (size_t d = 0; d < D; ++d) Y(i, d) -= mean[d] / n;
+			}
+		}
+		return Y;
+	}
+
+	/**
+	 * @brief 执行 t-SNE 降维。
+	 *
+	 * 使用稀疏 k 近邻相似度和 Barnes-Hut 斥力（见 tsne），其余参数取 TSNEOptions 的默认值。
+	 *
+	 * @param X 原始高维数据矩阵，大小 n*d。
+	 * @param dim 目标降维维度，默认为 2。
+	 * @param perplexity 困惑度参数。
+	 * @param max_iter 最大迭代次数。
+	 * @param lr 学习率。
+	 * @return 降维后的坐标矩阵，大小 n*dim。
+	 * @throws std::invalid_argument 如果输入数据为空。
+	 */
+	inline std::vector<std::vector<double>> performTSNE(
+		const std::vector<std::vector<double>>& X,
+		int dim = 2,
+		double perplexity = 30.0,
+		int max_iter = 1000,
+		double lr = 200.0
+	) {
+		if (X.empty()) {
+			throw std::invalid_argument("Input data X is empty.");
+		}
+		if (dim < 1 || max_iter < 0) {
+			throw std::invalid_argument("Invalid input to performTSNE");
+		}
+		TSNEOptions options;
+		options.dim = static_cast<size_t>(dim);
+		options.perplexity = perplexity;
+		options.maxIter = static_cast<size_t>(max_iter);
+		options.learningRate = lr;
+		return tsne(DenseMatrix::fromRows(X), options).toRows();
+	}
+
+	/**
+	 * @brief 转置矩阵
+	 *
+	 * @param A 原始矩阵，大小 rows*cols
+	 * @return 转置矩阵，大小 cols*rows
+	 */
+	inline std::vector<std::vector<double>> transposeMatrix(
+		const std::vector<std::vector<double>>& A
+	)
+	{
+		size_t rows = A.size();
+		size_t cols = A[0].size();
+		std::vector<std::vector<double>> At(cols, std::vector<double>(rows));
+		for (size_t i = 0; i < rows; ++i) {
+			for (size_t j = 0; j < cols; ++j) {
+				At[j][i] = A[i][j];
+			}
+		}
+		return At;
+	}
+
+	/**
+	 * @brief 局部线性嵌入（LLE）降维算法
+	 * @param X 输入数据矩阵，大小 n*d。
+	 * @param n_neighbors 每个点的近邻数 k。
+	 * @param dim 目标降维维度。
+	 * @param reg 正则化系数，防止局部协方差矩阵奇异，默认为 1e-3。
+	 * @return 大小 n*dim 的降维嵌入矩阵。
+	 * @throws std::invalid_argument 若输入数据为空或参数不合法。
+	 */
+	inline std::vector<std::vector<double>> performLLE(
+		const std::vector<std::vector<double>>& X,
+		int n_neighbors,
+		int dim,
+		double reg = 1e-3
+	)
+	{
+		if (X.empty() || n_neighbors <= 0 || dim <= 0 || static_cast<size_t>(dim) >= X.size()) {
+			throw std::invalid_argument("Invalid input to performLLE");
+		}
+		size_t n = X.size();
+
+		std::vector<std::vector<double>> dist = computeDistanceMatrix(X);
+
+		// k 个最近邻索引
+		std::vector<std::vector<int>> neighbors(n);
+		for (size_t i = 0; i < n; ++i) {
+			// 按距离排序前 k+1（包含自身）
+			std::vector<std::pair<double, int>> order;
+			order.reserve(n);
+			for (size_t j = 0; j < n; ++j) {
+				order.push_back(std::make_pair(dist[i][j], static_cast<int>(j)));
+			}
+			std::nth_element(order.begin(), order.begin() + n_neighbors,
+				order.end(),
+				std::bind(std::less<std::pair<double, int>>(),
+					std::placeholders::_1,
+					std::placeholders::_2));
+			neighbors[i].reserve(n_neighbors);
+			int count = 0;
+			for (size_t p = 0; p < order.size() && count < n_neighbors; ++p) {
+				int idx = order[p].second;
+				if (idx == static_cast<int>(i)) continue;
+				neighbors[i].push_back(idx);
+				++count;
+			}
+		}
+
+		std::vector<std::vector<double>> W(n, std::vector<double>(n, 0.0));
+		for (size_t i = 0; i < n; ++i) {
+			// 局部协方差矩阵 C (k*k)
+			std::vector<std::vector<double>> C(n_neighbors,
+				std::vector<double>(n_neighbors, 0.0));
+			for (int a = 0; a < n_neighbors; ++a) {
+				for (int b = 0; b < n_neighbors; ++b) {
+					double sum = 0.0;
+					for (size_t d = 0; d < X[i].size(); ++d) {
+						double da = X[i][d] - X[neighbors[i][a]][d];
+						double db = X[i][d] - X[neighbors[i][b]][d];
+						sum += da * db;
+					}
+					C[a][b] = sum;
+				}
+			}
+			// 正则化
+			double trace = 0.0;
+			for (int a = 0; a < n_neighbors; ++a) {
+				trace += C[a][a];
+			}
+			for (int a = 0; a < n_neighbors; ++a) {
+				C[a][a] += reg * trace;
+			}
+			std::vector<double> ones(n_neighbors, 1.0);
+			for (int p = 0; p < n_neighbors; ++p) {
+				int maxr = p;
+				for (int r = p + 1; r < n_neighbors; ++r) {
+					if (std::fabs(C[r][p]) > std::fabs(C[maxr][p])) {
+						maxr = r;
+					}
+				}
+				std::swap(C[p], C[maxr]);
+				std::swap(ones[p], ones[maxr]);
+				double diag = C[p][p];
+				if (std::fabs(diag) < 1e-12) {
+					throw std::runtime_error("Singular matrix in LLE weight solve");
+				}
+				for (int c = p; c < n_neighbors; ++c) {
+					C[p][c] /= diag;
+				}
+				ones[p] /= diag;
+				for (int r = p + 1; r < n_neighbors; ++r) {
+					double factor = C[r][p];
+					for (int c = p; c < n_neighbors; ++c) {
+						C[r][c] -= factor * C[p][c];
+					}
+					ones[r] -= factor * ones[p];
+				}
+			}
+			std::vector<double> w(n_neighbors);
+			for (int irow = n_neighbors - 1; irow >= 0; --irow) {
+				double sum = ones[irow];
+				for (int jcol = irow + 1; jcol < n_neighbors; ++jcol) {
+					sum -= C[irow][jcol] * w[jcol];
+				}
+				w[irow] = sum;
+			}
+			double s = 0.0;
+			for (int a = 0; a < n_neighbors; ++a) {
+				s += w[a];
+			}
+			for (int a = 0; a < n_neighbors; ++a) {
+				W[i][neighbors[i][a]] = w[a] / s;
+			}
+		}
+
+		// 构造 M = (I - W)^T * (I - W)
+		std::vector<std::vector<double>> IminusW(n,
+			std::vector<double>(n, 0.0));
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = 0; j < n; ++j) {
+				IminusW[i][j] = ((i == j) ? 1.0 : 0.0) - W[i][j];
+			}
+		}
+		DenseMatrix M = crossprod(DenseMatrix::fromRows(IminusW));
+
+		// 特征分解 M：只求最小的 dim + 1 个特征对，跳过对应常数向量的最小特征值
+		SymmetricEigen eig = symmetricEigen(std::move(M), EigenRange::Smallest, dim + 1);
+		std::vector<std::vector<double>> Y(n, std::vector<double>(dim, 0.0));
+		for (int d = 0; d < dim; ++d) {
+			for (size_t i = 0; i < n; ++i) {
+				Y[i][d] = eig.vectors(i, d + 1);
+			}
+		}
+
+		return Y;
+	}
+
+	/*
+	 第六次扩展
+	 DESeq2
+	 */
+
+	 /**
+	  * @struct DESeq2Result
+	  * @brief 存储差异表达分析结果：log2FC、pvalue、padj，以及平均表达、log2FC 标准误、Wald 统计量和最终 dispersion
+	  */
+	struct DESeq2Result {
+		double log2FC;
+		double pvalue;
+		double padj;
+		double baseMean = 0;
+		double lfcSE = 0;
+		double stat = 0;
+		double dispersion = 0;
+	};
+
+	/**
+	 * @brief 计算几何平均（只对正计数取对数），按基因并行
+	 * @param counts G×N 原始计数矩阵（任意按行存放、支持 counts[i][j] 的容器）
+	 * @return 长度 G 的几何平均向量
+	 */
+	template <typename Rows>
+	inline std::vector<double> computeGeometricMeans(
+		const Rows& counts
+	) {
+		size_t G = counts.size();
+		size_t N = counts.front().size();
+		std::vector<double> gm(G);
+		parallelFor(0, G, [&](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; ++i) {
+				double sumLog = 0.0;
+				int cnt = 0;
+				for (size_t j = 0; j < N; ++j) {
+					double x = counts[i][j];
+					if (x > 0) {
+						sumLog += std::log(x);
+						++cnt;
+					}
+				}
+				gm[i] = cnt > 0 ? std::exp(sumLog / cnt) : 0.0;
+			}
+		}, 1024);
+		return gm;
+	}
+
+	namespace detail
+	{
+		// size factor 的比值缓冲区每次覆盖的样本数：一行中连续 8 个 double 正好是一条缓存行
+		const size_t sizeFactorChunk = 8;
+
+		// 在 ratios 中填写样本 [j0, j0 + c) 的比值 counts[i][j] / gm[i]（只取 gm > 0 的基因，按 valid 的顺序）
+		template <typename Rows>
+		inline void fillRatios(
+			const Rows& counts,
+			const std::vector<double>& gm,
+			const std::vector<size_t>& valid,
+			size_t j0,
+			size_t c,
+			std::vector<double>& ratios
+		) {
+			size_t V = valid.size();
+			parallelFor(0, V, [&](size_t lo, size_t hi) {
+				for (size_t k = lo; k < hi; ++k) {
+					size_t i = valid[k];
+					for (size_t jj = 0; jj < c; ++jj) {
+						ratios[jj * V + k] = counts[i][j0 + jj] / gm[i];
+					}
+				}
+			}, 1024);
+		}
+
+		// 对缓冲区中的 c 个样本各取上中位数，写入 sf[j0 + jj]；样本之间并行
+		inline void medianRatios(std::vector<double>& ratios, size_t V, size_t j0, size_t c, std::vector<double>& sf)
+		{
+			parallelFor(0, c, [&](size_t lo, size_t hi) {
+				for (size_t jj = lo; jj < hi; ++jj) {
+					auto first = ratios.begin() + jj * V;
+					std::nth_element(first, first + V / 2, first + V);
+					sf[j0 + jj] = first[V / 2];
+				}
+			});
+		}
+	}
+
+	/**
+	 * @brief 计算 size factors（Median-of-Ratios）
+	 *
+	 * 每次只为 8 个样本分配长度为 G 的比值缓冲区，峰值内存为 8×G 而不是 G×N。
+	 * @param counts G×N 原始计数矩阵（任意按行存放、支持 counts[i][j] 的容器）
+	 * @param gm     G 维几何平均向量
+	 * @return N 维 size factor 向量
+	 */
+	template <typename Rows>
+	inline std::vector<double> computeSizeFactors(
+		const Rows& counts,
+		const std::vector<double>& gm
+	) {
+		size_t N = counts.front().size();
+		std::vector<size_t> valid;
+		for (size_t i = 0; i < gm.size(); ++i) {
+			if (gm[i] > 0.0) {
+				valid.push_back(i);
+			}
+		}
+		if (valid.empty()) {
+			throw std::runtime_error("无法计算 size factors");
+		}
+		size_t V = valid.size();
+		std::vector<double> sf(N);
+		std::vector<double> ratios(std::min(N, detail::sizeFactorChunk) * V);
+		for (size_t j0 = 0; j0 < N; j0 += detail::sizeFactorChunk) {
+			size_t c = std::min(detail::sizeFactorChunk, N - j0);
+			detail::fillRatios(counts, gm, valid, j0, c, ratios);
+			detail::medianRatios(ratios, V, j0, c, sf);
+		}
+		return sf;
+	}
+
+	/**
+	 * @brief 融合的 size factor 估计：几何平均与前 8 个样本的比值在同一遍中算出
+	 *
+	 * 结果与 computeGeometricMeans + computeSizeFactors 完全相同，但每行在第一遍中只读一次，
+	 * 样本数不超过 8 时整个过程只遍历矩阵一次；其余样本按 8 个一组再各读一遍对应的列。
+	 * @param counts G×N 原始计数矩阵（任意按行存放、支持 counts[i][j] 的容器）
+	 * @param gm_out 可选输出：G 维几何平均向量
+	 * @return N 维 size factor 向量
+	 */
+	template <typename Rows>
+	inline std::vector<double> estimateSizeFactors(
+		const Rows& counts,
+		std::vector<double>* gm_out = nullptr
+	) {
+		size_t G = counts.size();
+		size_t N = counts.front().size();
+		size_t c0 = std::min(N, detail::sizeFactorChunk);
+		std::vector<double> gm(G);
+		// 第一遍不知道哪些基因有效，先按基因下标写入比值，再压缩掉 gm = 0 的基因
+		std::vector<double> ratios(c0 * G);
+		parallelFor(0, G, [&](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; ++i) {
+				const auto& row = counts[i];
+				double sumLog = 0.0;
+				int cnt = 0;
+				for (size_t j = 0; j < N; ++j) {
+					double x = row[j];
+					if (x > 0) {
+						sumLog += std::log(x);
+						++cnt;
+					}
+				}
+				gm[i] = cnt > 0 ? std::exp(sumLog / cnt) : 0.0;
+				if (gm[i] > 0.0) {
+					for (size_t jj = 0; jj < c0; ++jj) {
+						ratios[jj * G + i] = row[jj] / gm[i];
+					}
+				}
+			}
+		}, 1024);
+
+		std::vector<size_t> valid;
+		for (size_t i = 0; i < G; ++i) {
+			if (gm[i] > 0.0) {
+				valid.push_back(i);
+			}
+		}
+		if (valid.empty()) {
+			throw std::runtime_error("无法计算 size factors");
+		}
+		size_t V = valid.size();
+		for (size_t jj = 0; jj < c0; ++jj) {
+			double* col = ratios.data() + jj * G;
+			double* dst = ratios.data() + jj * V;
+			for (size_t k = 0; k < V; ++k) {
+				dst[k] = col[valid[k]];
+			}
+		}
+
+		std::vector<double> sf(N);
+		detail::medianRatios(ratios, V, 0, c0, sf);
+		for (size_t j0 = c0; j0 < N; j0 += detail::sizeFactorChunk) {
+			size_t c = std::min(detail::sizeFactorChunk, N - j0);
+			detail::fillRatios(counts, gm, valid, j0, c, ratios);
+			detail::medianRatios(ratios, V, j0, c, sf);
+		}
+		if (gm_out) {
+			*gm_out = std::move(gm);
+		}
+		return sf;
+	}
+
+	/**
+	 * @brief 归一化 counts
+	 * @param counts G×N 原始计数矩阵
+	 * @param sf     N 维 size factor 向量
+	 * @return G×N 归一化矩阵
+	 */
+	inline std::vector<std::vector<double>> normalizeCounts(
+		const std::vector<std::vector<double>>& counts,
+		const std::vector<double>& sf
+	) {
+		size_t G = counts.size();
+		size_t N = sf.size();
+		std::vector<std::vector<double>> nc = counts;
+		for (size_t i = 0; i < G; ++i) {
+			for (size_t j = 0; j < N; ++j) {
+				nc[i][j] = counts[i][j] / sf[j];
+			}
+		}
+		return nc;
+	}
+
+	/**
+	 * @brief 原始 dispersion 方法矩估计
+	 * @param normCounts G×N 归一化后矩阵
+	 * @param muBar_out  输出：G 维平均表达向量
+	 * @return G 维 raw dispersion 向量
+	 */
+	inline std::vector<double> estimateRawDispersions(
+		const std::vector<std::vector<double>>& normCounts,
+		std::vector<double>& muBar_out
+	) {
+		size_t G = normCounts.size();
+		size_t N = normCounts.front().size();
+		std::vector<double> raw(G);
+		muBar_out.assign(G, 0.0);
+		for (size_t i = 0; i < G; ++i) {
+			double sum = std::accumulate(normCounts[i].begin(), normCounts[i].end(), 0.0);
+			double mu = sum / N;
+			muBar_out[i] = mu;
+			double var = 0.0;
+			for (size_t j = 0; j < N; ++j) {
+				double diff = normCounts[i][j] - mu;
+				var += diff * diff;
+			}
+			var /= (N > 1 ? N - 1 : 1);
+			raw[i] = std::max((var - mu) / (mu * mu), 0.0);
+		}
+		return raw;
+	}
+
+	/**
+	 * @struct DispersionTrend
+	 * @brief 参数化的 dispersion-均值趋势：α(μ) = asymptDisp + extraPois / μ
+	 */
+	struct DispersionTrend {
+		double asymptDisp;
+		double extraPois;
+
+		double operator()(double mu) const {
+			return asymptDisp + extraPois / mu;
+		}
+	};
+
+	/**
+	 * @brief 拟合参数化 dispersion 趋势（对应 DESeq2 的 fitType = "parametric"）
+	 *
+	 * 用 gamma 族、恒等连接的 GLM 拟合 disp ~ a0 + a1 / μ，每轮剔除 disp / 拟合值
+	 * 不在 (1e-4, 15) 之内的基因后重新拟合，直到系数收敛。
+	 * @param disp 每个基因的 dispersion 估计
+	 * @param mu   每个基因的平均归一化表达
+	 * @return 拟合得到的趋势
+	 * @throws std::runtime_error 可用基因太少或系数不为正时
+	 */
+	inline DispersionTrend fitDispersionTrend(
+		const std::vector<double>& disp,
+		const std::vector<double>& mu
+	) {
+		if (disp.size() != mu.size()) {
+			throw std::invalid_argument("fitDispersionTrend: disp 与 mu 长度不一致");
+		}
+		const double minDisp = 1e-8;
+		std::vector<size_t> use;
+		for (size_t i = 0; i < disp.size(); ++i) {
+			if (disp[i] >= minDisp * 10 && mu[i] > 0 && std::isfinite(disp[i])) {
+				use.push_back(i);
+			}
+		}
+
+		double a0 = 0.1, a1 = 1.0;
+		std::vector<size_t> good;
+		for (int outer = 0; outer < 10; ++outer) {
+			good.clear();
+			for (size_t i : use) {
+				double r = disp[i] / (a0 + a1 / mu[i]);
+				if (r > 1e-4 && r < 15) {
+					good.push_back(i);
+				}
+			}
+			if (good.size() < 3) {
+				throw std::runtime_error("fitDispersionTrend: 可用于拟合的基因太少");
+			}
+
+			// gamma GLM（恒等连接）的 IRLS：权重为 1 / 拟合值^2
+			double b0 = a0, b1 = a1;
+			for (int iter = 0; iter < 25; ++iter) {
+				double sw = 0, swx = 0, swxx = 0, swy = 0, swxy = 0;
+				for (size_t i : good) {
+					double x = 1.0 / mu[i];
+					double f = b0 + b1 * x;
+					if (f <= 0) {
+						f = minDisp;
+					}
+					double w = 1.0 / (f * f);
+					sw += w;
+					swx += w * x;
+					swxx += w * x * x;
+					swy += w * disp[i];
+					swxy += w * x * disp[i];
+				}
+				double det = sw * swxx - swx * swx;
+				if (det == 0) {
+					throw std::runtime_error("fitDispersionTrend: 拟合矩阵奇异");
+				}
+				double n0 = (swxx * swy - swx * swxy) / det;
+				double n1 = (sw * swxy - swx * swy) / det;
+				bool done = std::abs(n0 - b0) <= 1e-10 * std::abs(b0) + 1e-14
+					&& std::abs(n1 - b1) <= 1e-10 * std::abs(b1) + 1e-14;
+				b0 = n0;
+				b1 = n1;
+				if (done) {
+					break;
+				}
+			}
+			if (!(b0 > 0 && b1 > 0)) {
+				throw std::runtime_error("fitDispersionTrend: 参数化拟合失败（系数不为正）");
+			}
+			double change = std::pow(std::log(b0 / a0), 2) + std::pow(std::log(b1 / a1), 2);
+			a0 = b0;
+			a1 = b1;
+			if (change < 1e-6) {
+				break;
+			}
+		}
+		return DispersionTrend{ a0, a1 };
+	}
+
+	/**
+	 * @brief 参数化趋势下的方差稳定变换（DESeq2 varianceStabilizingTransformation 的闭式解）
+	 * @param q     归一化计数
+	 * @param trend dispersion 趋势
+	 * @return log2 尺度上的变换值
+	 */
+	inline double vstTransform(double q, const DispersionTrend& trend) {
+		double a0 = trend.asymptDisp;
+		double a1 = trend.extraPois;
+		return std::log((1 + a1 + 2 * a0 * q + 2 * std::sqrt(a0 * q * (1 + a1 + a0 * q))) / (4 * a0)) / std::log(2.0);
+	}
+
+	/**
+	 * @struct NBWorkspace
+	 * @brief 负二项 GLM 拟合的单线程工作区，按基因块复用，避免逐基因分配内存
+	 */
+	struct NBWorkspace {
+		std::vector<double> mu;    // 拟合均值（n）
+		std::vector<double> w;     // IRLS 权重（n）
+		std::vector<double> z;     // 工作响应（n）
+		std::vector<double> xtwx;  // XᵀWX 及其 Cholesky 因子（p×p）
+		std::vector<double> xtwz;  // XᵀWz（p）
+		std::vector<double> inv;   // (XᵀWX)^{-1}（p×p）
+		std::vector<double> beta;  // 系数（p）
+		std::vector<double> tmp;   // 临时向量（n）
+
+		NBWorkspace(size_t n, size_t p)
+			: mu(n), w(n), z(n), xtwx(p * p), xtwz(p), inv(p * p), beta(p), tmp(n) {}
+	};
+
+	namespace detail
+	{
+		// 由 Cholesky 因子 L（p×p，下三角）解 L Lᵀ x = b，结果覆盖 b
+		inline void choleskySolve(const double* L, size_t p, double* b)
+		{
+			for (size_t i = 0; i < p; ++i) {
+				double s = b[i];
+				for (size_t k = 0; k < i; ++k) {
+					s -= L[i * p + k] * b[k];
+				}
+				b[i] = s / L[i * p + i];
+			}
+			for (size_t i = p; i-- > 0;) {
+				double s = b[i];
+				for (size_t k = i + 1; k < p; ++k) {
+					s -= L[k * p + i] * b[k];
+				}
+				b[i] = s / L[i * p + i];
+			}
+		}
+
+		// 累加 XᵀWX（写入 ws.xtwx），可附加岭项
+		inline void accumulateXtWX(const std::vector<double>& X, size_t n, size_t p, const double* w, double ridge, std::vector<double>& xtwx)
+		{
+			std::fill(xtwx.begin(), xtwx.end(), 0.0);
+			for (size_t j = 0; j < n; ++j) {
+				const double* x = X.data() + j * p;
+				for (size_t a = 0; a < p; ++a) {
+					double wa = w[j] * x[a];
+					for (size_t b = 0; b <= a; ++b) {
+						xtwx[a * p + b] += wa * x[b];
+					}
+				}
+			}
+			for (size_t a = 0; a < p; ++a) {
+				xtwx[a * p + a] += ridge;
+				for (size_t b = 0; b < a; ++b) {
+					xtwx[b * p + a] = xtwx[a * p + b];
+				}
+			}
+		}
+
+		// 在对数尺度区间 [lo, hi] 上最大化一元函数：先粗网格定位，再在相邻格点间黄金分割
+		template <typename F>
+		inline double maximizeScalar(F&& f, double lo, double hi, int grid = 16, double tol = 1e-4)
+		{
+			double step = (hi - lo) / (grid - 1);
+			int best = 0;
+			double bestVal = -std::numeric_limits<double>::infinity();
+			for (int k = 0; k < grid; ++k) {
+				double v = f(lo + k * step);
+				if (v > bestVal) {
+					bestVal = v;
+					best = k;
+				}
+			}
+			double a = lo + std::max(best - 1, 0) * step;
+			double b = lo + std::min(best + 1, grid - 1) * step;
+			const double g = 0.5 * (std::sqrt(5.0) - 1);
+			double c = b - g * (b - a), d = a + g * (b - a);
+			double fc = f(c), fd = f(d);
+			while (b - a > tol) {
+				if (fc > fd) {
+					b = d;
+					d = c;
+					fd = fc;
+					c = b - g * (b - a);
+					fc = f(c);
+				}
+				else {
+					a = c;
+					c = d;
+					fc = fd;
+					d = a + g * (b - a);
+					fd = f(d);
+				}
+			}
+			double x = fc > fd ? c : d;
+			return std::max(fc, fd) >= bestVal ? x : lo + best * step;
+		}
+	}
+
+	/**
+	 * @brief 负二项 GLM（log 连接）的 IRLS 拟合，对应 DESeq2 的 fitBeta
+	 *
+	 * μ_j = sf_j · exp(x_jᵀβ)，权重 w_j = μ_j / (1 + αμ_j)，工作响应 z_j = log(μ_j / sf_j) + (y_j − μ_j) / μ_j。
+	 * 与 DESeq2 相同：μ 下限为 0.5，带 1e-6 的岭项，偏差相对变化小于 1e-8 时收敛，|β| > 30 时放弃。
+	 * @param y     某基因的原始计数（长度 n）
+	 * @param sf    n 维 size factor
+	 * @param X     设计矩阵（n×p，按行存放）
+	 * @param p     系数个数
+	 * @param alpha dispersion
+	 * @param ws    工作区；返回时 ws.mu 为拟合均值，ws.inv 为 (XᵀWX)^{-1}
+	 * @param beta  输入初值，输出自然对数尺度的系数
+	 * @param maxit 最大迭代次数
+	 * @return 是否收敛
+	 */
+	inline bool nbFitBeta(
+		const double* y,
+		const std::vector<double>& sf,
+		const std::vector<double>& X,
+		size_t p,
+		double alpha,
+		NBWorkspace& ws,
+		double* beta,
+		int maxit = 100
+	) {
+		const double minmu = 0.5, ridge = 1e-6;
+		size_t n = sf.size();
+		double r = 1.0 / alpha;
+		auto updateMu = [&]() {
+			for (size_t j = 0; j < n; ++j) {
+				const double* x = X.data() + j * p;
+				double eta = 0;
+				for (size_t k = 0; k < p; ++k) {
+					eta += x[k] * beta[k];
+				}
+				ws.mu[j] = std::max(sf[j] * std::exp(eta), minmu);
+			}
+		};
+		// 偏差（省略与 β 无关的常数项）
+		auto deviance = [&]() {
+			double dev = 0;
+			for (size_t j = 0; j < n; ++j) {
+				dev += y[j] * std::log(ws.mu[j] / (ws.mu[j] + r)) - r * std::log1p(alpha * ws.mu[j]);
+			}
+			return -2 * dev;
+		};
+
+		updateMu();
+		double devOld = deviance();
+		bool converged = false;
+		for (int iter = 0; iter < maxit; ++iter) {
+			for (size_t j = 0; j < n; ++j) {
+				ws.w[j] = ws.mu[j] / (1 + alpha * ws.mu[j]);
+				ws.z[j] = std::log(ws.mu[j] / sf[j]) + (y[j] - ws.mu[j]) / ws.mu[j];
+			}
+			detail::accumulateXtWX(X, n, p, ws.w.data(), ridge, ws.xtwx);
+			std::fill(ws.xtwz.begin(), ws.xtwz.end(), 0.0);
+			for (size_t j = 0; j < n; ++j) {
+				const double* x = X.data() + j * p;
+				for (size_t k = 0; k < p; ++k) {
+					ws.xtwz[k] += ws.w[j] * ws.z[j] * x[k];
+				}
+			}
+			if (!detail::choleskyFactor(ws.xtwx.data(), p)) {
+				break;
+			}
+			detail::choleskySolve(ws.xtwx.data(), p, ws.xtwz.data());
+			bool large = false;
+			for (size_t k = 0; k < p; ++k) {
+				beta[k] = ws.xtwz[k];
+				large = large || std::abs(beta[k]) > 30;
+			}
+			updateMu();
+			if (large) {
+				break;
+			}
+			double dev = deviance();
+			if (std::abs(dev - devOld) / (std::abs(dev) + 0.1) < 1e-8) {
+				converged = true;
+				break;
+			}
+			devOld = dev;
+		}
+
+		// 协方差（用最终 μ 的权重）
+		for (size_t j = 0; j < n; ++j) {
+			ws.w[j] = ws.mu[j] / (1 + alpha * ws.mu[j]);
+		}
+		detail::accumulateXtWX(X, n, p, ws.w.data(), ridge, ws.xtwx);
+		if (detail::choleskyFactor(ws.xtwx.data(), p)) {
+			detail::choleskyInverse(ws.xtwx.data(), p, ws.inv.data());
+		}
+		else {
+			std::fill(ws.inv.begin(), ws.inv.end(), std::numeric_limits<double>::quiet_NaN());
+		}
+		return converged;
+	}
+
+	/**
+	 * @brief dispersion 的（Cox-Reid 校正）对数似然，可附加以趋势为中心的对数正态先验
+	 *
+	 * 对应 DESeq2 的 log_posterior：
+	 * Σ[lgamma(y + 1/α) − lgamma(1/α) − y·log(μ + 1/α) − (1/α)·log(1 + μα)] − ½·log det(XᵀWX)，
+	 * 其中 W = diag(1 / (1/μ + α))；priorVar > 0 时再加 −(log α − priorMean)² / (2·priorVar)。
+	 * @param y         原始计数（长度 n）
+	 * @param mu        拟合均值（长度 n，μ 固定）
+	 * @param X         设计矩阵（n×p，按行存放）
+	 * @param p         系数个数
+	 * @param logAlpha  log dispersion
+	 * @param priorMean 先验均值（log 尺度）
+	 * @param priorVar  先验方差；为 0 时不加先验
+	 * @param ws        工作区（使用 w 与 xtwx）
+	 * @return 目标函数值
+	 */
+	inline double nbDispersionObjective(
+		const double* y,
+		const double* mu,
+		const std::vector<double>& X,
+		size_t p,
+		double logAlpha,
+		double priorMean,
+		double priorVar,
+		NBWorkspace& ws
+	) {
+		size_t n = ws.mu.size();
+		double alpha = std::exp(logAlpha);
+		double r = 1.0 / alpha;
+		double ll = 0;
+		for (size_t j = 0; j < n; ++j) {
+			ll += detail::lgammaRatio(y[j], r) - y[j] * std::log(mu[j] + r) - r * std::log1p(mu[j] * alpha);
+			ws.w[j] = 1.0 / (1.0 / mu[j] + alpha);
+		}
+		detail::accumulateXtWX(X, n, p, ws.w.data(), 0.0, ws.xtwx);
+		double logDet = 0;
+		if (detail::choleskyFactor(ws.xtwx.data(), p)) {
+			for (size_t k = 0; k < p; ++k) {
+				logDet += 2 * std::log(ws.xtwx[k * p + k]);
+			}
+		}
+		double obj = ll - 0.5 * logDet;
+		if (priorVar > 0) {
+			obj -= (logAlpha - priorMean) * (logAlpha - priorMean) / (2 * priorVar);
+		}
+		return obj;
+	}
+
+	/**
+	 * @brief 先验方差：对数 gene-wise 估计相对趋势的残差的 MAD² 减去抽样方差 trigamma((m − p) / 2)，下限 0.25
+	 * @param dispGene gene-wise dispersion
+	 * @param dispFit  趋势值
+	 * @param m        样本数
+	 * @param p        系数个数
+	 * @param varLogDispEsts 输出：残差的 MAD²（用于识别 dispersion 离群基因）
+	 * @return 先验方差
+	 */
+	inline double estimateDispersionPriorVar(
+		const std::vector<double>& dispGene,
+		const std::vector<double>& dispFit,
+		size_t m,
+		size_t p,
+		double& varLogDispEsts
+	) {
+		const double minDisp = 1e-8;
+		std::vector<double> res;
+		for (size_t i = 0; i < dispGene.size(); ++i) {
+			if (dispGene[i] >= minDisp * 100 && std::isfinite(dispGene[i]) && dispFit[i] > 0) {
+				res.push_back(std::log(dispGene[i]) - std::log(dispFit[i]));
+			}
+		}
+		if (res.empty()) {
+			varLogDispEsts = 0;
+			return 0.25;
+		}
+		double med = median(res);
+		for (double& v : res) {
+			v = std::abs(v - med);
+		}
+		double mad = 1.4826 * median(res);
+		varLogDispEsts = mad * mad;
+		double expVar = boost::math::trigamma((m - p) / 2.0);
+		return std::max(varLogDispEsts - expVar, 0.25);
+	}
+
+	/**
+	 * @brief gene-wise dispersion 的 Cox-Reid 校正极大似然估计（对应 DESeq2 estimateDispersionsGeneEst）
+	 *
+	 * 每个基因先用矩估计与 rough 估计中较小者作初值拟合 NB GLM 得到 μ，再在 μ 固定时于
+	 * [minDisp / 10, maxDisp] 的对数尺度上最大化 Cox-Reid 校正似然。基因按块并行，
+	 * 每个线程只分配一份工作区。全零基因的 dispersion 记为 NaN。
+	 * @param counts G×N 原始计数矩阵
+	 * @param sf     N 维 size factor
+	 * @param X      设计矩阵（N×p，按行存放）
+	 * @param p      系数个数
+	 * @param baseMean_out 输出：G 维平均归一化表达
+	 * @param beta_out     输出：G×p 系数（自然对数尺度，供后续步骤作初值）
+	 * @return G 维 gene-wise dispersion
+	 */
+	template <typename Rows>
+	inline std::vector<double> estimateGeneDispersions(
+		const Rows& counts,
+		const std::vector<double>& sf,
+		const std::vector<double>& X,
+		size_t p,
+		std::vector<double>& baseMean_out,
+		std::vector<double>& beta_out
+	) {
+		size_t G = counts.size();
+		size_t N = sf.size();
+		const double minDisp = 1e-8;
+		const double maxDisp = std::max(10.0, static_cast<double>(N));
+		std::vector<std::vector<double>> design(N, std::vector<double>(p));
+		for (size_t j = 0; j < N; ++j) {
+			for (size_t k = 0; k < p; ++k) {
+				design[j][k] = X[j * p + k];
+			}
+		}
+		LinearModel lm(design);
+		double xim = 0;
+		for (double s : sf) {
+			xim += 1.0 / s;
+		}
+		xim /= N;
+
+		std::vector<double> disp(G, std::numeric_limits<double>::quiet_NaN());
+		baseMean_out.assign(G, 0.0);
+		beta_out.assign(G * p, 0.0);
+		parallelFor(0, G, [&](size_t lo, size_t hi) {
+			NBWorkspace ws(N, p);
+			std::vector<double> y(N), yn(N), fitted(p);
+			for (size_t i = lo; i < hi; ++i) {
+				double mean = 0;
+				for (size_t j = 0; j < N; ++j) {
+					y[j] = counts[i][j];
+					yn[j] = y[j] / sf[j];
+					mean += yn[j];
+				}
+				mean /= N;
+				baseMean_out[i] = mean;
+				if (mean == 0) {
+					continue;
+				}
+
+				// 矩估计
+				double var = 0;
+				for (size_t j = 0; j < N; ++j) {
+					var += (yn[j] - mean) * (yn[j] - mean);
+				}
+				var /= N - 1;
+				double moments = (var - xim * mean) / (mean * mean);
+				// rough 估计：线性模型拟合归一化计数，μ 下限为 1
+				lm.solve(yn.data(), fitted.data());
+				double rough = 0;
+				for (size_t j = 0; j < N; ++j) {
+					const double* x = X.data() + j * p;
+					double m = 0;
+					for (size_t k = 0; k < p; ++k) {
+						m += x[k] * fitted[k];
+					}
+					m = std::max(m, 1.0);
+					rough += ((yn[j] - m) * (yn[j] - m) - m) / (m * m);
+				}
+				rough = std::max(rough / (N - p), 0.0);
+				double alphaInit = std::min(std::max(std::min(rough, moments), minDisp), maxDisp);
+
+				// β 初值：log(归一化计数 + 0.1) 的最小二乘解
+				double* beta = beta_out.data() + i * p;
+				for (size_t j = 0; j < N; ++j) {
+					ws.tmp[j] = std::log(yn[j] + 0.1);
+				}
+				lm.solve(ws.tmp.data(), beta);
+				nbFitBeta(y.data(), sf, X, p, alphaInit, ws, beta);
+
+				std::copy(ws.mu.begin(), ws.mu.end(), ws.tmp.begin());
+				double logAlpha = detail::maximizeScalar([&](double a) {
+					return nbDispersionObjective(y.data(), ws.tmp.data(), X, p, a, 0.0, 0.0, ws);
+					}, std::log(minDisp / 10), std::log(maxDisp));
+				disp[i] = std::min(std::max(std::exp(logAlpha), minDisp), maxDisp);
+			}
+		}, 64);
+		return disp;
+	}
+
+	/**
+	 * @brief dispersion 的 MAP 收缩（对应 DESeq2 estimateDispersionsMAP）
+	 *
+	 * 以趋势值为中心、方差为 priorVar 的对数正态先验，最大化 Cox-Reid 校正后验。
+	 * gene-wise 估计高出趋势 2 倍残差标准差以上的基因视为 dispersion 离群，保留 gene-wise 估计。
+	 * @param counts   G×N 原始计数矩阵
+	 * @param sf       N 维 size factor
+	 * @param X        设计矩阵（N×p，按行存放）
+	 * @param p        系数个数
+	 * @param beta     G×p 系数（由 estimateGeneDispersions 给出，用于恢复 μ）
+	 * @param dispGene gene-wise dispersion
+	 * @param dispFit  趋势值
+	 * @param priorVar 先验方差
+	 * @param varLogDispEsts 残差的 MAD²
+	 * @return G 维最终 dispersion
+	 */
+	template <typename Rows>
+	inline std::vector<double> shrinkDispersions(
+		const Rows& counts,
+		const std::vector<double>& sf,
+		const std::vector<double>& X,
+		size_t p,
+		const std::vector<double>& beta,
+		const std::vector<double>& dispGene,
+		const std::vector<double>& dispFit,
+		double priorVar,
+		double varLogDispEsts
+	) {
+		size_t G = counts.size();
+		size_t N = sf.size();
+		const double minDisp = 1e-8;
+		const double maxDisp = std::max(10.0, static_cast<double>(N));
+		double outlierSD = std::sqrt(varLogDispEsts);
+
+		std::vector<double> disp(G, std::numeric_limits<double>::quiet_NaN());
+		parallelFor(0, G, [&](size_t lo, size_t hi) {
+			NBWorkspace ws(N, p);
+			std::vector<double> y(N);
+			for (size_t i = lo; i < hi; ++i) {
+				if (std::isnan(dispGene[i])) {
+					continue;
+				}
+				const double* b = beta.data() + i * p;
+				for (size_t j = 0; j < N; ++j) {
+					y[j] = counts[i][j];
+					const double* x = X.data() + j * p;
+					double eta = 0;
+					for (size_t k = 0; k < p; ++k) {
+						eta += x[k] * b[k];
+					}
+					ws.tmp[j] = std::max(sf[j] * std::exp(eta), 0.5);
+				}
+				double prior = std::log(dispFit[i]);
+				double logAlpha = detail::maximizeScalar([&](double a) {
+					return nbDispersionObjective(y.data(), ws.tmp.data(), X, p, a, prior, priorVar, ws);
+					}, std::log(minDisp / 10), std::log(maxDisp));
+				double d = std::exp(logAlpha);
+				if (std::log(dispGene[i]) > prior + 2 * outlierSD) {
+					d = dispGene[i];
+				}
+				disp[i] = std::min(std::max(d, minDisp), maxDisp);
+			}
+		}, 64);
+		return disp;
+	}
+
+	/**
+	 * @brief 用最终 dispersion 重新拟合 NB GLM，对系数 coef 做 Wald 检验（对应 DESeq2 nbinomWaldTest）
+	 * @param counts G×N 原始计数矩阵
+	 * @param sf     N 维 size factor
+	 * @param X      设计矩阵（N×p，按行存放）
+	 * @param p      系数个数
+	 * @param coef   被检验的系数下标
+	 * @param beta   G×p 系数初值，返回时为最终系数
+	 * @param disp   最终 dispersion
+	 * @param res    输出：填写 log2FC、lfcSE、stat、pvalue
+	 */
+	template <typename Rows>
+	inline void nbWaldTest(
+		const Rows& counts,
+		const std::vector<double>& sf,
+		const std::vector<double>& X,
+		size_t p,
+		size_t coef,
+		std::vector<double>& beta,
+		const std::vector<double>& disp,
+		std::vector<DESeq2Result>& res
+	) {
+		size_t G = counts.size();
+		size_t N = sf.size();
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		parallelFor(0, G, [&](size_t lo, size_t hi) {
+			NBWorkspace ws(N, p);
+			std::vector<double> y(N);
+			for (size_t i = lo; i < hi; ++i) {
+				if (std::isnan(disp[i])) {
+					res[i].log2FC = res[i].lfcSE = res[i].stat = res[i].pvalue = nan;
+					continue;
+				}
+				for (size_t j = 0; j < N; ++j) {
+					y[j] = counts[i][j];
+				}
+				double* b = beta.data() + i * p;
+				nbFitBeta(y.data(), sf, X, p, disp[i], ws, b);
+				double se = std::sqrt(ws.inv[coef * p + coef]);
+				double stat = b[coef] / se;
+				res[i].log2FC = b[coef] / std::log(2.0);
+				res[i].lfcSE = se / std::log(2.0);
+				res[i].stat = stat;
+				res[i].pvalue = normalPValue(stat);
+			}
+		}, 64);
+	}
+
+	/**
+	 * @brief Benjamini-Hochberg FDR 校正
+	 * @param res 输入/输出结果向量，函数会填充 res[i].padj；pvalue 为 NaN 的基因不参与校正，padj 也为 NaN
+	 */
+	inline void adjustPValues(std::vector<DESeq2Result>& res) {
+		// 通过成员访问器直接读 pvalue、写 padj，不复制
+		struct Field {
+			std::vector<DESeq2Result>& r;
+			double DESeq2Result::* field;
+			size_t size() const { return r.size(); }
+			double& operator[](size_t i) const { return r[i].*field; }
+		};
+		pAdjust(Field{ res, &DESeq2Result::pvalue }, Field{ res, &DESeq2Result::padj }, PAdjustMethod::BH);
+	}
+
+	/**
+	 * @brief DESeq2 主接口：size factor → gene-wise dispersion → 趋势 → MAP 收缩 → NB GLM Wald 检验
+	 *
+	 * 设计矩阵由 designMatrix(groups) 给出，groups 可以有多个水平；检验的是最大水平相对最小水平
+	 * （基线）的系数，与 DESeq2 默认 results() 一致。未实现 Cook's distance 离群值替换与独立过滤。
+	 * 计数矩阵直接按行读取，不做任何 G×N 的拷贝：size factor 用 estimateSizeFactors 分块估计，
+	 * 平均归一化表达与矩估计在 estimateGeneDispersions 中随每个基因一起算出。
+	 * @param counts G×N 原始计数矩阵（任意按行存放、支持 counts[i][j] 的容器）
+	 * @param groups 长度 N 样本分组
+	 * @return 长度 G 的差异表达结果向量
+	 */
+	template <typename Rows>
+	inline std::vector<DESeq2Result> performDESeq2(
+		const Rows& counts,
+		const std::vector<int>& groups
+	) {
+		if (counts.empty()) {
+			throw std::invalid_argument("counts 为空");
+		}
+		size_t G = counts.size();
+		size_t N = counts.front().size();
+		if (groups.size() != N) {
+			throw std::invalid_argument("groups 长度不匹配");
+		}
+
+		std::vector<std::vector<double>> design = designMatrix(groups);
+		size_t p = design.front().size();
+		if (p < 2) {
+			throw std::invalid_argument("groups 至少需要两个水平");
+		}
+		std::vector<double> X(N * p);
+		for (size_t j = 0; j < N; ++j) {
+			std::copy(design[j].begin(), design[j].end(), X.begin() + j * p);
+		}
+
+		std::vector<double> sf = estimateSizeFactors(counts);
+
+		std::vector<double> baseMean, beta;
+		std::vector<double> dispGene = estimateGeneDispersions(counts, sf, X, p, baseMean, beta);
+
+		// 参数化趋势；可用基因太少时退化为均值（DESeq2 fitType = "mean"）
+		DispersionTrend trend;
+		try {
+			trend = fitDispersionTrend(dispGene, baseMean);
+		}
+		catch (const std::runtime_error&) {
+			double sum = 0;
+			size_t cnt = 0;
+			for (double d : dispGene) {
+				if (d >= 1e-7 && std::isfinite(d)) {
+					sum += d;
+					++cnt;
+				}
+			}
+			if (cnt == 0) {
+				throw std::runtime_error("performDESeq2: 没有可用于估计 dispersion 的基因");
+			}
+			trend = DispersionTrend{ sum / cnt, 0.0 };
+		}
+		std::vector<double> dispFit(G);
+		for (size_t i = 0; i < G; ++i) {
+			dispFit[i] = baseMean[i] > 0 ? trend(baseMean[i]) : std::numeric_limits<double>::quiet_NaN();
+		}
+
+		double varLogDispEsts = 0;
+		double priorVar = estimateDispersionPriorVar(dispGene, dispFit, N, p, varLogDispEsts);
+		std::vector<double> disp = shrinkDispersions(counts, sf, X, p, beta, dispGene, dispFit, priorVar, varLogDispEsts);
+
+		std::vector<DESeq2Result> results(G);
+		nbWaldTest(counts, sf, X, p, p - 1, beta, disp, results);
+		for (size_t i = 0; i < G; ++i) {
+			results[i].baseMean = baseMean[i];
+			results[i].dispersion = disp[i];
+		}
+		adjustPValues(results);
+		return results;
+	}
+
+	/*
+	 第七次扩展
+	 降维DBSCAN kMeansPP
+	 */
+	 /**
+	  * @brief 找到样本 idx 在数据集中的 eps-邻域
+	  * @param data 数据集 n×m 矩阵
+	  * @param idx  样本索引
+	  * @param eps  邻域半径
+	  * @return 距离 <= eps 的所有样本索引列表
+	  */
+	inline std::vector<size_t> regionQuery(
+		const std::vector<std::vector<double>>& data,
+		size_t idx,
+		double eps
+	) {
+		std::vector<size_t> neighbors;
+		for (size_t j = 0; j < data.size(); ++j) {
+			if (euclideanDistance(data[idx], data[j]) <= eps) {
+				neighbors.push_back(j);
+			}
+		}
+		return neighbors;
+	}
+
+	/**
+	 * @brief 扩展簇：将所有密度可达的点加入同一簇
+	 * @param data      数据集 n×m
+	 * @param labels    样本簇标签向量，-1 表示未分类或噪声
+	 * @param visited   样本访问标记向量
+	 * @param idx       当前样本索引
+	 * @param clusterId 当前簇 ID
+	 * @param eps       邻域半径
+	 * @param minPts    构成核心点的最小邻居数
+	 */
+	inline void expandCluster(
+		const std::vector<std::vector<double>>& data,
+		std::vector<int>& labels, std::vector<bool>& visited,
+		size_t idx,
+		int clusterId,
+		double eps,
+		int minPts
+	) {
+		// 获取邻域
+		std::vector<size_t> seedSet = regionQuery(data, idx, eps);
+		labels[idx] = clusterId;
+
+		for (size_t k = 0; k < seedSet.size(); ++k) {
+			size_t cur = seedSet[k];
+			if (!visited[cur]) {
+				visited[cur] = true;
+				// 如果是核心点，则将其邻域加入 seedSet
+				std::vector<size_t> curNeighbors = regionQuery(data, cur, eps);
+				if (curNeighbors.size() >= static_cast<size_t>(minPts)) {
+					seedSet.insert(seedSet.end(), curNeighbors.begin(), curNeighbors.end());
+				}
+			}
+			// 如果该点尚未分配簇，则分配到当前簇
+			if (labels[cur] == -1) {
+				labels[cur] = clusterId;
+			}
+		}
+	}
+
+	/**
+	 * @brief DBSCAN 密度聚类算法
+	 * @param data   数据集 n×m 矩阵
+	 * @param eps    邻域半径
+	 * @param minPts 构成核心点的最小邻域数
+	 * @return 每个样本的簇标签向量，-1 表示噪声，其余 0,1,2... 为簇 ID
+	 */
+	inline std::vector<int> dbscan(
+		const std::vector<std::vector<double>>& data,
+		double eps,
+		int minPts
+	) {
+		size_t n = data.size();
+		std::vector<int> labels(n, -1);
+		std::vector<bool> visited(n, false);
+		int clusterId = 0;
+
+		for (size_t i = 0; i < n; ++i) {
+			if (visited[i]) continue;
+			visited[i] = true;
+			std::vector<size_t> neighbors = regionQuery(data, i, eps);
+			// 如果邻居数不足，则标记为噪声
+			if (neighbors.size() < static_cast<size_t>(minPts)) {
+				labels[i] = -1;
+			}
+			else {
+				// 扩展新簇
+				expandCluster(data, labels, visited, i, clusterId, eps, minPts);
+				++clusterId;
+			}
+		}
+
+		return labels;
+	}
+
+	/**
+	 * @brief 使用 K-means++ 算法初始化质心
+	 * @param data   输入数据，大小 n×m (n 个样本，每个样本 m 维)
+	 * @param k      聚类簇数
+	 * @return 返回初始化好的 k 个质心，每个质心为 m 维向量
+	 * @throws std::invalid_argument 如果 data 为空或 k<=0 或 k>n
+	 */
+	inline std::vector<std::vector<double>> initializeCentroidsPP(
+		const std::vector<std::vector<double>>& data,
+		int k
+	) {
+		size_t n = data.size();
+		if (n == 0 || k <= 0 || static_cast<size_t>(k) > n)
+		{
+			throw std::invalid_argument("initializeCentroidsPP: 参数非法");
+		}
+		size_t m = data[0].size();
+		std::vector<std::vector<double>> centroids;
+		centroids.reserve(k);
+
+		// 随机数生成器
+		std::random_device rd;
+		std::mt19937 gen(rd());
+
+		// 随机选择
+		std::uniform_int_distribution<size_t> unif(0, n - 1);
+		centroids.push_back(data[unif(gen)]);
+
+		std::vector<double> dist2(n);
+		for (int c = 1; c < k; ++c)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				double dmin = std::numeric_limits<double>::infinity();
+				for (const auto& cent : centroids)
+				{
+					double d = euclideanDistance(data[i], cent);
+					dmin = std::min(dmin, d);
+				}
+				dist2[i] = dmin * dmin;
+			}
+			// 用距离平方作为权重
+			std::discrete_distribution<size_t> dist(dist2.begin(), dist2.end());
+			centroids.push_back(data[dist(gen)]);
+		}
+
+		return centroids;
+	}
+
+	/**
+	 * @brief 基于 K-means++ 初始化并执行 K-means 聚类
+	 * @param data     输入数据，大小 n×m
+	 * @param k        聚类簇数
+	 * @param max_iter 最大迭代次数，默认 1000
+	 * @return labels  长度 n，每个元素为样本所属簇 ID [0..k-1]
+	 * @throws std::invalid_argument 如果 data 为空或 k<=0
+	 */
+	inline std::vector<int> kMeansPP(
+		const std::vector<std::vector<double>>& data,
+		int k,
+		int max_iter = 1000
+	) {
+		size_t n = data.size();
+		if (n == 0 || k <= 0)
+		{
+			throw std::invalid_argument("kMeansPP: 参数非法");
+		}
+		size_t m = data[0].size();
+
+		std::vector<std::vector<double>> centroids = initializeCentroidsPP(data, k);
+		std::vector<int> labels(n, -1);
+		std::vector<int> counts(k, 0);
+
+		for (int iter = 0; iter < max_iter; ++iter)
+		{
+			bool changed = false;
+
+			// 分配每个点到最近质心
+			for (size_t i = 0; i < n; ++i)
+			{
+				double dmin = std::numeric_limits<double>::infinity();
+				int best = -1;
+				for (int c = 0; c < k; ++c)
+				{
+					double d = euclideanDistance(data[i], centroids[c]);
+					if (d < dmin)
+					{
+						dmin = d;
+						best = c;
+					}
+				}
+				if (labels[i] != best)
+				{
+					labels[i] = best;
+					changed = true;
+				}
+			}
+
+			// 如果没有变化则终止
+			if (!changed)
+			{
+				break;
+			}
+
+			std::vector<std::vector<double>> sum(k, std::vector<double>(m, 0.0));
+			std::fill(counts.begin(), counts.end(), 0);
+
+			// 累加各簇样本
+			for (size_t i = 0; i < n; ++i)
+			{
+				int c = labels[i];
+				for (size_t j = 0; j < m; ++j)
+				{
+					sum[c][j] += data[i][j];
+				}
+				++counts[c];
+			}
+
+			// 更新质心
+			for (int c = 0; c < k; ++c)
+			{
+				if (counts[c] > 0) {
+					for (size_t j = 0; j < m; ++j)
+					{
+						centroids[c][j] = sum[c][j] / counts[c];
+					}
+				}
+				else
+				{
+					// 若某簇无样本，可随机重置一个质心
+					std::random_device rd;
+					std::mt19937 gen(rd());
+					std::uniform_int_distribution<size_t> unif(0, n - 1);
+					centroids[c] = data[unif(gen)];
+				}
+			}
+		}
+
+		return labels;
+	}
+}
+
+#endif